@@ -0,0 +1,320 @@
+#include "dataset_generator.h"
+#include "core/schema_migrations.h"
+#include "core/logger.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <sstream>
+#include <string_view>
+
+static const char* const kWords[] = {
+    "call", "email", "review", "draft", "plan", "budget", "meeting", "client", "report",
+    "invoice", "follow", "up", "with", "the", "team", "about", "quarterly", "update",
+    "fix", "garden", "book", "flights", "renew", "insurance", "prepare", "slides",
+    "check", "contract", "order", "supplies", "schedule", "dentist", "read", "notes",
+};
+static const size_t kWordCount = sizeof(kWords) / sizeof(kWords[0]);
+
+static const char* const kLookupTables[] = { "Projects", "Contexts", "Topics", "People", "Categories" };
+
+// === ZipfSampler ===
+
+ZipfSampler::ZipfSampler(int n, double s) {
+    cumulative_.resize(std::max(n, 1));
+    double sum = 0.0;
+    for (size_t k = 0; k < cumulative_.size(); ++k) {
+        sum += 1.0 / std::pow(static_cast<double>(k + 1), s);
+        cumulative_[k] = sum;
+    }
+    for (double& c : cumulative_) c /= sum;
+}
+
+int ZipfSampler::operator()(std::mt19937_64& rng) {
+    double u = std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+    auto it = std::lower_bound(cumulative_.begin(), cumulative_.end(), u);
+    return static_cast<int>(std::min<size_t>(it - cumulative_.begin(), cumulative_.size() - 1));
+}
+
+// === DatasetGenerator ===
+
+DatasetGenerator::DatasetGenerator(const DatasetOptions& options)
+    : options_(options)
+    , rng_(options.seed)
+    , projectSampler_(options.projectCount, options.projectSkew)
+    , contextSampler_(options.contextCount, options.contextSkew)
+{
+    projectUuids_.reserve(options_.projectCount);
+    for (int i = 0; i < options_.projectCount; ++i) projectUuids_.push_back(randomUuid());
+}
+
+std::string DatasetGenerator::lookupName(const char* table, int index) const {
+    std::string name = std::string(table) + " ";
+    name += kWords[(index * 7) % kWordCount];
+    name += " " + std::to_string(index + 1);
+    return name;
+}
+
+std::string DatasetGenerator::randomUuid() {
+    uint64_t hi = rng_();
+    uint64_t lo = rng_();
+    hi = (hi & 0xFFFFFFFFFFFF0FFFull) | 0x0000000000004000ull;   // version 4
+    lo = (lo & 0x3FFFFFFFFFFFFFFFull) | 0x8000000000000000ull;   // RFC 4122 variant
+
+    char buf[37];
+    std::snprintf(buf, sizeof(buf), "%08x-%04x-%04x-%04x-%012llx",
+        static_cast<unsigned>(hi >> 32), static_cast<unsigned>((hi >> 16) & 0xFFFF),
+        static_cast<unsigned>(hi & 0xFFFF), static_cast<unsigned>(lo >> 48),
+        static_cast<unsigned long long>(lo & 0xFFFFFFFFFFFFull));
+    return buf;
+}
+
+std::string DatasetGenerator::randomTimestamp(int dayOffsetMin, int dayOffsetMax) {
+    // Days relative to 2025-01-01, kept inside a 28-day month for simplicity
+    int day = std::uniform_int_distribution<int>(dayOffsetMin, dayOffsetMax)(rng_) + 400;
+    int year = 2024 + day / 336;
+    int month = 1 + (day % 336) / 28;
+    int dom = 1 + day % 28;
+    int seconds = std::uniform_int_distribution<int>(0, 86399)(rng_);
+
+    char buf[20];
+    std::snprintf(buf, sizeof(buf), "%04d-%02d-%02d %02d:%02d:%02d",
+        year, month, dom, seconds / 3600, (seconds / 60) % 60, seconds % 60);
+    return buf;
+}
+
+std::string DatasetGenerator::randomText(size_t length) {
+    std::string text;
+    text.reserve(length + 12);
+    while (text.size() < length) {
+        if (!text.empty()) text += ' ';
+        text += kWords[rng_() % kWordCount];
+    }
+    text.resize(length);
+    return text;
+}
+
+Task DatasetGenerator::nextTask() {
+    auto chance = [&](double p) { return std::bernoulli_distribution(p)(rng_); };
+    auto pick = [&](int count) { return std::uniform_int_distribution<int>(1, std::max(count, 1))(rng_); };
+
+    Task t;
+    t.uuid = randomUuid();
+    t.title = randomText(12 + rng_() % 60);
+
+    if (!chance(options_.emptyNotesShare)) {
+        std::lognormal_distribution<double> notesLength(std::log(std::max(options_.notesMedianLength, 1)), options_.notesSigma);
+        t.notes = randomText(std::min<size_t>(static_cast<size_t>(notesLength(rng_)), options_.notesMaxLength));
+    }
+
+    t.category_id = pick(options_.categoryCount);
+    t.context_id = contextSampler_(rng_) + 1;
+    t.topic_id = chance(0.6) ? std::optional<int>{ pick(options_.topicCount) } : std::nullopt;
+    t.delegated_to = chance(0.15) ? std::optional<int>{ pick(options_.personCount) } : std::nullopt;
+    if (!projectUuids_.empty() && !chance(options_.projectlessShare)) {
+        t.project_uuid = projectUuids_[projectSampler_(rng_)];
+    }
+    t.time_required_minutes = chance(0.7) ? std::optional<int>{ 5 * pick(24) } : std::nullopt;
+
+    t.created_at = randomTimestamp(-400, 0);
+    t.updated_at = randomTimestamp(0, 30);
+    t.in_focus = chance(options_.focusShare);
+    t.is_done = chance(options_.doneShare);
+    if (t.is_done) t.completed_at = randomTimestamp(0, 30);
+    if (chance(options_.dueShare)) t.due_date = randomTimestamp(-30, 90);
+    if (chance(options_.deferShare)) t.defer_date = randomTimestamp(-10, 60);
+    t.is_locked = chance(0.02);
+
+    if (!recentTaskUuids_.empty() && chance(options_.linkedShare)) {
+        t.link_from = recentTaskUuids_[rng_() % recentTaskUuids_.size()];
+    }
+    if (recentTaskUuids_.size() < 256) recentTaskUuids_.emplace_back(t.uuid);
+    else recentTaskUuids_[rng_() % recentTaskUuids_.size()] = t.uuid;
+
+    return t;
+}
+
+// === SQLite ===
+
+static bool execSQLite(sqlite3* conn, const char* sql) {
+    if (sqlite3_exec(conn, sql, nullptr, nullptr, nullptr) != SQLITE_OK) {
+        LOG_ERROR("Dataset SQLite statement failed: {}", sqlite3_errmsg(conn));
+        return false;
+    }
+    return true;
+}
+
+bool generateSQLiteDataset(sqlite3* conn, const DatasetOptions& options) {
+    if (!migrateSchema(conn)) return false;
+
+    DatasetGenerator gen(options);
+    const int lookupCounts[] = { options.projectCount, options.contextCount, options.topicCount,
+                                 options.personCount, options.categoryCount };
+
+    if (!execSQLite(conn, "BEGIN")) return false;
+    execSQLite(conn, "DELETE FROM Tasks");
+
+    for (int t = 0; t < 5; ++t) {
+        const char* table = kLookupTables[t];
+        execSQLite(conn, ("DELETE FROM " + std::string(table)).c_str());
+
+        std::string sql = std::string("INSERT INTO ") + table + (t == 0 ? " (uuid, name)" : " (id, name)") + " VALUES (?, ?)";
+        sqlite3_stmt* stmt = nullptr;
+        if (sqlite3_prepare_v2(conn, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) return false;
+
+        for (int i = 0; i < lookupCounts[t]; ++i) {
+            std::string name = gen.lookupName(table, i);
+            if (t == 0) sqlite3_bind_text(stmt, 1, gen.projectUuids()[i].c_str(), -1, SQLITE_TRANSIENT);
+            else sqlite3_bind_int(stmt, 1, i + 1);
+            sqlite3_bind_text(stmt, 2, name.c_str(), -1, SQLITE_TRANSIENT);
+            sqlite3_step(stmt);
+            sqlite3_reset(stmt);
+        }
+        sqlite3_finalize(stmt);
+    }
+
+    const char* insertTask = R"(
+        INSERT INTO Tasks (
+            uuid, title, notes, category_id, context_id, project_uuid, topic_id, delegated_to,
+            time_required_minutes, in_focus, due_date, defer_date, created_at, updated_at,
+            is_done, completed_at, link_from, link_to, is_locked
+        ) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?))";
+
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(conn, insertTask, -1, &stmt, nullptr) != SQLITE_OK) {
+        LOG_ERROR("Dataset prepare failed: {}", sqlite3_errmsg(conn));
+        return false;
+    }
+
+    auto bindOptInt = [&](int idx, const std::optional<int>& v) {
+        if (v) sqlite3_bind_int(stmt, idx, *v); else sqlite3_bind_null(stmt, idx);
+    };
+    auto bindOptStr = [&](int idx, const std::optional<TaskString>& v) {
+        if (v) sqlite3_bind_text(stmt, idx, v->c_str(), -1, SQLITE_TRANSIENT); else sqlite3_bind_null(stmt, idx);
+    };
+
+    const int kBatch = 20000;
+    for (int n = 0; n < options.taskCount; ++n) {
+        Task t = gen.nextTask();
+        int i = 1;
+        sqlite3_bind_text(stmt, i++, t.uuid.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(stmt, i++, t.title.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(stmt, i++, t.notes.c_str(), -1, SQLITE_TRANSIENT);
+        bindOptInt(i++, t.category_id);
+        bindOptInt(i++, t.context_id);
+        bindOptStr(i++, t.project_uuid);
+        bindOptInt(i++, t.topic_id);
+        bindOptInt(i++, t.delegated_to);
+        bindOptInt(i++, t.time_required_minutes);
+        sqlite3_bind_int(stmt, i++, t.in_focus ? 1 : 0);
+        bindOptStr(i++, t.due_date);
+        bindOptStr(i++, t.defer_date);
+        bindOptStr(i++, t.created_at);
+        bindOptStr(i++, t.updated_at);
+        sqlite3_bind_int(stmt, i++, t.is_done ? 1 : 0);
+        bindOptStr(i++, t.completed_at);
+        bindOptStr(i++, t.link_from);
+        bindOptStr(i++, t.link_to);
+        sqlite3_bind_int(stmt, i++, t.is_locked ? 1 : 0);
+
+        if (sqlite3_step(stmt) != SQLITE_DONE) {
+            LOG_ERROR("Dataset insert failed: {}", sqlite3_errmsg(conn));
+            sqlite3_finalize(stmt);
+            execSQLite(conn, "ROLLBACK");
+            return false;
+        }
+        sqlite3_reset(stmt);
+
+        if ((n + 1) % kBatch == 0) {
+            execSQLite(conn, "COMMIT");
+            execSQLite(conn, "BEGIN");
+        }
+    }
+
+    sqlite3_finalize(stmt);
+    return execSQLite(conn, "COMMIT");
+}
+
+// === MySQL ===
+
+static std::string quoteMySQL(MYSQL* conn, std::string_view value) {
+    std::string out(value.size() * 2 + 1, '\0');
+    unsigned long len = mysql_real_escape_string(conn, &out[0], value.data(), static_cast<unsigned long>(value.size()));
+    out.resize(len);
+    return "'" + out + "'";
+}
+
+static bool execMySQL(MYSQL* conn, const std::string& sql) {
+    if (mysql_query(conn, sql.c_str()) != 0) {
+        LOG_ERROR("Dataset MySQL statement failed: {}", mysql_error(conn));
+        return false;
+    }
+    return true;
+}
+
+bool generateMySQLDataset(MYSQL* conn, const DatasetOptions& options) {
+    if (!migrateSchema(conn)) return false;
+
+    DatasetGenerator gen(options);
+    const int lookupCounts[] = { options.projectCount, options.contextCount, options.topicCount,
+                                 options.personCount, options.categoryCount };
+
+    if (!execMySQL(conn, "TRUNCATE TABLE Tasks")) return false;
+
+    for (int t = 0; t < 5; ++t) {
+        const char* table = kLookupTables[t];
+        if (!execMySQL(conn, std::string("TRUNCATE TABLE ") + table)) return false;
+
+        std::ostringstream sql;
+        sql << "INSERT INTO " << table << (t == 0 ? " (uuid, name)" : " (id, name)") << " VALUES ";
+        for (int i = 0; i < lookupCounts[t]; ++i) {
+            if (i) sql << ", ";
+            sql << "(" << (t == 0 ? quoteMySQL(conn, gen.projectUuids()[i]) : std::to_string(i + 1))
+                << ", " << quoteMySQL(conn, gen.lookupName(table, i)) << ")";
+        }
+        if (lookupCounts[t] > 0 && !execMySQL(conn, sql.str())) return false;
+    }
+
+    auto optInt = [](const std::optional<int>& v) { return v ? std::to_string(*v) : std::string("NULL"); };
+    auto optStr = [&](const std::optional<TaskString>& v) { return v ? quoteMySQL(conn, *v) : std::string("NULL"); };
+
+    // Multi-row INSERTs inside one transaction per batch
+    const int kRowsPerInsert = 500;
+    std::ostringstream sql;
+    int rowsInStatement = 0;
+
+    execMySQL(conn, "START TRANSACTION");
+    for (int n = 0; n < options.taskCount; ++n) {
+        Task t = gen.nextTask();
+        if (rowsInStatement == 0) {
+            sql.str("");
+            sql << "INSERT INTO Tasks (uuid, title, notes, category_id, context_id, project_uuid, topic_id, "
+                   "delegated_to, time_required_minutes, in_focus, due_date, defer_date, created_at, updated_at, "
+                   "is_done, completed_at, link_from, link_to, is_locked) VALUES ";
+        }
+        else {
+            sql << ", ";
+        }
+
+        sql << "(" << quoteMySQL(conn, t.uuid) << ", " << quoteMySQL(conn, t.title) << ", " << quoteMySQL(conn, t.notes)
+            << ", " << optInt(t.category_id) << ", " << optInt(t.context_id) << ", " << optStr(t.project_uuid)
+            << ", " << optInt(t.topic_id) << ", " << optInt(t.delegated_to) << ", " << optInt(t.time_required_minutes)
+            << ", " << (t.in_focus ? 1 : 0) << ", " << optStr(t.due_date) << ", " << optStr(t.defer_date)
+            << ", " << optStr(t.created_at) << ", " << optStr(t.updated_at) << ", " << (t.is_done ? 1 : 0)
+            << ", " << optStr(t.completed_at) << ", " << optStr(t.link_from) << ", " << optStr(t.link_to)
+            << ", " << (t.is_locked ? 1 : 0) << ")";
+
+        if (++rowsInStatement == kRowsPerInsert || n + 1 == options.taskCount) {
+            if (!execMySQL(conn, sql.str())) {
+                execMySQL(conn, "ROLLBACK");
+                return false;
+            }
+            rowsInStatement = 0;
+            if ((n + 1) % (kRowsPerInsert * 40) == 0) {
+                execMySQL(conn, "COMMIT");
+                execMySQL(conn, "START TRANSACTION");
+            }
+        }
+    }
+    return execMySQL(conn, "COMMIT");
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "core/task.h"
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+#include <mysql.h>
+#include <sqlite3.h>
+
+// Shape of a synthetic dataset. The same seed and options always produce the
+// same rows, so runs on different machines or backends are comparable.
+struct DatasetOptions {
+    uint64_t seed = 42;
+    int taskCount = 1000;
+
+    int projectCount = 200;
+    int contextCount = 12;
+    int topicCount = 40;
+    int personCount = 60;
+    int categoryCount = 8;
+
+    // Zipf exponents for how tasks spread over projects / contexts (0 = uniform)
+    double projectSkew = 1.1;
+    double contextSkew = 0.8;
+    double projectlessShare = 0.25;
+
+    // Notes length is log-normal around notesMedianLength; some tasks have none
+    int notesMedianLength = 180;
+    double notesSigma = 1.2;
+    int notesMaxLength = 64 * 1024;
+    double emptyNotesShare = 0.3;
+
+    double doneShare = 0.35;
+    double focusShare = 0.08;
+    double dueShare = 0.3;
+    double deferShare = 0.15;
+    double linkedShare = 0.1;
+};
+
+// Draws ranks 0..n-1 with P(k) proportional to 1 / (k+1)^s
+class ZipfSampler {
+public:
+    ZipfSampler(int n, double s);
+    int operator()(std::mt19937_64& rng);
+
+private:
+    std::vector<double> cumulative_;
+};
+
+class DatasetGenerator {
+public:
+    explicit DatasetGenerator(const DatasetOptions& options);
+
+    const DatasetOptions& options() const { return options_; }
+    const std::vector<std::string>& projectUuids() const { return projectUuids_; }
+    std::string lookupName(const char* table, int index) const;
+
+    // Next task in the sequence; call taskCount times
+    Task nextTask();
+
+private:
+    std::string randomUuid();
+    std::string randomTimestamp(int dayOffsetMin, int dayOffsetMax);
+    std::string randomText(size_t length);
+
+    DatasetOptions options_;
+    std::mt19937_64 rng_;
+    ZipfSampler projectSampler_;
+    ZipfSampler contextSampler_;
+    std::vector<std::string> projectUuids_;
+    std::vector<std::string> recentTaskUuids_;
+};
+
+// Create (or replace) Tasks and the lookup tables and fill them.
+// The MySQL variant empties the tables first: point it at a scratch database.
+bool generateSQLiteDataset(sqlite3* conn, const DatasetOptions& options);
+bool generateMySQLDataset(MYSQL* conn, const DatasetOptions& options);
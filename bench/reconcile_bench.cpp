@@ -0,0 +1,346 @@
+// Merkle-range reconciliation benchmark.
+//
+// Usage: reconcile_bench [--rows=500000] [--diff=0.01] [--seed=42] [--leaf-rows=16]
+//                        [--lazy-notes] [--work-dir=.] [--out=results.json]
+//                        [--mysql=host:port:user:password:database]
+//
+// A seeded dataset is generated into one SQLite file and copied to a second,
+// then a --diff share of the tasks drifts apart: edited on one side or on
+// both (the later updated_at wins), deleted from one side, or archived on one
+// side. reconcileTaskStores brings the copies back together; the bytes it
+// sent and received are reported next to the bytes of a full-table copy. A
+// second pass must find nothing left to do. --lazy-notes opens both sides as
+// lazy_notes databases, so the notes of copied rows are fetched separately.
+// --mysql puts the second copy in that MySQL database instead (its Tasks,
+// TasksArchive and lookup tables are replaced) and reconciles it as db_a, the
+// side queried from the worker thread, so the MySQL path runs off the main
+// thread. Results are written as JSON.
+
+#include "dataset_generator.h"
+#include "core/database_registry.h"
+#include "core/metrics.h"
+#include "core/sqlite_tuning.h"
+#include "core/task_archive.h"
+#include "core/task_reconcile.h"
+#include "core/task_schema.h"
+#include "core/logger.h"
+
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using json = nlohmann::json;
+
+static void registerDatabases(const std::vector<DatabaseConnection>& connections) {
+    allDatabases = connections;
+    tableToDatabaseIds.clear();
+    tableToDatabaseIds["Tasks"] = { 0, 1 };
+    for (const char* table : { "Projects", "Contexts", "Topics", "People", "Categories" }) {
+        tableToDatabaseIds[table] = { 0 };
+    }
+}
+
+static bool copyDatabase(sqlite3* from, sqlite3* to) {
+    sqlite3_backup* backup = sqlite3_backup_init(to, "main", from, "main");
+    if (!backup) return false;
+    sqlite3_backup_step(backup, -1);
+    return sqlite3_backup_finish(backup) == SQLITE_OK;
+}
+
+static std::vector<std::string> allUuids(sqlite3* conn) {
+    std::vector<std::string> uuids;
+    sqlite3_stmt* stmt = nullptr;
+    sqlite3_prepare_v2(conn, "SELECT uuid FROM Tasks ORDER BY uuid", -1, &stmt, nullptr);
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        uuids.emplace_back(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0)));
+    }
+    sqlite3_finalize(stmt);
+    return uuids;
+}
+
+static bool execForUuid(sqlite3* conn, const char* sql, const std::string& uuid) {
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(conn, sql, -1, &stmt, nullptr) != SQLITE_OK) return false;
+    sqlite3_bind_text(stmt, 1, uuid.c_str(), -1, SQLITE_TRANSIENT);
+    bool ok = sqlite3_step(stmt) == SQLITE_DONE;
+    sqlite3_finalize(stmt);
+    return ok;
+}
+
+// ?1 in `sql` becomes the quoted uuid
+static bool execForUuid(MYSQL* conn, const char* sql, const std::string& uuid) {
+    std::string quoted(uuid.size() * 2 + 1, '\0');
+    quoted.resize(mysql_real_escape_string(conn, &quoted[0], uuid.c_str(), static_cast<unsigned long>(uuid.size())));
+    std::string text = sql;
+    text.replace(text.find("?1"), 2, "'" + quoted + "'");
+    return mysql_query(conn, text.c_str()) == 0;
+}
+
+static bool execMySQL(MYSQL* conn, const char* sql) {
+    if (mysql_query(conn, sql) == 0) return true;
+    std::cerr << "MySQL: " << mysql_error(conn) << "\n";
+    return false;
+}
+
+// The second copy: a SQLite file or a MySQL database
+struct SideB {
+    sqlite3* sqlite = nullptr;
+    MYSQL* mysql = nullptr;
+
+    bool exec(const char* sql) {
+        return mysql ? mysql_query(mysql, sql) == 0 : sqlite3_exec(sqlite, sql, nullptr, nullptr, nullptr) == SQLITE_OK;
+    }
+    bool execForUuid(const char* sqliteSql, const char* mysqlSql, const std::string& uuid) {
+        return mysql ? ::execForUuid(mysql, mysqlSql, uuid) : ::execForUuid(sqlite, sqliteSql, uuid);
+    }
+};
+
+// Spreads the drift over every kind of difference, one kind per task in turn
+static json applyDrift(sqlite3* a, SideB& b, std::vector<std::string> uuids, size_t count, uint64_t seed) {
+    const char* editOnce = "UPDATE Tasks SET title = title || ' (edited)', updated_at = datetime(updated_at, '+1 day') WHERE uuid = ?1";
+    const char* editTwice = "UPDATE Tasks SET title = title || ' (edited again)', updated_at = datetime(updated_at, '+2 day') WHERE uuid = ?1";
+    const char* remove = "DELETE FROM Tasks WHERE uuid = ?1";
+    const char* editOnceMySQL = "UPDATE Tasks SET title = CONCAT(title, ' (edited)'), updated_at = updated_at + INTERVAL 1 DAY WHERE uuid = ?1";
+    const char* editTwiceMySQL = "UPDATE Tasks SET title = CONCAT(title, ' (edited again)'), updated_at = updated_at + INTERVAL 2 DAY WHERE uuid = ?1";
+
+    std::mt19937_64 rng(seed);
+    std::shuffle(uuids.begin(), uuids.end(), rng);
+    count = std::min(count, uuids.size());
+
+    size_t kinds[6] = {};
+    sqlite3_exec(a, "BEGIN", nullptr, nullptr, nullptr);
+    b.exec(b.mysql ? "START TRANSACTION" : "BEGIN");
+    std::vector<std::string> archiveOnB;
+    for (size_t i = 0; i < count; ++i) {
+        const std::string& uuid = uuids[i];
+        switch (i % 6) {
+        case 0: execForUuid(a, editOnce, uuid); break;
+        case 1: b.execForUuid(editOnce, editOnceMySQL, uuid); break;
+        case 2: execForUuid(a, editOnce, uuid); b.execForUuid(editTwice, editTwiceMySQL, uuid); break;
+        case 3: b.execForUuid(remove, remove, uuid); break;
+        case 4: execForUuid(a, remove, uuid); break;
+        case 5: archiveOnB.push_back(uuid); break;
+        }
+        ++kinds[i % 6];
+    }
+    sqlite3_exec(a, "COMMIT", nullptr, nullptr, nullptr);
+    b.exec("COMMIT");
+    for (const std::string& uuid : archiveOnB) archiveTask(1, uuid);
+
+    return {
+        { "tasks", count },
+        { "edited_on_a", kinds[0] },
+        { "edited_on_b", kinds[1] },
+        { "edited_on_both", kinds[2] },
+        { "deleted_on_b", kinds[3] },
+        { "deleted_on_a", kinds[4] },
+        { "archived_on_b", kinds[5] },
+    };
+}
+
+// Value bytes of every row in both tiers, as a full copy would move them
+static uint64_t tableBytes(sqlite3* conn) {
+    std::string sum;
+    for (const char* column : kTaskColumns) {
+        sum += (sum.empty() ? "" : " + ") + std::string("COALESCE(LENGTH(") + column + "), 0)";
+    }
+    const std::string sql = "SELECT (SELECT COALESCE(SUM(" + sum + "), 0) FROM Tasks) + "
+        "(SELECT COALESCE(SUM(" + sum + "), 0) FROM TasksArchive)";
+
+    uint64_t bytes = 0;
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(conn, sql.c_str(), -1, &stmt, nullptr) == SQLITE_OK && sqlite3_step(stmt) == SQLITE_ROW) {
+        bytes = static_cast<uint64_t>(sqlite3_column_int64(stmt, 0));
+    }
+    sqlite3_finalize(stmt);
+    return bytes;
+}
+
+static uint64_t rowCount(sqlite3* conn, const char* table) {
+    uint64_t rows = 0;
+    sqlite3_stmt* stmt = nullptr;
+    const std::string sql = std::string("SELECT COUNT(*) FROM ") + table;
+    if (sqlite3_prepare_v2(conn, sql.c_str(), -1, &stmt, nullptr) == SQLITE_OK && sqlite3_step(stmt) == SQLITE_ROW) {
+        rows = static_cast<uint64_t>(sqlite3_column_int64(stmt, 0));
+    }
+    sqlite3_finalize(stmt);
+    return rows;
+}
+
+static uint64_t rowCount(MYSQL* conn, const char* table) {
+    uint64_t rows = 0;
+    const std::string sql = std::string("SELECT COUNT(*) FROM ") + table;
+    if (mysql_query(conn, sql.c_str()) != 0) return 0;
+    if (MYSQL_RES* result = mysql_store_result(conn)) {
+        if (MYSQL_ROW row = mysql_fetch_row(result)) rows = row[0] ? std::stoull(row[0]) : 0;
+        mysql_free_result(result);
+    }
+    return rows;
+}
+
+// host:port:user:password:database, as storage_bench takes it
+static bool parseMySQLSpec(const std::string& spec, ConnectionParams& params) {
+    std::vector<std::string> parts;
+    std::stringstream ss(spec);
+    std::string item;
+    while (std::getline(ss, item, ':')) parts.push_back(item);
+    if (parts.size() != 5) return false;
+    params.host = parts[0];
+    params.port = std::stoi(parts[1]);
+    params.user = parts[2];
+    params.password = parts[3];
+    params.database = parts[4];
+    return true;
+}
+
+static json summarize(const ReconcileStats& s, bool ok) {
+    return {
+        { "ok", ok },
+        { "bytes_sent", s.bytesSent },
+        { "bytes_received", s.bytesReceived },
+        { "queries", s.queries },
+        { "levels", s.levels },
+        { "ranges_compared", s.rangesCompared },
+        { "ranges_differing", s.rangesDiffering },
+        { "rows_listed", s.rowsListed },
+        { "rows_differing", s.rowsDiffering },
+        { "copied_to_a", s.copiedToA },
+        { "copied_to_b", s.copiedToB },
+        { "failed", s.failed },
+        { "seconds", s.seconds },
+    };
+}
+
+int main(int argc, char** argv) {
+    DatasetOptions options;
+    options.taskCount = 500000;
+    double diffShare = 0.01;
+    ReconcileOptions reconcileOptions;
+    bool lazyNotes = false;
+    std::string workDir = ".";
+    std::string outPath;
+    ConnectionParams mysqlParams;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto eq = arg.find('=');
+        std::string key = arg.substr(0, eq);
+        std::string value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+
+        if (key == "--rows") options.taskCount = std::stoi(value);
+        else if (key == "--diff") diffShare = std::stod(value);
+        else if (key == "--seed") options.seed = std::stoull(value);
+        else if (key == "--leaf-rows") reconcileOptions.leafRows = std::stoul(value);
+        else if (key == "--lazy-notes") lazyNotes = true;
+        else if (key == "--work-dir") workDir = value;
+        else if (key == "--out") outPath = value;
+        else if (key == "--mysql") {
+            if (!parseMySQLSpec(value, mysqlParams)) {
+                std::cerr << "--mysql expects host:port:user:password:database\n";
+                return 1;
+            }
+        }
+        else {
+            std::cerr << "Unknown option: " << arg << "\n";
+            return 1;
+        }
+    }
+
+    Log::setLevel(LogLevel::Warn);
+    Log::start();
+
+    const std::string pathA = workDir + "/reconcile_bench_a.db";
+    const std::string pathB = workDir + "/reconcile_bench_b.db";
+    std::remove(pathA.c_str());
+    std::remove(pathB.c_str());
+
+    const bool useMySQL = !mysqlParams.database.empty();
+    SQLiteTuning tuning = sqliteTuningForProfile("balanced");
+    sqlite3* a = openTunedSQLite(pathA, tuning, false);
+    SideB b;
+    if (useMySQL) b.mysql = openMySQLConnection(mysqlParams);
+    else b.sqlite = openTunedSQLite(pathB, tuning, false);
+    // Same seed, same rows; the MySQL archive is emptied as on the SQLite side
+    uint64_t genStart = metricsNowNs();
+    const bool generated = a && (b.sqlite || b.mysql) && generateSQLiteDataset(a, options) &&
+        (useMySQL ? generateMySQLDataset(b.mysql, options) && execMySQL(b.mysql, "DELETE FROM TasksArchive")
+                  : copyDatabase(a, b.sqlite));
+    if (!generated) {
+        std::cerr << "Could not set up the two databases\n";
+        Log::stop();
+        return 1;
+    }
+    double genSeconds = (metricsNowNs() - genStart) / 1e9;
+
+    DatabaseConnection sideA{ DatabaseType::SQLITE, a };
+    sideA.sqliteReader = openTunedSQLite(pathA, tuning, true);
+    sideA.lazyNotes = lazyNotes;
+    DatabaseConnection sideB{ DatabaseType::SQLITE, b.sqlite };
+    if (useMySQL) {
+        sideB = DatabaseConnection{ DatabaseType::MYSQL, b.mysql };
+        sideB.params = mysqlParams;
+    }
+    else {
+        sideB.sqliteReader = openTunedSQLite(pathB, tuning, true);
+    }
+    sideB.lazyNotes = lazyNotes;
+    registerDatabases({ sideA, sideB });
+
+    const uint64_t fullTableBytes = tableBytes(a);
+    const size_t diffCount = static_cast<size_t>(options.taskCount * diffShare);
+    json drift = applyDrift(a, b, allUuids(a), diffCount, options.seed);
+
+    const int dbA = useMySQL ? 1 : 0;
+    ReconcileStats first;
+    bool firstOk = reconcileTaskStores(dbA, 1 - dbA, reconcileOptions, &first);
+    ReconcileStats second;
+    bool secondOk = reconcileTaskStores(dbA, 1 - dbA, reconcileOptions, &second);
+
+    const uint64_t transferred = first.bytesSent + first.bytesReceived;
+    json report = {
+        { "seed", options.seed },
+        { "rows", options.taskCount },
+        { "diff_share", diffShare },
+        { "leaf_rows", reconcileOptions.leafRows },
+        { "lazy_notes", lazyNotes },
+        { "side_b", useMySQL ? "mysql" : "sqlite" },
+        { "reconciled_as_db_a", useMySQL ? "b" : "a" },
+        { "generate_seconds", genSeconds },
+        { "drift", drift },
+        { "full_table_bytes", fullTableBytes },
+        { "reconcile", summarize(first, firstOk) },
+        { "transferred_bytes", transferred },
+        { "transferred_share", fullTableBytes ? static_cast<double>(transferred) / fullTableBytes : 0.0 },
+        { "second_pass", summarize(second, secondOk) },
+        { "rows_after", {
+            { "a_tasks", rowCount(a, "Tasks") }, { "a_archive", rowCount(a, "TasksArchive") },
+            { "b_tasks", b.mysql ? rowCount(b.mysql, "Tasks") : rowCount(b.sqlite, "Tasks") },
+            { "b_archive", b.mysql ? rowCount(b.mysql, "TasksArchive") : rowCount(b.sqlite, "TasksArchive") },
+        } },
+    };
+
+    allDatabases.clear();
+    sqlite3_close(sideA.sqliteReader);
+    sqlite3_close(sideB.sqliteReader);
+    sqlite3_close(a);
+    if (b.mysql) mysql_close(b.mysql);
+    sqlite3_close(b.sqlite);
+    std::remove(pathA.c_str());
+    std::remove(pathB.c_str());
+    Log::stop();
+
+    if (outPath.empty()) {
+        std::cout << report.dump(2) << std::endl;
+    }
+    else {
+        std::ofstream out(outPath);
+        out << report.dump(2) << std::endl;
+    }
+    return firstOk && secondOk && second.rowsDiffering == 0 ? 0 : 1;
+}
@@ -0,0 +1,105 @@
+// Save and load throughput of each SQLite tuning profile.
+//
+// Usage: sqlite_profile_bench [task_count] [work_dir]
+// Writes one JSON object per profile to stdout.
+
+#include "core/database.h"
+#include "core/database_registry.h"
+#include "core/schema_migrations.h"
+#include "core/sqlite_tuning.h"
+
+#include <nlohmann/json.hpp>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using json = nlohmann::json;
+using Clock = std::chrono::steady_clock;
+
+static Task makeBenchTask(int n) {
+    char uuid[40];
+    std::snprintf(uuid, sizeof(uuid), "00000000-0000-4000-8000-%012d", n);
+
+    Task t;
+    t.uuid = uuid;
+    t.title = "Benchmark task " + std::to_string(n);
+    t.notes = std::string(200, 'x');
+    t.context_id = n % 8;
+    t.category_id = n % 5;
+    t.in_focus = (n % 10) == 0;
+    t.created_at = "2024-01-01 09:00:00";
+    return t;
+}
+
+static void removeDatabaseFiles(const std::string& path) {
+    std::remove(path.c_str());
+    std::remove((path + "-wal").c_str());
+    std::remove((path + "-shm").c_str());
+}
+
+static json runProfile(const std::string& profile, int taskCount, const std::string& workDir) {
+    const std::string path = workDir + "/bench_" + profile + ".db";
+    removeDatabaseFiles(path);
+
+    SQLiteTuning tuning = sqliteTuningForProfile(profile);
+    sqlite3* writer = openTunedSQLite(path, tuning, false);
+    if (!writer || !migrateSchema(writer)) {
+        return { { "profile", profile }, { "error", "could not create database" } };
+    }
+
+    DatabaseConnection conn;
+    conn.type = DatabaseType::SQLITE;
+    conn.connection = writer;
+    if (tuning.readOnlyConnection) conn.sqliteReader = openTunedSQLite(path, tuning, true);
+
+    allDatabases.clear();
+    allDatabases.push_back(conn);
+
+    std::vector<Task> tasks;
+    tasks.reserve(taskCount);
+    for (int i = 0; i < taskCount; ++i) tasks.push_back(makeBenchTask(i));
+
+    auto saveStart = Clock::now();
+    for (Task& t : tasks) saveTaskToDatabase(t);
+    double saveSeconds = std::chrono::duration<double>(Clock::now() - saveStart).count();
+
+    const int loadRounds = 5;
+    size_t loaded = 0;
+    auto loadStart = Clock::now();
+    for (int round = 0; round < loadRounds; ++round) {
+        loaded += fetchTasksFromSQLite(sqliteReadConnection(conn), 0).size();
+    }
+    double loadSeconds = std::chrono::duration<double>(Clock::now() - loadStart).count();
+
+    sqlite3_close(conn.sqliteReader);
+    sqlite3_close(writer);
+    allDatabases.clear();
+    removeDatabaseFiles(path);
+
+    return {
+        { "profile", profile },
+        { "tasks", taskCount },
+        { "save_seconds", saveSeconds },
+        { "saves_per_second", saveSeconds > 0 ? taskCount / saveSeconds : 0.0 },
+        { "load_seconds", loadSeconds / loadRounds },
+        { "rows_loaded_per_second", loadSeconds > 0 ? loaded / loadSeconds : 0.0 },
+        { "reader_connection", tuning.readOnlyConnection },
+    };
+}
+
+int main(int argc, char** argv) {
+    int taskCount = argc > 1 ? std::stoi(argv[1]) : 2000;
+    std::string workDir = argc > 2 ? argv[2] : ".";
+
+    // The storage code logs every save; keep console cost out of the timing
+    // and stdout free of anything but results
+    std::ostream results(std::cout.rdbuf());
+    std::cout.rdbuf(nullptr);
+
+    for (const char* profile : { "default", "balanced", "fast" }) {
+        results << runProfile(profile, taskCount, workDir).dump() << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,442 @@
+// Storage benchmark suite over synthetic datasets.
+//
+// Usage: storage_bench [--sizes=1000,10000,100000,1000000] [--seed=42]
+//                      [--project-skew=1.1] [--context-skew=0.8] [--notes-median=180]
+//                      [--work-dir=.] [--out=results.json]
+//                      [--mysql=host:port:user:password:database]
+//
+// For each size a seeded dataset is generated into a SQLite file (and into the
+// MySQL database when --mysql is given; its tables are replaced, so use a
+// scratch database). Then populateLookupMaps, fetchTasksFrom*, saveTaskToDatabase
+// and moveTaskToDatabase are timed, and a fetch into the heap is compared with a
+// fetch into a TaskGeneration arena (load, free, allocation counts). Filtered
+// fetches (open tasks, then widening to all) show what pushdown saves. Results
+// are written as JSON.
+//
+// Peak RSS only ever grows within a process, so with more than one size each
+// size runs in a child process of its own and peak_rss_bytes is that size's.
+
+#include "dataset_generator.h"
+#include "core/database.h"
+#include "core/database_registry.h"
+#include "core/lookup_maps.h"
+#include "core/metrics.h"
+#include "core/schema_migrations.h"
+#include "core/sqlite_tuning.h"
+#include "core/task_generation.h"
+#include "core/task_query.h"
+#include "core/logger.h"
+
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+using json = nlohmann::json;
+
+static uint64_t peakRssBytes() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS pmc{};
+    GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc));
+    return static_cast<uint64_t>(pmc.PeakWorkingSetSize);
+#else
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return static_cast<uint64_t>(usage.ru_maxrss) * 1024;   // kilobytes on Linux
+#endif
+}
+
+static json summarize(const LatencyHistogram& h, double totalSeconds, size_t items) {
+    auto ms = [](uint64_t ns) { return ns / 1e6; };
+    return {
+        { "count", h.count() },
+        { "items", items },
+        { "total_seconds", totalSeconds },
+        { "items_per_second", totalSeconds > 0 ? items / totalSeconds : 0.0 },
+        { "p50_ms", ms(h.percentileNs(50)) },
+        { "p90_ms", ms(h.percentileNs(90)) },
+        { "p99_ms", ms(h.percentileNs(99)) },
+        { "max_ms", ms(h.maxNs()) },
+    };
+}
+
+static void registerDatabases(const std::vector<DatabaseConnection>& connections) {
+    allDatabases = connections;
+    tableToDatabaseIds.clear();
+    for (const char* table : { "Projects", "Contexts", "Topics", "People", "Categories" }) {
+        tableToDatabaseIds[table] = { 0 };
+    }
+}
+
+// Runs the timed operations against allDatabases[0]; allDatabases[1] receives moves
+static json runSuite(const DatasetOptions& options, const char* backend) {
+    json result = { { "backend", backend }, { "rows", options.taskCount } };
+    const DatabaseConnection& source = allDatabases[0];
+
+    // --- populateLookupMaps ---
+    {
+        LatencyHistogram h;
+        uint64_t start = metricsNowNs();
+        // Each round builds and publishes a fresh snapshot
+        for (int round = 0; round < 5; ++round) {
+            ScopedLatency timer(h);
+            populateLookupMaps();
+        }
+        result["populateLookupMaps"] = summarize(h, (metricsNowNs() - start) / 1e9, 5);
+    }
+
+    // --- fetch ---
+    std::vector<Task> tasks;
+    {
+        LatencyHistogram h;
+        size_t rows = 0;
+        uint64_t start = metricsNowNs();
+        for (int round = 0; round < 3; ++round) {
+            ScopedLatency timer(h);
+            tasks = (source.type == DatabaseType::MYSQL)
+                ? fetchTasksFromMySQL(std::get<MYSQL*>(source.connection), 0)
+                : fetchTasksFromSQLite(sqliteReadConnection(source), 0);
+            rows += tasks.size();
+        }
+        result[source.type == DatabaseType::MYSQL ? "fetchTasksFromMySQL" : "fetchTasksFromSQLite"] =
+            summarize(h, (metricsNowNs() - start) / 1e9, rows);
+    }
+
+    // --- load and free: one heap allocation per string vs one arena per generation ---
+    // Both sides fetch the same rows and request the same strings; what differs
+    // is how many of those requests reach the heap. Times are medians of 5 rounds.
+    {
+        constexpr int kRounds = 5;
+        auto fetch = [&](std::pmr::memory_resource* resource) {
+            return (source.type == DatabaseType::MYSQL)
+                ? fetchTasksFromMySQL(std::get<MYSQL*>(source.connection), 0, resource)
+                : fetchTasksFromSQLite(sqliteReadConnection(source), 0, resource);
+        };
+        auto median = [](std::vector<double> values) {
+            std::sort(values.begin(), values.end());
+            return values[values.size() / 2];
+        };
+
+        std::vector<double> heapLoad, heapFree, arenaLoad, arenaFree;
+        AllocatorStats heapStats;
+        AllocatorStats arenaRequests;
+        AllocatorStats arenaBlocks;     // read after the generation is gone, so its frees are in
+        for (int round = 0; round < kRounds; ++round) {
+            CountingResource heap(std::pmr::new_delete_resource());
+            uint64_t start = metricsNowNs();
+            std::vector<Task> heapTasks = fetch(&heap);
+            uint64_t loaded = metricsNowNs();
+            heapTasks = std::vector<Task>();
+            heapLoad.push_back((loaded - start) / 1e9);
+            heapFree.push_back((metricsNowNs() - loaded) / 1e9);
+            heapStats = heap.stats();
+
+            CountingResource blocks(std::pmr::new_delete_resource());
+            auto generation = std::make_unique<TaskGeneration>(TaskGeneration::kInitialArenaBytes, &blocks);
+            start = metricsNowNs();
+            generation->tasks() = fetch(generation->resource());
+            loaded = metricsNowNs();
+            arenaRequests = generation->arenaStats();
+            generation.reset();
+            arenaLoad.push_back((loaded - start) / 1e9);
+            arenaFree.push_back((metricsNowNs() - loaded) / 1e9);
+            arenaBlocks = blocks.stats();
+        }
+
+        json heapResult = {
+            { "string_allocations", heapStats.allocations },
+            { "heap_allocations", heapStats.allocations },
+            { "heap_frees", heapStats.deallocations },
+            { "heap_bytes", heapStats.bytesAllocated },
+            { "load_seconds", median(heapLoad) },
+            { "free_seconds", median(heapFree) },
+        };
+        json arenaResult = {
+            { "string_allocations", arenaRequests.allocations },
+            { "heap_allocations", arenaBlocks.allocations },
+            { "heap_frees", arenaBlocks.deallocations },
+            { "heap_bytes", arenaBlocks.bytesAllocated },
+            { "load_seconds", median(arenaLoad) },
+            { "free_seconds", median(arenaFree) },
+        };
+
+        // A session on top of one load: open and edit a spread of cards the way
+        // CardView does. The arena must not grow; the edits live on the heap.
+        auto generation = std::make_unique<TaskGeneration>();
+        generation->tasks() = fetch(generation->resource());
+        const AllocatorStats before = generation->heapStats();
+        std::vector<Task>& loadedTasks = generation->tasks();
+        const size_t edits = std::min<size_t>(loadedTasks.size(), 1000);
+        const size_t stride = edits ? std::max<size_t>(loadedTasks.size() / edits, 1) : 1;
+        for (size_t i = 0; i < edits; ++i) {
+            Task& t = loadedTasks[i * stride];
+            moveTaskToHeap(t);
+            t.notes.append(" and a longer note typed in the card");
+            t.title += " (edited)";
+        }
+        json session = {
+            { "edited_tasks", edits },
+            { "arena_heap_bytes_before", before.bytesAllocated },
+            { "arena_heap_bytes_after", generation->heapStats().bytesAllocated },
+        };
+
+        result["taskGeneration"] = { { "heap", heapResult }, { "arena", arenaResult }, { "session", session } };
+    }
+
+    // --- filter pushdown: rows and time per filter, and widening open -> all ---
+    {
+        auto timedFetch = [&](const TaskQuery& query) {
+            uint64_t start = metricsNowNs();
+            size_t rows = (source.type == DatabaseType::MYSQL)
+                ? fetchTasksFromMySQL(std::get<MYSQL*>(source.connection), 0, std::pmr::get_default_resource(), query).size()
+                : fetchTasksFromSQLite(sqliteReadConnection(source), 0, std::pmr::get_default_resource(), query).size();
+            return json{ { "rows", rows }, { "seconds", (metricsNowNs() - start) / 1e9 } };
+        };
+
+        TaskFilterCriteria all;
+        TaskFilterCriteria open;
+        open.is_done = false;
+        TaskFilterCriteria openInFocus = open;
+        openInFocus.in_focus = true;
+
+        result["filterPushdown"] = {
+            { "all", timedFetch(compileTaskFilter(all)) },
+            { "open", timedFetch(compileTaskFilter(open)) },
+            { "open_in_focus", timedFetch(compileTaskFilter(openInFocus)) },
+            { "widen_open_to_all", timedFetch(compileTaskFilter(all, { open })) },
+        };
+    }
+
+    // --- save: edit a spread of tasks one at a time, like the UI does ---
+    {
+        LatencyHistogram h;
+        size_t saves = std::min<size_t>(tasks.size(), 1000);
+        size_t stride = saves ? std::max<size_t>(tasks.size() / saves, 1) : 1;
+        uint64_t start = metricsNowNs();
+        for (size_t i = 0; i < saves; ++i) {
+            Task& t = tasks[i * stride];
+            t.title += " (edited)";
+            ScopedLatency timer(h);
+            saveTaskToDatabase(t);
+        }
+        result["saveTaskToDatabase"] = summarize(h, (metricsNowNs() - start) / 1e9, saves);
+    }
+
+    // --- move to the scratch database and back ---
+    {
+        LatencyHistogram h;
+        size_t moves = std::min<size_t>(tasks.size(), 250);
+        uint64_t start = metricsNowNs();
+        for (size_t i = 0; i < moves; ++i) {
+            Task& t = tasks[tasks.size() - 1 - i];
+            ScopedLatency timer(h);
+            t.db_id = 1;
+            moveTaskToDatabase(t, 0);
+            t.db_id = 0;
+            moveTaskToDatabase(t, 1);
+        }
+        result["moveTaskToDatabase"] = summarize(h, (metricsNowNs() - start) / 1e9, moves * 2);
+    }
+
+    result["peak_rss_bytes"] = peakRssBytes();
+    return result;
+}
+
+static std::vector<int> parseSizes(const std::string& list) {
+    std::vector<int> sizes;
+    std::stringstream ss(list);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (!item.empty()) sizes.push_back(std::stoi(item));
+    }
+    return sizes;
+}
+
+static std::string shellQuote(const std::string& arg) {
+#ifdef _WIN32
+    const std::string special = "\"";         // backslashes are path separators here
+#else
+    const std::string special = "\"\\$`";
+#endif
+    std::string quoted = "\"";
+    for (char c : arg) {
+        if (special.find(c) != std::string::npos) quoted += '\\';
+        quoted += c;
+    }
+    return quoted + "\"";
+}
+
+static void writeReport(const json& report, const std::string& outPath) {
+    if (outPath.empty()) {
+        std::cout << report.dump(2) << std::endl;
+    }
+    else {
+        std::ofstream out(outPath);
+        out << report.dump(2) << std::endl;
+    }
+}
+
+// Runs `self --sizes=<size>` once per size with the other options passed on,
+// and collects the children's results
+static bool runSizesInChildren(const std::string& self, const std::vector<std::string>& passthrough,
+                               const std::vector<int>& sizes, const std::string& workDir, json& report) {
+    for (int size : sizes) {
+        const std::string childOut = workDir + "/storage_bench_" + std::to_string(size) + ".json";
+        std::string command = shellQuote(self) + " --sizes=" + std::to_string(size) + " --out=" + shellQuote(childOut);
+        for (const std::string& arg : passthrough) command += " " + shellQuote(arg);
+#ifdef _WIN32
+        command = "\"" + command + "\"";     // cmd /c strips one pair of outer quotes
+#endif
+
+        if (std::system(command.c_str()) != 0) {
+            LOG_ERROR("Benchmark run for {} tasks failed", size);
+            return false;
+        }
+        std::ifstream in(childOut);
+        json child = json::parse(in, nullptr, false);
+        in.close();
+        std::remove(childOut.c_str());
+        if (child.is_discarded() || !child.contains("results")) {
+            LOG_ERROR("Benchmark run for {} tasks wrote no results", size);
+            return false;
+        }
+        for (json& result : child["results"]) report["results"].push_back(std::move(result));
+    }
+    return true;
+}
+
+static MYSQL* connectMySQL(const std::string& spec) {
+    std::vector<std::string> parts;
+    std::stringstream ss(spec);
+    std::string item;
+    while (std::getline(ss, item, ':')) parts.push_back(item);
+    if (parts.size() != 5) {
+        LOG_ERROR("--mysql expects host:port:user:password:database");
+        return nullptr;
+    }
+
+    MYSQL* mysql = mysql_init(nullptr);
+    if (mysql && !mysql_real_connect(mysql, parts[0].c_str(), parts[2].c_str(), parts[3].c_str(),
+            parts[4].c_str(), std::stoi(parts[1]), nullptr, 0)) {
+        LOG_ERROR("MySQL benchmark connection failed: {}", mysql_error(mysql));
+        mysql_close(mysql);
+        return nullptr;
+    }
+    return mysql;
+}
+
+int main(int argc, char** argv) {
+    DatasetOptions base;
+    std::vector<int> sizes = { 1000, 10000, 100000, 1000000 };
+    std::string workDir = ".";
+    std::string outPath;
+    std::string mysqlSpec;
+    std::vector<std::string> passthrough;   // everything but --sizes and --out, for child runs
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto eq = arg.find('=');
+        std::string key = arg.substr(0, eq);
+        std::string value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+        if (key != "--sizes" && key != "--out") passthrough.push_back(arg);
+
+        if (key == "--sizes") sizes = parseSizes(value);
+        else if (key == "--seed") base.seed = std::stoull(value);
+        else if (key == "--project-skew") base.projectSkew = std::stod(value);
+        else if (key == "--context-skew") base.contextSkew = std::stod(value);
+        else if (key == "--notes-median") base.notesMedianLength = std::stoi(value);
+        else if (key == "--work-dir") workDir = value;
+        else if (key == "--out") outPath = value;
+        else if (key == "--mysql") mysqlSpec = value;
+        else {
+            std::cerr << "Unknown option: " << arg << "\n";
+            return 1;
+        }
+    }
+
+    Log::setLevel(LogLevel::Warn);
+    Log::start();
+
+    json report = {
+        { "seed", base.seed },
+        { "project_skew", base.projectSkew },
+        { "context_skew", base.contextSkew },
+        { "notes_median", base.notesMedianLength },
+        { "results", json::array() },
+    };
+
+    if (sizes.size() > 1) {
+        const bool ok = runSizesInChildren(argv[0], passthrough, sizes, workDir, report);
+        Log::stop();
+        if (!ok) return 1;
+        writeReport(report, outPath);
+        return 0;
+    }
+
+    MYSQL* mysql = mysqlSpec.empty() ? nullptr : connectMySQL(mysqlSpec);
+    SQLiteTuning tuning = sqliteTuningForProfile("balanced");
+
+    for (int size : sizes) {
+        DatasetOptions options = base;
+        options.taskCount = size;
+
+        std::string path = workDir + "/storage_bench_" + std::to_string(size) + ".db";
+        std::string scratchPath = workDir + "/storage_bench_scratch.db";
+        std::remove(path.c_str());
+        std::remove(scratchPath.c_str());
+
+        sqlite3* db = openTunedSQLite(path, tuning, false);
+        sqlite3* scratch = openTunedSQLite(scratchPath, tuning, false);
+        if (!db || !scratch || !migrateSchema(scratch)) return 1;
+
+        uint64_t genStart = metricsNowNs();
+        if (!generateSQLiteDataset(db, options)) return 1;
+        double genSeconds = (metricsNowNs() - genStart) / 1e9;
+
+        DatabaseConnection primary{ DatabaseType::SQLITE, db };
+        primary.sqliteReader = openTunedSQLite(path, tuning, true);
+        DatabaseConnection secondary{ DatabaseType::SQLITE, scratch };
+
+        registerDatabases({ primary, secondary });
+        json sqliteResult = runSuite(options, "sqlite");
+        sqliteResult["generate_seconds"] = genSeconds;
+        report["results"].push_back(sqliteResult);
+
+        if (mysql) {
+            genStart = metricsNowNs();
+            if (generateMySQLDataset(mysql, options)) {
+                genSeconds = (metricsNowNs() - genStart) / 1e9;
+                registerDatabases({ DatabaseConnection{ DatabaseType::MYSQL, mysql }, secondary });
+                json mysqlResult = runSuite(options, "mysql");
+                mysqlResult["generate_seconds"] = genSeconds;
+                report["results"].push_back(mysqlResult);
+            }
+        }
+
+        allDatabases.clear();
+        sqlite3_close(primary.sqliteReader);
+        sqlite3_close(db);
+        sqlite3_close(scratch);
+        std::remove(path.c_str());
+        std::remove(scratchPath.c_str());
+    }
+
+    if (mysql) mysql_close(mysql);
+    Log::stop();
+
+    writeReport(report, outPath);
+    return 0;
+}
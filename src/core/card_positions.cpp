@@ -0,0 +1,81 @@
+#include "core/card_positions.h"
+#include "core/database_registry.h"
+#include "core/logger.h"
+
+#include <sqlite3.h>
+
+int cardPositionsDatabaseId() {
+    auto mapped = tableToDatabaseIds.find("CardPositions");
+    if (mapped != tableToDatabaseIds.end()) {
+        for (int db_id : mapped->second) {
+            if (db_id >= 0 && db_id < static_cast<int>(allDatabases.size()) &&
+                allDatabases[db_id].type == DatabaseType::SQLITE) {
+                return db_id;
+            }
+            LOG_WARN("CardPositions mapped to DB ID {}, which is not a SQLite database; ignoring.", db_id);
+        }
+    }
+
+    for (size_t db_id = 0; db_id < allDatabases.size(); ++db_id) {
+        if (allDatabases[db_id].type == DatabaseType::SQLITE) return static_cast<int>(db_id);
+    }
+    return -1;
+}
+
+std::unordered_map<Uuid, CardPosition> loadCardPositions() {
+    std::unordered_map<Uuid, CardPosition> positions;
+
+    int db_id = cardPositionsDatabaseId();
+    if (db_id < 0) return positions;
+
+    sqlite3* conn = sqliteReadConnection(allDatabases[db_id]);
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(conn, "SELECT task_uuid, x, y FROM CardPositions", -1, &stmt, nullptr) != SQLITE_OK) {
+        LOG_ERROR("Failed to load card positions: {}", sqlite3_errmsg(conn));
+        return positions;
+    }
+
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        const unsigned char* uuid = sqlite3_column_text(stmt, 0);
+        if (!uuid) continue;
+        std::string_view text(reinterpret_cast<const char*>(uuid), sqlite3_column_bytes(stmt, 0));
+        positions[Uuid::fromText(text)] = {
+            static_cast<float>(sqlite3_column_double(stmt, 1)),
+            static_cast<float>(sqlite3_column_double(stmt, 2)),
+        };
+    }
+    sqlite3_finalize(stmt);
+
+    LOG_INFO("Loaded {} card positions from DB ID {}", static_cast<int>(positions.size()), db_id);
+    return positions;
+}
+
+bool saveCardPosition(std::string_view task_uuid, const CardPosition& position) {
+    int db_id = cardPositionsDatabaseId();
+    if (db_id < 0) {
+        LOG_WARN("No SQLite database configured; card position for {} not saved.", task_uuid);
+        return false;
+    }
+
+    sqlite3* conn = std::get<sqlite3*>(allDatabases[db_id].connection);
+    const char* sql =
+        "INSERT INTO CardPositions (task_uuid, x, y, updated_at) VALUES (?, ?, ?, datetime('now', 'localtime')) "
+        "ON CONFLICT(task_uuid) DO UPDATE SET x = excluded.x, y = excluded.y, updated_at = excluded.updated_at";
+
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(conn, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+        LOG_ERROR("Failed to prepare card position save: {}", sqlite3_errmsg(conn));
+        return false;
+    }
+
+    sqlite3_bind_text(stmt, 1, task_uuid.data(), static_cast<int>(task_uuid.size()), SQLITE_TRANSIENT);
+    sqlite3_bind_double(stmt, 2, position.x);
+    sqlite3_bind_double(stmt, 3, position.y);
+
+    bool ok = sqlite3_step(stmt) == SQLITE_DONE;
+    if (!ok) {
+        LOG_ERROR("Failed to save card position for {}: {}", task_uuid, sqlite3_errmsg(conn));
+    }
+    sqlite3_finalize(stmt);
+    return ok;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "core/uuid.h"
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// Free-form board position of a card, in canvas units at zoom 1
+struct CardPosition {
+    float x = 0.0f;
+    float y = 0.0f;
+};
+
+// Positions are per-machine layout state, so they live in one local SQLite
+// database: the first DB listed for "CardPositions" in the table mappings,
+// otherwise the first SQLite entry in allDatabases. Returns -1 if there is none.
+int cardPositionsDatabaseId();
+
+// All saved positions keyed by parsed task uuid
+std::unordered_map<Uuid, CardPosition> loadCardPositions();
+
+bool saveCardPosition(std::string_view task_uuid, const CardPosition& position);
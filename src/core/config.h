@@ -1,11 +1,40 @@
-#pragma once
-#include <string>
-
-namespace AppConfig {
-    // Database paths (can now be deprecated if you're using JSON config)
-    //inline const std::string kSharedDatabasePath = "Y:/gtd-app/db/gtd_shared.db";
-
-    // Config file locations
-    inline const std::string kDatabaseConfigPath = "Y:/gtd-app/config/database_config.json";
-    inline const std::string kTableMappingPath = "Y:/gtd-app/config/table_map.json";
+#pragma once
+#include <chrono>
+#include <string>
+#include "logger.h"
+
+namespace AppConfig {
+    // Database paths (can now be deprecated if you're using JSON config)
+    //inline const std::string kSharedDatabasePath = "Y:/gtd-app/db/gtd_shared.db";
+
+    // Config file locations
+    inline const std::string kDatabaseConfigPath = "Y:/gtd-app/config/database_config.json";
+    inline const std::string kTableMappingPath = "Y:/gtd-app/config/table_map.json";
+
+    // Log output: empty path logs to the console
+    inline const std::string kLogFilePath = "";
+    inline constexpr LogLevel kLogLevel = LogLevel::Info;
+
+    // How often lookup tables (projects, contexts, ...) are re-read in the background
+    inline constexpr std::chrono::seconds kLookupRefreshInterval{ 60 };
+
+    // Time the quick-find search may spend per frame; a search that needs more
+    // continues on the next frames with partial results shown
+    inline constexpr std::chrono::microseconds kQuickFindBudget{ 4000 };
+
+    // Start the canvas on the "Not done" filter, so only open tasks are fetched
+    // at startup and done ones only once a filter asks for them (the dashboard
+    // counts the done ones in the databases meanwhile)
+    inline constexpr bool kStartWithOpenTasks = true;
+
+    // Tasks done for longer than this move to TasksArchive at startup (0 = never),
+    // this many rows per transaction
+    inline constexpr int kArchiveAfterDays = 90;
+    inline constexpr size_t kArchiveBatchSize = 500;
+
+    // Memory budget for notes loaded on demand from lazy_notes databases
+    inline constexpr size_t kNotesCacheBytes = 16 * 1024 * 1024;
+
+    // Chrome trace output, written at exit when built with GTD_ENABLE_TRACING
+    inline const std::string kTraceOutputPath = "Y:/gtd-app/logs/gtd_trace.json";
 }
\ No newline at end of file
@@ -1,406 +1,734 @@
-﻿#include "database.h"
-#include "task.h"
-#include "core/database_registry.h"
-#include "core/lookup_maps.h"
-
-#include <mysql.h>
-#include <sqlite3.h>
-#include <vector>
-#include <optional>
-#include <iostream>
-#include <sstream>
-#include <variant>
-#include <iomanip>
-
-
-
-std::vector<Task> fetchTasksFromMySQL(MYSQL* conn, int db_id) {
-    std::vector<Task> tasks;
-
-    const char* query = R"(SELECT uuid, title, notes, category_id, context_id, 
-        project_uuid, topic_id, delegated_to, time_required_minutes, 
-        in_focus, due_date, defer_date, created_at, updated_at, 
-        is_done, completed_at, link_from, link_to, is_locked 
-        FROM Tasks)";
-
-    if (mysql_query(conn, query) != 0) {
-        std::cerr << "Query failed: " << mysql_error(conn) << "\n";
-        return tasks;
-    }
-
-    MYSQL_RES* res = mysql_store_result(conn);
-    if (!res) {
-        std::cerr << "Result storage failed: " << mysql_error(conn) << "\n";
-        return tasks;
-    }
-
-    MYSQL_ROW row;
-    while ((row = mysql_fetch_row(res))) {
-        Task t;
-        int i = 0;
-
-        t.uuid = row[i++] ? row[i - 1] : "";
-        t.title = row[i++] ? row[i - 1] : "";
-        t.notes = row[i++] ? row[i - 1] : "";
-
-        t.category_id = row[i] ? std::optional<int>{ std::stoi(row[i]) } : std::nullopt;
-        t.category_label = (t.category_id && categoryLookup.count(*t.category_id))
-            ? std::optional<std::string>{ categoryLookup[*t.category_id] } : std::nullopt;
-        ++i;
-
-        t.context_id = row[i] ? std::optional<int>{ std::stoi(row[i]) } : std::nullopt;
-        t.context_label = (t.context_id && contextLookup.count(*t.context_id))
-            ? std::optional<std::string>{ contextLookup[*t.context_id] } : std::nullopt;
-        ++i;
-
-        t.project_uuid = row[i] ? std::optional<std::string>{ row[i] } : std::nullopt;
-        t.project_title = (t.project_uuid && projectLookup.count(*t.project_uuid))
-            ? std::optional<std::string>{ projectLookup[*t.project_uuid] } : std::nullopt;
-        ++i;
-
-        t.topic_id = row[i] ? std::optional<int>{ std::stoi(row[i]) } : std::nullopt;
-        t.topic_label = (t.topic_id && topicLookup.count(*t.topic_id))
-            ? std::optional<std::string>{ topicLookup[*t.topic_id] } : std::nullopt;
-        ++i;
-
-        t.delegated_to = row[i] ? std::optional<int>{ std::stoi(row[i]) } : std::nullopt;
-        t.delegate_name = (t.delegated_to && personLookup.count(*t.delegated_to))
-            ? std::optional<std::string>{ personLookup[*t.delegated_to] } : std::nullopt;
-        ++i;
-
-        t.time_required_minutes = row[i++] ? std::optional<int>{ std::stoi(row[i - 1]) } : std::nullopt;
-        t.in_focus = row[i++] ? std::stoi(row[i - 1]) != 0 : false;
-        t.due_date = row[i++] ? std::optional<std::string>{ row[i - 1] } : std::nullopt;
-        t.defer_date = row[i++] ? std::optional<std::string>{ row[i - 1] } : std::nullopt;
-        t.created_at = row[i++] ? std::optional<std::string>{ row[i - 1] } : std::nullopt;
-        t.updated_at = row[i++] ? std::optional<std::string>{ row[i - 1] } : std::nullopt;
-        t.is_done = row[i++] ? std::stoi(row[i - 1]) != 0 : false;
-        t.completed_at = row[i++] ? std::optional<std::string>{ row[i - 1] } : std::nullopt;
-        t.link_from = row[i++] ? row[i - 1] : "";
-        t.link_to = row[i++] ? row[i - 1] : "";
-        t.is_locked = row[i++] ? std::stoi(row[i - 1]) != 0 : false;
-
-        t.db_id = db_id;
-        tasks.push_back(std::move(t));
-    }
-
-    mysql_free_result(res);
-    return tasks;
-}
-
-std::vector<Task> fetchTasksFromSQLite(sqlite3* conn, int db_id) {
-    std::vector<Task> tasks;
-
-    const char* query = R"(
-        SELECT uuid, title, notes, category_id, context_id, 
-               project_uuid, topic_id, delegated_to, time_required_minutes, 
-               in_focus, due_date, defer_date, created_at, updated_at, 
-               is_done, completed_at, link_from, link_to, is_locked 
-        FROM Tasks
-    )";
-
-    sqlite3_stmt* stmt;
-    if (sqlite3_prepare_v2(conn, query, -1, &stmt, nullptr) != SQLITE_OK) {
-        std::cerr << "SQLite prepare failed: " << sqlite3_errmsg(conn) << "\n";
-        return tasks;
-    }
-
-    while (sqlite3_step(stmt) == SQLITE_ROW) {
-        Task t;
-        int i = 0;
-
-        auto getText = [&](int col) -> std::string {
-            const unsigned char* val = sqlite3_column_text(stmt, col);
-            return val ? reinterpret_cast<const char*>(val) : "";
-            };
-
-        auto getIntOpt = [&](int col) -> std::optional<int> {
-            return sqlite3_column_type(stmt, col) != SQLITE_NULL
-                ? std::optional<int>{ sqlite3_column_int(stmt, col) }
-            : std::nullopt;
-            };
-
-        auto getBool = [&](int col) -> bool {
-            return sqlite3_column_type(stmt, col) != SQLITE_NULL
-                ? sqlite3_column_int(stmt, col) != 0
-                : false;
-            };
-
-        auto getStrOpt = [&](int col) -> std::optional<std::string> {
-            const unsigned char* val = sqlite3_column_text(stmt, col);
-            return val ? std::optional<std::string>{ reinterpret_cast<const char*>(val) } : std::nullopt;
-            };
-
-        t.uuid = getText(i++);
-        t.title = getText(i++);
-        t.notes = getText(i++);
-
-        t.category_id = getIntOpt(i++);
-        t.category_label = (t.category_id && categoryLookup.count(*t.category_id))
-            ? std::optional<std::string>{ categoryLookup[*t.category_id] } : std::nullopt;
-
-        t.context_id = getIntOpt(i++);
-        t.context_label = (t.context_id && contextLookup.count(*t.context_id))
-            ? std::optional<std::string>{ contextLookup[*t.context_id] } : std::nullopt;
-
-        t.project_uuid = getStrOpt(i++);
-        t.project_title = (t.project_uuid && projectLookup.count(*t.project_uuid))
-            ? std::optional<std::string>{ projectLookup[*t.project_uuid] } : std::nullopt;
-
-        t.topic_id = getIntOpt(i++);
-        t.topic_label = (t.topic_id && topicLookup.count(*t.topic_id))
-            ? std::optional<std::string>{ topicLookup[*t.topic_id] } : std::nullopt;
-
-        t.delegated_to = getIntOpt(i++);
-        t.delegate_name = (t.delegated_to && personLookup.count(*t.delegated_to))
-            ? std::optional<std::string>{ personLookup[*t.delegated_to] } : std::nullopt;
-
-        t.time_required_minutes = getIntOpt(i++);
-        t.in_focus = getBool(i++);
-        t.due_date = getStrOpt(i++);
-        t.defer_date = getStrOpt(i++);
-        t.created_at = getStrOpt(i++);
-        t.updated_at = getStrOpt(i++);
-        t.is_done = getBool(i++);
-        t.completed_at = getStrOpt(i++);
-        t.link_from = getText(i++);
-        t.link_to = getText(i++);
-        t.is_locked = getBool(i++);
-
-        t.db_id = db_id;
-        tasks.push_back(std::move(t));
-    }
-
-    sqlite3_finalize(stmt);
-    return tasks;
-}
-
-std::vector<Task> fetchTasksFromDatabase() {
-    std::vector<Task> allTasks;
-
-    for (size_t db_id = 0; db_id < allDatabases.size(); ++db_id) {
-        const auto& dbConn = allDatabases[db_id];
-
-        if (dbConn.type == DatabaseType::MYSQL) {
-            MYSQL* conn = std::get<MYSQL*>(dbConn.connection);
-            std::vector<Task> mysqlTasks = fetchTasksFromMySQL(conn, static_cast<int>(db_id));
-            allTasks.insert(allTasks.end(), mysqlTasks.begin(), mysqlTasks.end());
-        }
-        else if (dbConn.type == DatabaseType::SQLITE) {
-            sqlite3* conn = std::get<sqlite3*>(dbConn.connection);
-            std::vector<Task> sqliteTasks = fetchTasksFromSQLite(conn, static_cast<int>(db_id));
-            allTasks.insert(allTasks.end(), sqliteTasks.begin(), sqliteTasks.end());
-        }
-    }
-
-    return allTasks;
-}
-
-
-
-static std::string escapeString(MYSQL* conn, const std::string& input) {
-    std::string output;
-    output.resize(input.length() * 2 + 1); // worst case
-    unsigned long len = mysql_real_escape_string(conn, &output[0], input.c_str(), static_cast<unsigned long>(input.length()));
-    output.resize(len);
-    return output;
-}
-
-static void bindOptStr(sqlite3_stmt* stmt, int index, const std::optional<std::string>& val) {
-    if (val.has_value())
-        sqlite3_bind_text(stmt, index, val->c_str(), -1, SQLITE_TRANSIENT);
-    else
-        sqlite3_bind_null(stmt, index);
-}
-
-void saveTaskToDatabase(Task& task) {
-    DatabaseConnection& conn = allDatabases[task.db_id];
-
-    // Step 1: Set updated_at to current time
-    {
-        auto now = std::chrono::system_clock::now();
-        std::time_t now_c = std::chrono::system_clock::to_time_t(now);
-        std::stringstream ss;
-        ss << std::put_time(std::localtime(&now_c), "%Y-%m-%d %H:%M:%S");
-        task.updated_at = ss.str();
-    }
-
-    std::cout << " Saving task UUID: " << task.uuid
-        << " to DB ID: " << task.db_id
-        << " (" << (std::holds_alternative<MYSQL*>(conn.connection) ? "MySQL" : "SQLite")
-        << ")" << std::endl;
-
-    if (std::holds_alternative<MYSQL*>(conn.connection)) {
-        MYSQL* mysql = std::get<MYSQL*>(conn.connection);
-
-        auto escapeOptStr = [&](const std::optional<std::string>& opt) -> std::string {
-            return opt.has_value() ? ("'" + escapeString(mysql, *opt) + "'") : "NULL";
-            };
-
-        auto escapeOptInt = [&](const std::optional<int>& opt) -> std::string {
-            return opt.has_value() ? std::to_string(*opt) : "NULL";
-            };
-
-        std::stringstream query;
-        query << "REPLACE INTO Tasks ("
-            << "uuid, title, notes, category_id, context_id, "
-            << "project_uuid, topic_id, delegated_to, time_required_minutes, "
-            << "in_focus, due_date, defer_date, created_at, updated_at, "
-            << "is_done, completed_at, link_from, link_to, is_locked"
-            << ") VALUES ("
-            << "'" << escapeString(mysql, task.uuid) << "', "
-            << "'" << escapeString(mysql, task.title) << "', "
-            << "'" << escapeString(mysql, task.notes) << "', "
-            << escapeOptInt(task.category_id) << ", "
-            << escapeOptInt(task.context_id) << ", "
-            << escapeOptStr(task.project_uuid) << ", "
-            << escapeOptInt(task.topic_id) << ", "
-            << escapeOptInt(task.delegated_to) << ", "
-            << escapeOptInt(task.time_required_minutes) << ", "
-            << (task.in_focus ? "1" : "0") << ", "
-            << escapeOptStr(task.due_date) << ", "
-            << escapeOptStr(task.defer_date) << ", "
-            << escapeOptStr(task.created_at) << ", "
-            << escapeOptStr(task.updated_at) << ", "
-            << (task.is_done ? "1" : "0") << ", "
-            << escapeOptStr(task.completed_at) << ", "
-            << escapeOptStr(task.link_from) << ", "
-            << escapeOptStr(task.link_to) << ", "
-            << (task.is_locked ? "1" : "0")
-            << ")";
-
-        std::string queryStr = query.str();
-        std::cout << " MySQL full query:\n" << queryStr << std::endl;
-
-        if (mysql_query(mysql, queryStr.c_str()) != 0) {
-            std::cerr << " MySQL error in saveTaskToDatabase: " << mysql_error(mysql) << std::endl;
-        }
-        else {
-            std::cout << " MySQL save successful." << std::endl;
-        }
-    }
-    else {
-        sqlite3* sqlite = std::get<sqlite3*>(conn.connection);
-        sqlite3_stmt* stmt = nullptr;
-
-        const char* sql = R"(
-            REPLACE INTO Tasks (
-                uuid, title, notes,
-                category_id, context_id, project_uuid, topic_id, delegated_to,
-                time_required_minutes, in_focus,
-                due_date, defer_date, created_at, updated_at,
-                is_done, completed_at,
-                link_from, link_to,
-                is_locked
-            ) VALUES (
-                ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?
-            );
-        )";
-
-        std::cout << " Preparing SQLite REPLACE for UUID: " << task.uuid << std::endl;
-
-        if (sqlite3_prepare_v2(sqlite, sql, -1, &stmt, nullptr) != SQLITE_OK) {
-            std::cerr << " SQLite prepare error: " << sqlite3_errmsg(sqlite) << std::endl;
-            return;
-        }
-
-        auto bindStr = [&](int idx, const std::string& value) {
-            sqlite3_bind_text(stmt, idx, value.c_str(), -1, SQLITE_TRANSIENT);
-            };
-
-        auto bindOptStr = [&](int idx, const std::optional<std::string>& value) {
-            if (value.has_value())
-                sqlite3_bind_text(stmt, idx, value->c_str(), -1, SQLITE_TRANSIENT);
-            else
-                sqlite3_bind_null(stmt, idx);
-            };
-
-        auto bindOptInt = [&](int idx, const std::optional<int>& value) {
-            if (value.has_value())
-                sqlite3_bind_int(stmt, idx, *value);
-            else
-                sqlite3_bind_null(stmt, idx);
-            };
-
-        int i = 1;
-        bindStr(i++, task.uuid);
-        bindStr(i++, task.title);
-        bindStr(i++, task.notes);
-
-        bindOptInt(i++, task.category_id);
-        bindOptInt(i++, task.context_id);
-        bindOptStr(i++, task.project_uuid);
-        bindOptInt(i++, task.topic_id);
-        bindOptInt(i++, task.delegated_to);
-
-        bindOptInt(i++, task.time_required_minutes);
-        sqlite3_bind_int(stmt, i++, task.in_focus ? 1 : 0);
-
-        bindOptStr(i++, task.due_date);
-        bindOptStr(i++, task.defer_date);
-        bindOptStr(i++, task.created_at);
-        bindOptStr(i++, task.updated_at);
-
-        sqlite3_bind_int(stmt, i++, task.is_done ? 1 : 0);
-        bindOptStr(i++, task.completed_at);
-        bindOptStr(i++, task.link_from);
-        bindOptStr(i++, task.link_to);
-
-        sqlite3_bind_int(stmt, i++, task.is_locked ? 1 : 0);
-
-        if (sqlite3_step(stmt) != SQLITE_DONE) {
-            std::cerr << " SQLite step error: " << sqlite3_errmsg(sqlite) << std::endl;
-        }
-        else {
-            std::cout << " SQLite save successful for UUID: " << task.uuid << std::endl;
-        }
-
-        sqlite3_finalize(stmt);
-    }
-}
-
-void moveTaskToDatabase(Task& task, int old_db_id) {
-    if (old_db_id == task.db_id) {
-        std::cerr << " Tried to move task to the same database; skipping.\n";
-        return;
-    }
-
-    DatabaseConnection& oldConn = allDatabases[old_db_id];
-    DatabaseConnection& newConn = allDatabases[task.db_id];
-
-    // First, delete from old DB
-    if (std::holds_alternative<MYSQL*>(oldConn.connection)) {
-        MYSQL* conn = std::get<MYSQL*>(oldConn.connection);
-        std::string query = "DELETE FROM Tasks WHERE uuid = '" + task.uuid + "'";
-        if (mysql_query(conn, query.c_str()) != 0) {
-            std::cerr << " Failed to delete task from MySQL DB : " << mysql_error(conn) << std::endl;
-        }
-        else {
-            std::cout << " Old task deleted from MySQL DB\n";
-        }
-    }
-    else if (std::holds_alternative<sqlite3*>(oldConn.connection)) {
-        sqlite3* db = std::get<sqlite3*>(oldConn.connection);
-        sqlite3_stmt* stmt = nullptr;
-        const char* sql = "DELETE FROM Tasks WHERE uuid = ?";
-        if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) == SQLITE_OK) {
-            sqlite3_bind_text(stmt, 1, task.uuid.c_str(), -1, SQLITE_TRANSIENT);
-            if (sqlite3_step(stmt) != SQLITE_DONE) {
-                std::cerr << " Failed to delete task from SQLite DB: " << sqlite3_errmsg(db) << std::endl;
-            }
-            else {
-                std::cout << " Old task deleted from SQLite DB\n";
-            }
-            sqlite3_finalize(stmt);
-        }
-        else {
-            std::cerr << " Failed to prepare DELETE in SQLite: " << sqlite3_errmsg(db) << std::endl;
-        }
-    }
-    else {
-        std::cerr << " Unknown database type when deleting old task.\n";
-    }
-
-    // Now insert into the new DB
-    saveTaskToDatabase(task);
+﻿#include "database.h"
+#include "task.h"
+#include "core/database_registry.h"
+#include "core/lookup_maps.h"
+#include "core/schema_migrations.h"
+#include "core/task_schema.h"
+#include "core/task_archive.h"
+#include "core/trace.h"
+#include "core/metrics.h"
+#include "core/logger.h"
+
+#include <mysql.h>
+#include <sqlite3.h>
+#include <vector>
+#include <optional>
+#include <sstream>
+#include <string_view>
+#include <type_traits>
+#include <variant>
+#include <iomanip>
+
+
+
+// With lazy_notes the fetch selects NULL in place of notes, keeping column positions
+static bool lazyNotesFor(int db_id) {
+    return db_id >= 0 && db_id < static_cast<int>(allDatabases.size()) && allDatabases[db_id].lazyNotes;
+}
+
+// The Tasks (or TasksArchive) select with the query's WHERE clause appended
+static std::string selectTasksSql(bool lazyNotes, const TaskQuery& query) {
+    std::string sql;
+    if (query.archive) {
+        sql = lazyNotes
+            ? std::string(taskSql<TaskSql::SelectArchiveLazy>(), taskSqlLength<TaskSql::SelectArchiveLazy>())
+            : std::string(taskSql<TaskSql::SelectArchive>(), taskSqlLength<TaskSql::SelectArchive>());
+    }
+    else {
+        sql = lazyNotes
+            ? std::string(taskSql<TaskSql::SelectLazy>(), taskSqlLength<TaskSql::SelectLazy>())
+            : std::string(taskSql<TaskSql::Select>(), taskSqlLength<TaskSql::Select>());
+    }
+    if (!query.where.empty()) {
+        sql += " WHERE ";
+        sql += query.where;
+    }
+    return sql;
+}
+
+// --- Column binding by member type (see task_schema.h) ---
+
+// SQLite: NULL text reads as empty, NULL flags as false
+static void readSQLite(sqlite3_stmt* stmt, int col, Task&, TaskString& out) {
+    const char* text = reinterpret_cast<const char*>(sqlite3_column_text(stmt, col));
+    if (text) out.assign(text, sqlite3_column_bytes(stmt, col));
+    else out.clear();
+}
+
+static void readSQLite(sqlite3_stmt* stmt, int col, Task& t, std::optional<TaskString>& out) {
+    const char* text = reinterpret_cast<const char*>(sqlite3_column_text(stmt, col));
+    if (text) out.emplace(text, sqlite3_column_bytes(stmt, col), t.get_allocator());
+    else out.reset();
+}
+
+static void readSQLite(sqlite3_stmt* stmt, int col, Task&, std::optional<int>& out) {
+    if (sqlite3_column_type(stmt, col) != SQLITE_NULL) out = sqlite3_column_int(stmt, col);
+    else out.reset();
+}
+
+static void readSQLite(sqlite3_stmt* stmt, int col, Task&, bool& out) {
+    out = sqlite3_column_int(stmt, col) != 0;
+}
+
+// The task outlives the statement's step, so text is bound without a copy
+static void bindSQLite(sqlite3_stmt* stmt, int idx, const TaskString& value) {
+    sqlite3_bind_text(stmt, idx, value.data(), static_cast<int>(value.size()), SQLITE_STATIC);
+}
+
+static void bindSQLite(sqlite3_stmt* stmt, int idx, const std::optional<TaskString>& value) {
+    if (value) bindSQLite(stmt, idx, *value);
+    else sqlite3_bind_null(stmt, idx);
+}
+
+static void bindSQLite(sqlite3_stmt* stmt, int idx, const std::optional<int>& value) {
+    if (value) sqlite3_bind_int(stmt, idx, *value);
+    else sqlite3_bind_null(stmt, idx);
+}
+
+static void bindSQLite(sqlite3_stmt* stmt, int idx, bool value) {
+    sqlite3_bind_int(stmt, idx, value ? 1 : 0);
+}
+
+// Filter parameters outlive the statement as well
+static void bindSQLite(sqlite3_stmt* stmt, int idx, const TaskQueryParam& value) {
+    if (const int* number = std::get_if<int>(&value)) {
+        sqlite3_bind_int(stmt, idx, *number);
+        return;
+    }
+    const std::string& text = std::get<std::string>(value);
+    sqlite3_bind_text(stmt, idx, text.data(), static_cast<int>(text.size()), SQLITE_STATIC);
+}
+
+// MySQL binary protocol: integers arrive as ints, text in a per-column buffer
+// sized from the result's longest value. Buffers live for the whole fetch.
+struct MySQLSlot {
+    unsigned long length = 0;
+    bool isNull = false;
+    bool error = false;
+    int number = 0;
+    std::vector<char> text;
+};
+
+template <typename T>
+inline constexpr bool kIsTextColumn = std::is_same_v<T, TaskString> || std::is_same_v<T, std::optional<TaskString>>;
+
+static void bindMySQLResult(MYSQL_BIND& bind, MySQLSlot& slot, bool text, unsigned long maxLength) {
+    bind = MYSQL_BIND{};
+    bind.is_null = &slot.isNull;
+    bind.length = &slot.length;
+    bind.error = &slot.error;
+    if (text) {
+        slot.text.resize(maxLength + 1);
+        bind.buffer_type = MYSQL_TYPE_STRING;
+        bind.buffer = slot.text.data();
+        bind.buffer_length = static_cast<unsigned long>(slot.text.size());
+    }
+    else {
+        bind.buffer_type = MYSQL_TYPE_LONG;
+        bind.buffer = &slot.number;
+    }
+}
+
+// Text longer than its buffer (the max length was not reported) is fetched
+// again into a grown buffer; the caller rebinds before the next row.
+static std::string_view mysqlText(MYSQL_STMT* stmt, MYSQL_BIND& bind, MySQLSlot& slot, size_t col, bool& rebind) {
+    if (slot.length >= slot.text.size()) {
+        slot.text.resize(slot.length + 1);
+        bind.buffer = slot.text.data();
+        bind.buffer_length = static_cast<unsigned long>(slot.text.size());
+        mysql_stmt_fetch_column(stmt, &bind, static_cast<unsigned int>(col), 0);
+        rebind = true;
+    }
+    return std::string_view(slot.text.data(), slot.length);
+}
+
+static void readMySQL(MYSQL_STMT* stmt, MYSQL_BIND& bind, MySQLSlot& slot, size_t col, bool& rebind, Task&, TaskString& out) {
+    if (slot.isNull) out.clear();
+    else out.assign(mysqlText(stmt, bind, slot, col, rebind));
+}
+
+static void readMySQL(MYSQL_STMT* stmt, MYSQL_BIND& bind, MySQLSlot& slot, size_t col, bool& rebind, Task& t, std::optional<TaskString>& out) {
+    if (slot.isNull) out.reset();
+    else out.emplace(mysqlText(stmt, bind, slot, col, rebind), t.get_allocator());
+}
+
+static void readMySQL(MYSQL_STMT*, MYSQL_BIND&, MySQLSlot& slot, size_t, bool&, Task&, std::optional<int>& out) {
+    if (slot.isNull) out.reset();
+    else out = slot.number;
+}
+
+static void readMySQL(MYSQL_STMT*, MYSQL_BIND&, MySQLSlot& slot, size_t, bool&, Task&, bool& out) {
+    out = !slot.isNull && slot.number != 0;
+}
+
+static void bindMySQLParam(MYSQL_BIND& bind, MySQLSlot&, const TaskString& value) {
+    bind.buffer_type = MYSQL_TYPE_STRING;
+    bind.buffer = const_cast<char*>(value.data());
+    bind.buffer_length = static_cast<unsigned long>(value.size());
+}
+
+static void bindMySQLParam(MYSQL_BIND& bind, MySQLSlot& slot, const std::optional<TaskString>& value) {
+    if (value) bindMySQLParam(bind, slot, *value);
+    else bind.buffer_type = MYSQL_TYPE_NULL;
+}
+
+static void bindMySQLParam(MYSQL_BIND& bind, MySQLSlot& slot, const std::optional<int>& value) {
+    if (!value) {
+        bind.buffer_type = MYSQL_TYPE_NULL;
+        return;
+    }
+    slot.number = *value;
+    bind.buffer_type = MYSQL_TYPE_LONG;
+    bind.buffer = &slot.number;
+}
+
+static void bindMySQLParam(MYSQL_BIND& bind, MySQLSlot& slot, bool value) {
+    bindMySQLParam(bind, slot, std::optional<int>(value ? 1 : 0));
+}
+
+static void bindMySQLParam(MYSQL_BIND& bind, MySQLSlot& slot, const TaskQueryParam& value) {
+    if (const int* number = std::get_if<int>(&value)) {
+        bindMySQLParam(bind, slot, std::optional<int>(*number));
+        return;
+    }
+    const std::string& text = std::get<std::string>(value);
+    bind.buffer_type = MYSQL_TYPE_STRING;
+    bind.buffer = const_cast<char*>(text.data());
+    bind.buffer_length = static_cast<unsigned long>(text.size());
+}
+
+std::vector<Task> fetchTasksFromMySQL(MYSQL* conn, int db_id, std::pmr::memory_resource* resource, const TaskQuery& query, bool* ok) {
+    GTD_TRACE_SCOPE("fetchTasksFromMySQL");
+    if (ok) *ok = true;
+    ScopedLatency fetchTimer(databaseMetrics(db_id).fetchLatency);
+    std::vector<Task> tasks;
+    const bool lazyNotes = lazyNotesFor(db_id);
+    const std::string sql = selectTasksSql(lazyNotes, query);
+
+    MYSQL_STMT* stmt = mysql_stmt_init(conn);
+    if (!stmt) {
+        LOG_ERROR("Statement init failed: {}", mysql_error(conn));
+        if (ok) *ok = false;
+        return tasks;
+    }
+
+    // Buffer the whole result client-side (as mysql_store_result did) and
+    // have it report each column's longest value so text buffers fit.
+    bool updateMaxLength = true;
+    mysql_stmt_attr_set(stmt, STMT_ATTR_UPDATE_MAX_LENGTH, &updateMaxLength);
+
+    std::vector<MYSQL_BIND> params(query.params.size());
+    std::vector<MySQLSlot> paramSlots(query.params.size());
+    for (size_t i = 0; i < query.params.size(); ++i) {
+        bindMySQLParam(params[i], paramSlots[i], query.params[i]);
+    }
+
+    if (mysql_stmt_prepare(stmt, sql.data(), static_cast<unsigned long>(sql.size())) != 0
+        || (!params.empty() && mysql_stmt_bind_param(stmt, params.data()) != 0)
+        || mysql_stmt_execute(stmt) != 0
+        || mysql_stmt_store_result(stmt) != 0) {
+        LOG_ERROR("Query failed: {}", mysql_stmt_error(stmt));
+        mysql_stmt_close(stmt);
+        if (ok) *ok = false;
+        return tasks;
+    }
+
+    MYSQL_RES* meta = mysql_stmt_result_metadata(stmt);
+    if (!meta || mysql_num_fields(meta) != kTaskColumnCount) {
+        LOG_ERROR("Unexpected Tasks result shape: {}", mysql_stmt_error(stmt));
+        if (meta) mysql_free_result(meta);
+        mysql_stmt_close(stmt);
+        if (ok) *ok = false;
+        return tasks;
+    }
+
+    MYSQL_FIELD* fields = mysql_fetch_fields(meta);
+    MYSQL_BIND binds[kTaskColumnCount];
+    MySQLSlot slots[kTaskColumnCount];
+    forEachTaskColumn([&](const auto& column, size_t col) {
+        using Value = typename std::decay_t<decltype(column)>::Value;
+        bindMySQLResult(binds[col], slots[col], kIsTextColumn<Value>, fields[col].max_length);
+    });
+    mysql_free_result(meta);
+
+    if (mysql_stmt_bind_result(stmt, binds) != 0) {
+        LOG_ERROR("Result binding failed: {}", mysql_stmt_error(stmt));
+        mysql_stmt_close(stmt);
+        if (ok) *ok = false;
+        return tasks;
+    }
+
+    LookupReadGuard lookups;
+    tasks.reserve(mysql_stmt_num_rows(stmt));
+    int status;
+    while ((status = mysql_stmt_fetch(stmt)) == 0 || status == MYSQL_DATA_TRUNCATED) {
+        Task t(resource);
+        bool rebind = false;
+        forEachTaskColumn([&](const auto& column, size_t col) {
+            readMySQL(stmt, binds[col], slots[col], col, rebind, t, column.get(t));
+        });
+        if (rebind) mysql_stmt_bind_result(stmt, binds);
+
+        t.notes_loaded = !lazyNotes;
+        t.parseIds();
+        applyLookupLabels(t, *lookups, resource);
+        t.db_id = db_id;
+        t.archived = query.archive;
+        tasks.push_back(std::move(t));
+    }
+    if (status == 1) {
+        LOG_ERROR("Fetching Tasks rows failed: {}", mysql_stmt_error(stmt));
+        if (ok) *ok = false;
+    }
+
+    mysql_stmt_close(stmt);
+    return tasks;
+}
+
+std::vector<Task> fetchTasksFromSQLite(sqlite3* conn, int db_id, std::pmr::memory_resource* resource, const TaskQuery& query, bool* ok) {
+    GTD_TRACE_SCOPE("fetchTasksFromSQLite");
+    if (ok) *ok = true;
+    ScopedLatency fetchTimer(databaseMetrics(db_id).fetchLatency);
+    std::vector<Task> tasks;
+    const bool lazyNotes = lazyNotesFor(db_id);
+    const std::string sql = selectTasksSql(lazyNotes, query);
+
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(conn, sql.c_str(), static_cast<int>(sql.size()), &stmt, nullptr) != SQLITE_OK) {
+        LOG_ERROR("SQLite prepare failed: {}", sqlite3_errmsg(conn));
+        if (ok) *ok = false;
+        return tasks;
+    }
+    for (size_t i = 0; i < query.params.size(); ++i) {
+        bindSQLite(stmt, static_cast<int>(i + 1), query.params[i]);
+    }
+
+    LookupReadGuard lookups;
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        Task t(resource);
+        forEachTaskColumn([&](const auto& column, size_t col) {
+            readSQLite(stmt, static_cast<int>(col), t, column.get(t));
+        });
+
+        t.notes_loaded = !lazyNotes;
+        t.parseIds();
+        applyLookupLabels(t, *lookups, resource);
+        t.db_id = db_id;
+        t.archived = query.archive;
+        tasks.push_back(std::move(t));
+    }
+    if (rc != SQLITE_DONE) {
+        LOG_ERROR("Fetching Tasks rows failed: {}", sqlite3_errmsg(conn));
+        if (ok) *ok = false;
+    }
+
+    sqlite3_finalize(stmt);
+    return tasks;
+}
+
+std::optional<std::string> fetchTaskNotes(MYSQL* conn, std::string_view uuid) {
+    GTD_TRACE_SCOPE("fetchTaskNotes");
+    std::string escaped(uuid.size() * 2 + 1, '\0');
+    escaped.resize(mysql_real_escape_string(conn, &escaped[0], uuid.data(), static_cast<unsigned long>(uuid.size())));
+
+    // Archived tasks keep their notes in TasksArchive
+    std::string query = "SELECT notes FROM Tasks WHERE uuid = '" + escaped + "' "
+        "UNION ALL SELECT notes FROM TasksArchive WHERE uuid = '" + escaped + "'";
+    if (mysql_query(conn, query.c_str()) != 0) {
+        LOG_ERROR("Notes query failed for {}: {}", uuid, mysql_error(conn));
+        return std::nullopt;
+    }
+
+    MYSQL_RES* res = mysql_store_result(conn);
+    if (!res) {
+        LOG_ERROR("Notes result storage failed for {}: {}", uuid, mysql_error(conn));
+        return std::nullopt;
+    }
+
+    std::optional<std::string> notes;
+    if (MYSQL_ROW row = mysql_fetch_row(res)) {
+        unsigned long* lengths = mysql_fetch_lengths(res);
+        notes = row[0] ? std::string(row[0], lengths[0]) : std::string();
+    }
+    mysql_free_result(res);
+    return notes;
+}
+
+std::optional<std::string> fetchTaskNotes(sqlite3* conn, std::string_view uuid) {
+    GTD_TRACE_SCOPE("fetchTaskNotes");
+    sqlite3_stmt* stmt = nullptr;
+    const char* sql = "SELECT notes FROM Tasks WHERE uuid = ?1 UNION ALL SELECT notes FROM TasksArchive WHERE uuid = ?1";
+    if (sqlite3_prepare_v2(conn, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+        LOG_ERROR("SQLite prepare failed: {}", sqlite3_errmsg(conn));
+        return std::nullopt;
+    }
+    sqlite3_bind_text(stmt, 1, uuid.data(), static_cast<int>(uuid.size()), SQLITE_TRANSIENT);
+
+    std::optional<std::string> notes;
+    if (sqlite3_step(stmt) == SQLITE_ROW) {
+        const unsigned char* text = sqlite3_column_text(stmt, 0);
+        notes = text ? std::string(reinterpret_cast<const char*>(text), sqlite3_column_bytes(stmt, 0)) : std::string();
+    }
+    sqlite3_finalize(stmt);
+    return notes;
+}
+
+std::vector<Task> fetchTasksFromDatabase(std::pmr::memory_resource* resource, const TaskQuery& query, bool* ok) {
+    GTD_TRACE_SCOPE("fetchTasksFromDatabase");
+    std::vector<Task> allTasks;
+    if (ok) *ok = true;
+    bool answered = true;
+
+    for (size_t db_id = 0; db_id < allDatabases.size(); ++db_id) {
+        const auto& dbConn = allDatabases[db_id];
+
+        if (dbConn.type == DatabaseType::MYSQL) {
+            MYSQL* conn = std::get<MYSQL*>(dbConn.connection);
+            std::vector<Task> mysqlTasks = fetchTasksFromMySQL(conn, static_cast<int>(db_id), resource, query, &answered);
+            allTasks.insert(allTasks.end(), std::make_move_iterator(mysqlTasks.begin()), std::make_move_iterator(mysqlTasks.end()));
+        }
+        else if (dbConn.type == DatabaseType::SQLITE) {
+            sqlite3* conn = sqliteReadConnection(dbConn);
+            std::vector<Task> sqliteTasks = fetchTasksFromSQLite(conn, static_cast<int>(db_id), resource, query, &answered);
+            allTasks.insert(allTasks.end(), std::make_move_iterator(sqliteTasks.begin()), std::make_move_iterator(sqliteTasks.end()));
+        }
+        if (!answered && ok) *ok = false;
+    }
+
+    return allTasks;
+}
+
+// --- Done counts for the dashboard ---
+
+static std::string countDoneSql(const TaskQuery& query) {
+    std::string sql = "SELECT category_id, context_id, project_uuid, topic_id, delegated_to, COUNT(*), "
+        "SUM(CASE WHEN completed_at >= ? THEN 1 ELSE 0 END), SUM(COALESCE(time_required_minutes, 0)) FROM ";
+    sql += query.archive ? "TasksArchive" : "Tasks";
+    if (!query.where.empty()) {
+        sql += " WHERE ";
+        sql += query.where;
+    }
+    sql += " GROUP BY category_id, context_id, project_uuid, topic_id, delegated_to";
+    return sql;
+}
+
+static bool countDoneTasksInMySQL(MYSQL* conn, int db_id, const TaskQuery& query, const std::string& completedSince,
+                                  std::vector<DoneTaskGroup>& groups) {
+    const std::string sql = countDoneSql(query);
+    MYSQL_STMT* stmt = mysql_stmt_init(conn);
+    if (!stmt) {
+        LOG_ERROR("Statement init failed: {}", mysql_error(conn));
+        return false;
+    }
+    bool updateMaxLength = true;
+    mysql_stmt_attr_set(stmt, STMT_ATTR_UPDATE_MAX_LENGTH, &updateMaxLength);
+
+    // completedSince comes first in the statement
+    const TaskQueryParam since(completedSince);
+    std::vector<MYSQL_BIND> params(query.params.size() + 1);
+    std::vector<MySQLSlot> paramSlots(params.size());
+    bindMySQLParam(params[0], paramSlots[0], since);
+    for (size_t i = 0; i < query.params.size(); ++i) {
+        bindMySQLParam(params[i + 1], paramSlots[i + 1], query.params[i]);
+    }
+
+    if (mysql_stmt_prepare(stmt, sql.data(), static_cast<unsigned long>(sql.size())) != 0
+        || mysql_stmt_bind_param(stmt, params.data()) != 0
+        || mysql_stmt_execute(stmt) != 0
+        || mysql_stmt_store_result(stmt) != 0) {
+        LOG_ERROR("Done count query failed: {}", mysql_stmt_error(stmt));
+        mysql_stmt_close(stmt);
+        return false;
+    }
+
+    MYSQL_RES* meta = mysql_stmt_result_metadata(stmt);
+    if (!meta) {
+        LOG_ERROR("Done count returned no result: {}", mysql_stmt_error(stmt));
+        mysql_stmt_close(stmt);
+        return false;
+    }
+    unsigned long projectLength = mysql_fetch_fields(meta)[2].max_length;
+    mysql_free_result(meta);
+
+    // Five bucket columns, then the three sums as 64-bit integers
+    constexpr size_t kKeys = 5;
+    MYSQL_BIND binds[kKeys + 3];
+    MySQLSlot slots[kKeys];
+    for (size_t col = 0; col < kKeys; ++col) bindMySQLResult(binds[col], slots[col], col == 2, projectLength);
+    long long sums[3] = {};
+    bool sumNull[3] = {};
+    for (size_t i = 0; i < 3; ++i) {
+        MYSQL_BIND& bind = binds[kKeys + i];
+        bind = MYSQL_BIND{};
+        bind.buffer_type = MYSQL_TYPE_LONGLONG;
+        bind.buffer = &sums[i];
+        bind.is_null = &sumNull[i];
+    }
+
+    if (mysql_stmt_bind_result(stmt, binds) != 0) {
+        LOG_ERROR("Result binding failed: {}", mysql_stmt_error(stmt));
+        mysql_stmt_close(stmt);
+        return false;
+    }
+
+    auto number = [&](size_t col) { return slots[col].isNull ? std::optional<int>() : std::optional<int>(slots[col].number); };
+    int status;
+    while ((status = mysql_stmt_fetch(stmt)) == 0 || status == MYSQL_DATA_TRUNCATED) {
+        DoneTaskGroup group;
+        group.category_id = number(0);
+        group.context_id = number(1);
+        bool rebind = false;
+        if (!slots[2].isNull) group.project_uuid.emplace(mysqlText(stmt, binds[2], slots[2], 2, rebind));
+        if (rebind) mysql_stmt_bind_result(stmt, binds);
+        group.topic_id = number(3);
+        group.delegated_to = number(4);
+        group.db_id = db_id;
+        group.count = sumNull[0] ? 0 : sums[0];
+        group.doneThisWeek = sumNull[1] ? 0 : sums[1];
+        group.minutes = sumNull[2] ? 0 : sums[2];
+        groups.push_back(std::move(group));
+    }
+    const bool read = status != 1;
+    if (!read) LOG_ERROR("Reading done counts failed: {}", mysql_stmt_error(stmt));
+    mysql_stmt_close(stmt);
+    return read;
+}
+
+static bool countDoneTasksInSQLite(sqlite3* conn, int db_id, const TaskQuery& query, const std::string& completedSince,
+                                   std::vector<DoneTaskGroup>& groups) {
+    const std::string sql = countDoneSql(query);
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(conn, sql.c_str(), static_cast<int>(sql.size()), &stmt, nullptr) != SQLITE_OK) {
+        LOG_ERROR("SQLite prepare failed: {}", sqlite3_errmsg(conn));
+        return false;
+    }
+    sqlite3_bind_text(stmt, 1, completedSince.data(), static_cast<int>(completedSince.size()), SQLITE_STATIC);
+    for (size_t i = 0; i < query.params.size(); ++i) {
+        bindSQLite(stmt, static_cast<int>(i + 2), query.params[i]);
+    }
+
+    auto number = [&](int col) {
+        return sqlite3_column_type(stmt, col) == SQLITE_NULL ? std::optional<int>() : std::optional<int>(sqlite3_column_int(stmt, col));
+    };
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        DoneTaskGroup group;
+        group.category_id = number(0);
+        group.context_id = number(1);
+        if (const unsigned char* text = sqlite3_column_text(stmt, 2)) {
+            group.project_uuid.emplace(reinterpret_cast<const char*>(text), sqlite3_column_bytes(stmt, 2));
+        }
+        group.topic_id = number(3);
+        group.delegated_to = number(4);
+        group.db_id = db_id;
+        group.count = sqlite3_column_int64(stmt, 5);
+        group.doneThisWeek = sqlite3_column_int64(stmt, 6);
+        group.minutes = sqlite3_column_int64(stmt, 7);
+        groups.push_back(std::move(group));
+    }
+    const bool read = rc == SQLITE_DONE;
+    if (!read) LOG_ERROR("Reading done counts failed: {}", sqlite3_errmsg(conn));
+    sqlite3_finalize(stmt);
+    return read;
+}
+
+std::vector<DoneTaskGroup> countDoneTasks(const TaskQuery& query, const std::string& completedSince, bool* ok) {
+    GTD_TRACE_SCOPE("countDoneTasks");
+    std::vector<DoneTaskGroup> groups;
+    if (ok) *ok = true;
+
+    for (size_t db_id = 0; db_id < allDatabases.size(); ++db_id) {
+        const auto& dbConn = allDatabases[db_id];
+        bool answered = true;
+        if (dbConn.type == DatabaseType::MYSQL) {
+            answered = countDoneTasksInMySQL(std::get<MYSQL*>(dbConn.connection), static_cast<int>(db_id), query, completedSince, groups);
+        }
+        else if (dbConn.type == DatabaseType::SQLITE) {
+            answered = countDoneTasksInSQLite(sqliteReadConnection(dbConn), static_cast<int>(db_id), query, completedSince, groups);
+        }
+        if (!answered && ok) *ok = false;
+    }
+    return groups;
+}
+
+
+
+void saveTaskToDatabase(Task& task) {
+    GTD_TRACE_SCOPE("saveTaskToDatabase");
+    ++task.revision;
+    DatabaseConnection& conn = allDatabases[task.db_id];
+
+    DatabaseMetrics& metrics = databaseMetrics(task.db_id);
+    ScopedLatency saveTimer(metrics.saveLatency);
+
+    // An edited archived task rejoins the active tier; the next archive run
+    // moves it back if it is still long done
+    if (task.archived) {
+        if (!restoreArchivedTask(task.db_id, task.uuid)) {
+            LOG_ERROR("Could not restore archived task {}; save cancelled.", task.uuid);
+            metrics.failedWrites.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        task.archived = false;
+    }
+
+    // Step 1: Set updated_at to current time, and completed_at when the task was just finished
+    {
+        auto now = std::chrono::system_clock::now();
+        std::time_t now_c = std::chrono::system_clock::to_time_t(now);
+        std::stringstream ss;
+        ss << std::put_time(std::localtime(&now_c), "%Y-%m-%d %H:%M:%S");
+        task.updated_at = ss.str();
+
+        if (!task.is_done) task.completed_at.reset();
+        else if (!task.completed_at) task.completed_at = task.updated_at;
+    }
+
+    LOG_DEBUG("Saving task {} to DB ID {} ({})", task.uuid, task.db_id,
+        std::holds_alternative<MYSQL*>(conn.connection) ? "MySQL" : "SQLite");
+
+    writeTaskRow(task);
+}
+
+bool writeTaskRow(const Task& task) {
+    DatabaseConnection& conn = allDatabases[task.db_id];
+    DatabaseMetrics& metrics = databaseMetrics(task.db_id);
+    bool ok = true;
+
+    // Notes that were never loaded are left out so a save cannot blank them
+    auto bindColumns = [&](auto&& bind) {
+        int param = 0;
+        forEachTaskColumn([&](const auto& column, size_t) {
+            if (column.is(kColumnLazy) && !task.notes_loaded) return;
+            bind(param++, column.get(task));
+        });
+    };
+
+    if (std::holds_alternative<MYSQL*>(conn.connection)) {
+        MYSQL* mysql = std::get<MYSQL*>(conn.connection);
+        const char* sql = task.notes_loaded ? taskSql<TaskSql::UpsertMySQL>() : taskSql<TaskSql::UpsertMySQLLazy>();
+        const size_t sqlLength = task.notes_loaded ? taskSqlLength<TaskSql::UpsertMySQL>() : taskSqlLength<TaskSql::UpsertMySQLLazy>();
+
+        MYSQL_STMT* stmt = mysql_stmt_init(mysql);
+        if (!stmt || mysql_stmt_prepare(stmt, sql, static_cast<unsigned long>(sqlLength)) != 0) {
+            LOG_ERROR("MySQL prepare error in writeTaskRow for {}: {}", task.uuid,
+                stmt ? mysql_stmt_error(stmt) : mysql_error(mysql));
+            if (stmt) mysql_stmt_close(stmt);
+            metrics.failedWrites.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        MYSQL_BIND binds[kTaskColumnCount] = {};
+        MySQLSlot slots[kTaskColumnCount];
+        bindColumns([&](int param, const auto& value) { bindMySQLParam(binds[param], slots[param], value); });
+
+        if (mysql_stmt_bind_param(stmt, binds) != 0 || mysql_stmt_execute(stmt) != 0) {
+            LOG_ERROR("MySQL error in writeTaskRow for {}: {}", task.uuid, mysql_stmt_error(stmt));
+            metrics.failedWrites.fetch_add(1, std::memory_order_relaxed);
+            ok = false;
+        }
+        mysql_stmt_close(stmt);
+    }
+    else {
+        sqlite3* sqlite = std::get<sqlite3*>(conn.connection);
+        sqlite3_stmt* stmt = nullptr;
+        const char* sql = task.notes_loaded ? taskSql<TaskSql::UpsertSQLite>() : taskSql<TaskSql::UpsertSQLiteLazy>();
+
+        if (sqlite3_prepare_v2(sqlite, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+            LOG_ERROR("SQLite prepare error: {}", sqlite3_errmsg(sqlite));
+            metrics.failedWrites.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        bindColumns([&](int param, const auto& value) { bindSQLite(stmt, param + 1, value); });
+
+        if (sqlite3_step(stmt) != SQLITE_DONE) {
+            LOG_ERROR("SQLite step error for {}: {}", task.uuid, sqlite3_errmsg(sqlite));
+            metrics.failedWrites.fetch_add(1, std::memory_order_relaxed);
+            ok = false;
+        }
+
+        sqlite3_finalize(stmt);
+    }
+    return ok;
+}
+
+void moveTaskToDatabase(Task& task, int old_db_id) {
+    if (old_db_id == task.db_id) {
+        LOG_WARN("Tried to move task {} to the same database; skipping.", task.uuid);
+        return;
+    }
+
+    DatabaseConnection& oldConn = allDatabases[old_db_id];
+    DatabaseConnection& newConn = allDatabases[task.db_id];
+
+    // Lazily fetched notes must come along before the old row is deleted
+    if (!task.notes_loaded) {
+        std::optional<std::string> notes = std::holds_alternative<MYSQL*>(oldConn.connection)
+            ? fetchTaskNotes(std::get<MYSQL*>(oldConn.connection), task.uuid)
+            : fetchTaskNotes(std::get<sqlite3*>(oldConn.connection), task.uuid);
+        if (!notes) {
+            LOG_ERROR("Could not load notes of {} before moving it; move cancelled.", task.uuid);
+            task.db_id = old_db_id;
+            return;
+        }
+        task.notes = std::move(*notes);
+        task.notes_loaded = true;
+    }
+
+    // The row to delete has to be in the old database's Tasks table
+    if (task.archived) {
+        if (!restoreArchivedTask(old_db_id, task.uuid)) {
+            LOG_ERROR("Could not restore archived task {} before moving it; move cancelled.", task.uuid);
+            task.db_id = old_db_id;
+            return;
+        }
+        task.archived = false;
+    }
+
+    // First, delete from old DB
+    if (std::holds_alternative<MYSQL*>(oldConn.connection)) {
+        MYSQL* conn = std::get<MYSQL*>(oldConn.connection);
+        std::string query = "DELETE FROM Tasks WHERE uuid = '" + std::string(task.uuid) + "'";
+        if (mysql_query(conn, query.c_str()) != 0) {
+            LOG_ERROR("Failed to delete task from MySQL DB: {}", mysql_error(conn));
+        }
+        else {
+            LOG_DEBUG("Old task {} deleted from MySQL DB {}", task.uuid, old_db_id);
+        }
+    }
+    else if (std::holds_alternative<sqlite3*>(oldConn.connection)) {
+        sqlite3* db = std::get<sqlite3*>(oldConn.connection);
+        sqlite3_stmt* stmt = nullptr;
+        const char* sql = "DELETE FROM Tasks WHERE uuid = ?";
+        if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) == SQLITE_OK) {
+            sqlite3_bind_text(stmt, 1, task.uuid.c_str(), -1, SQLITE_TRANSIENT);
+            if (sqlite3_step(stmt) != SQLITE_DONE) {
+                LOG_ERROR("Failed to delete task from SQLite DB: {}", sqlite3_errmsg(db));
+            }
+            else {
+                LOG_DEBUG("Old task {} deleted from SQLite DB {}", task.uuid, old_db_id);
+            }
+            sqlite3_finalize(stmt);
+        }
+        else {
+            LOG_ERROR("Failed to prepare DELETE in SQLite: {}", sqlite3_errmsg(db));
+        }
+    }
+    else {
+        LOG_ERROR("Unknown database type when deleting old task.");
+    }
+
+    // Now insert into the new DB
+    saveTaskToDatabase(task);
+}
+
+// Legacy single-file SQLite wrapper: bring its schema up to date on open
+void Database::checkAndInitSchema() {
+    if (!db) return;
+
+    if (!migrateSchema(db)) {
+        LOG_ERROR("Schema migration failed: {}", sqlite3_errmsg(db));
+    }
 }
\ No newline at end of file
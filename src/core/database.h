@@ -1,29 +1,60 @@
-#pragma once
-#include <string>
-#include <vector>
-#include "task.h"
-#include <mysql.h>
-#include <sqlite3.h>
-
-
-std::vector<Task> fetchTasksFromDatabase();
-std::vector<Task> fetchTasksFromMySQL(MYSQL* conn, int db_id);
-std::vector<Task> fetchTasksFromSQLite(sqlite3* conn, int db_id);
-
-void saveTaskToDatabase(Task& task);
-void moveTaskToDatabase(Task& task, int old_db_id);
-
-
-class Database {
-public:
-    bool open(const std::string& path);
-    std::vector<Task> getAllTasks();
-
-private:
-    void close();
-    void reportError(const char* msg);
-    void checkAndInitSchema();
-
-
-    struct sqlite3* db = nullptr;
+#pragma once
+#include <optional>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "task.h"
+#include "core/task_schema.h"
+#include "core/task_query.h"
+#include "core/task_aggregates.h"
+#include <mysql.h>
+#include <sqlite3.h>
+
+// Task strings are allocated from resource; pass a TaskGeneration's resource
+// to place the whole load in its arena. Only rows matching query are fetched
+// (see compileTaskFilter); the default query fetches every row. A failed query
+// returns what was read before it failed, and sets *ok to false if ok is given
+// (true when every database answered in full).
+std::vector<Task> fetchTasksFromDatabase(std::pmr::memory_resource* resource = std::pmr::get_default_resource(),
+                                         const TaskQuery& query = {}, bool* ok = nullptr);
+std::vector<Task> fetchTasksFromMySQL(MYSQL* conn, int db_id,
+                                      std::pmr::memory_resource* resource = std::pmr::get_default_resource(),
+                                      const TaskQuery& query = {}, bool* ok = nullptr);
+std::vector<Task> fetchTasksFromSQLite(sqlite3* conn, int db_id,
+                                       std::pmr::memory_resource* resource = std::pmr::get_default_resource(),
+                                       const TaskQuery& query = {}, bool* ok = nullptr);
+
+// Rows matching query (meant to select done tasks), counted per aggregate
+// bucket in every database: how many, how many completed at or after
+// completedSince ("YYYY-MM-DD HH:MM:SS"), and their time_required_minutes.
+// Failures are handled as in fetchTasksFromDatabase.
+std::vector<DoneTaskGroup> countDoneTasks(const TaskQuery& query, const std::string& completedSince, bool* ok = nullptr);
+
+// Notes of a single task, for databases with lazy_notes. nullopt if the query
+// failed or the task does not exist.
+std::optional<std::string> fetchTaskNotes(MYSQL* conn, std::string_view uuid);
+std::optional<std::string> fetchTaskNotes(sqlite3* conn, std::string_view uuid);
+
+void saveTaskToDatabase(Task& task);
+
+// The upsert step of saveTaskToDatabase: writes the row to Tasks in task.db_id
+// exactly as given, without stamping updated_at or restoring an archived row.
+// Reconciliation copies rows between stores with this. False on error.
+bool writeTaskRow(const Task& task);
+void moveTaskToDatabase(Task& task, int old_db_id);
+
+
+class Database {
+public:
+    bool open(const std::string& path);
+    std::vector<Task> getAllTasks();
+
+private:
+    void close();
+    void reportError(const char* msg);
+    void checkAndInitSchema();
+
+
+    struct sqlite3* db = nullptr;
 };
\ No newline at end of file
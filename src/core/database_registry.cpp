@@ -1,111 +1,162 @@
-﻿#include "database_registry.h"
-#include <nlohmann/json.hpp>
-#include <fstream>
-#include <iostream>
-
-using json = nlohmann::json;
-
-// Global list of all database connections
-std::vector<DatabaseConnection> allDatabases;
-
-// Mapping from table name → vector of DB IDs (to allow multiple DBs per table)
-std::map<std::string, std::vector<int>> tableToDatabaseIds;
-
-// Global list of database names (for UI dropdown etc.)
-std::vector<std::string> databaseNames;
-
-bool loadDatabaseConfigs(const std::string& configPath) {
-    std::ifstream file(configPath);
-    if (!file.is_open()) {
-        std::cerr << " Failed to open database config file: " << configPath << "\n";
-        return false;
-    }
-
-    json dbConfig;
-    try {
-        file >> dbConfig;
-    }
-    catch (const std::exception& e) {
-        std::cerr << " Failed to parse database config JSON: " << e.what() << "\n";
-        return false;
-    }
-
-    for (const auto& db : dbConfig) {
-        DatabaseConnection conn;
-        std::string type = db.value("type", "");
-
-        if (type == "mysql") {
-            MYSQL* mysql = mysql_init(nullptr);
-            if (!mysql) {
-                std::cerr << " mysql_init() failed.\n";
-                continue;
-            }
-
-            const std::string& host = db["host"];
-            const std::string& user = db["user"];
-            const std::string& password = db["password"];
-            const std::string& database = db["database"];
-            int port = db.value("port", 3306);
-
-            std::cout << "Connecting to MySQL at " << host << ":" << port << "...\n";
-            if (!mysql_real_connect(mysql, host.c_str(), user.c_str(), password.c_str(), database.c_str(), port, nullptr, 0)) {
-                std::cerr << " mysql_real_connect() failed: " << mysql_error(mysql) << "\n";
-                mysql_close(mysql);
-                continue;
-            }
-
-            conn.type = DatabaseType::MYSQL;
-            conn.connection = mysql;
-            allDatabases.push_back(conn);
-
-            std::string label = db.value("label", "MySQL at " + host);
-            databaseNames.push_back(label);
-        }
-        else if (type == "sqlite") {
-            sqlite3* sqlite = nullptr;
-            const std::string& path = db["path"];
-            std::cout << "Opening SQLite at " << path << "...\n";
-            if (sqlite3_open(path.c_str(), &sqlite) != SQLITE_OK) {
-                std::cerr << " sqlite3_open() failed for path: " << path << "\n";
-                continue;
-            }
-
-            conn.type = DatabaseType::SQLITE;
-            conn.connection = sqlite;
-            allDatabases.push_back(conn);
-
-            std::string label = db.value("label", "SQLite: " + path);
-            databaseNames.push_back(label);
-        }
-        else {
-            std::cerr << " Unknown database type: " << type << "\n";
-        }
-    }
-
-    std::cout << "[DEBUG] Loaded " << databaseNames.size() << " database names.\n";
-    return true;
-}
-
-// === Load table_map.json ===
-bool loadTableMappings(const std::string& mappingPath) {
-    std::ifstream file(mappingPath);
-    if (!file.is_open()) {
-        std::cerr << " Failed to open table mapping file: " << mappingPath << "\n";
-        return false;
-    }
-
-    json tableMap;
-    try {
-        file >> tableMap;
-    }
-    catch (const std::exception& e) {
-        std::cerr << " Failed to parse table mapping JSON: " << e.what() << "\n";
-        return false;
-    }
-
-    for (auto& [tableName, dbIdList] : tableMap.items()) {
-        tableToDatabaseIds[tableName] = dbIdList.get<std::vector<int>>();
-    }
-
-    return true;
+﻿#include "database_registry.h"
+#include "sqlite_tuning.h"
+#include "trace.h"
+#include "logger.h"
+#include <nlohmann/json.hpp>
+#include <fstream>
+
+using json = nlohmann::json;
+
+// Global list of all database connections
+std::vector<DatabaseConnection> allDatabases;
+
+// Mapping from table name → vector of DB IDs (to allow multiple DBs per table)
+std::map<std::string, std::vector<int>> tableToDatabaseIds;
+
+// Global list of database names (for UI dropdown etc.)
+std::vector<std::string> databaseNames;
+
+sqlite3* sqliteReadConnection(const DatabaseConnection& conn) {
+    return conn.sqliteReader ? conn.sqliteReader : std::get<sqlite3*>(conn.connection);
+}
+
+MYSQL* openMySQLConnection(const ConnectionParams& params) {
+    MYSQL* mysql = mysql_init(nullptr);
+    if (!mysql) {
+        LOG_ERROR("mysql_init() failed.");
+        return nullptr;
+    }
+
+    if (!mysql_real_connect(mysql, params.host.c_str(), params.user.c_str(), params.password.c_str(),
+            params.database.c_str(), params.port, nullptr, 0)) {
+        LOG_ERROR("mysql_real_connect() failed: {}", mysql_error(mysql));
+        mysql_close(mysql);
+        return nullptr;
+    }
+    return mysql;
+}
+
+sqlite3* openSQLiteReader(const ConnectionParams& params) {
+    return openTunedSQLite(params.path, params.tuning, true);
+}
+
+// Start from the named profile, then let individual keys override it
+static SQLiteTuning parseSQLiteTuning(const json& db) {
+    SQLiteTuning tuning = sqliteTuningForProfile(db.value("profile", "default"));
+
+    if (db.contains("journal_mode")) tuning.journalMode = db["journal_mode"].get<std::string>();
+    if (db.contains("synchronous")) tuning.synchronous = db["synchronous"].get<std::string>();
+    if (db.contains("cache_size")) tuning.cacheSize = db["cache_size"].get<int>();
+    if (db.contains("mmap_size")) tuning.mmapSize = db["mmap_size"].get<long long>();
+    if (db.contains("temp_store")) tuning.tempStore = db["temp_store"].get<std::string>();
+    if (db.contains("busy_timeout")) tuning.busyTimeoutMs = db["busy_timeout"].get<int>();
+    if (db.contains("read_only_connection")) tuning.readOnlyConnection = db["read_only_connection"].get<bool>();
+
+    return tuning;
+}
+
+bool loadDatabaseConfigs(const std::string& configPath) {
+    GTD_TRACE_SCOPE("loadDatabaseConfigs");
+    std::ifstream file(configPath);
+    if (!file.is_open()) {
+        LOG_ERROR("Failed to open database config file: {}", configPath);
+        return false;
+    }
+
+    json dbConfig;
+    try {
+        file >> dbConfig;
+    }
+    catch (const std::exception& e) {
+        LOG_ERROR("Failed to parse database config JSON: {}", e.what());
+        return false;
+    }
+
+    for (const auto& db : dbConfig) {
+        DatabaseConnection conn;
+        std::string type = db.value("type", "");
+
+        conn.lazyNotes = db.value("lazy_notes", false);
+
+        if (type == "mysql") {
+            conn.params.host = db["host"].get<std::string>();
+            conn.params.user = db["user"].get<std::string>();
+            conn.params.password = db["password"].get<std::string>();
+            conn.params.database = db["database"].get<std::string>();
+            conn.params.port = db.value("port", 3306);
+
+            LOG_INFO("Connecting to MySQL at {}:{}...", conn.params.host, conn.params.port);
+            MYSQL* mysql = openMySQLConnection(conn.params);
+            if (!mysql) {
+                continue;
+            }
+
+            conn.type = DatabaseType::MYSQL;
+            conn.connection = mysql;
+            allDatabases.push_back(conn);
+
+            std::string label = db.value("label", "MySQL at " + conn.params.host);
+            databaseNames.push_back(label);
+        }
+        else if (type == "sqlite") {
+            const std::string& path = db["path"];
+            SQLiteTuning tuning;
+            try {
+                tuning = parseSQLiteTuning(db);
+            }
+            catch (const std::exception& e) {
+                LOG_WARN("Invalid SQLite tuning for {}: {}", path, e.what());
+            }
+
+            LOG_INFO("Opening SQLite at {}...", path);
+            sqlite3* sqlite = openTunedSQLite(path, tuning, false);
+            if (!sqlite) {
+                continue;
+            }
+
+            conn.type = DatabaseType::SQLITE;
+            conn.connection = sqlite;
+            conn.params.path = path;
+            conn.params.tuning = tuning;
+
+            // Opened after the writer so the journal mode is already in place
+            if (tuning.readOnlyConnection) {
+                conn.sqliteReader = openTunedSQLite(path, tuning, true);
+            }
+            allDatabases.push_back(conn);
+
+            std::string label = db.value("label", "SQLite: " + path);
+            databaseNames.push_back(label);
+        }
+        else {
+            LOG_ERROR("Unknown database type: {}", type);
+        }
+    }
+
+    LOG_DEBUG("Loaded {} database names.", databaseNames.size());
+    return true;
+}
+
+// === Load table_map.json ===
+bool loadTableMappings(const std::string& mappingPath) {
+    std::ifstream file(mappingPath);
+    if (!file.is_open()) {
+        LOG_ERROR("Failed to open table mapping file: {}", mappingPath);
+        return false;
+    }
+
+    json tableMap;
+    try {
+        file >> tableMap;
+    }
+    catch (const std::exception& e) {
+        LOG_ERROR("Failed to parse table mapping JSON: {}", e.what());
+        return false;
+    }
+
+    for (auto& [tableName, dbIdList] : tableMap.items()) {
+        tableToDatabaseIds[tableName] = dbIdList.get<std::vector<int>>();
+    }
+
+    return true;
 }
\ No newline at end of file
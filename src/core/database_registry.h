@@ -1,42 +1,71 @@
-﻿#ifndef DATABASE_REGISTRY_H
-#define DATABASE_REGISTRY_H
-
-#include <variant>
-#include <vector>
-#include <map>
-#include <string>
-#include <mysql.h>
-#include <sqlite3.h>
-
-// Enum to distinguish between MySQL and SQLite connections
-enum class DatabaseType {
-    MYSQL,
-    SQLITE
-};
-
-// Connection object wrapping a MySQL or SQLite connection
-struct DatabaseConnection {
-    DatabaseType type;
-    std::variant<MYSQL*, sqlite3*> connection;
-};
-
-// === Global Registry ===
-
-// All database connections (indexed by DB ID)
-extern std::vector<DatabaseConnection> allDatabases;
-
-// Mapping of table name → list of DB IDs it lives in (e.g. "Tasks": [0,1])
-extern std::map<std::string, std::vector<int>> tableToDatabaseIds;
-
-// === Loaders ===
-
-// Load database connection info from a JSON file
-bool loadDatabaseConfigs(const std::string& configPath);
-
-// Load table-to-database mappings from a JSON file
-bool loadTableMappings(const std::string& mappingPath);
-
-// Human-readable names of databases, e.g., ["Shared DB", "Work DB"]
-extern std::vector<std::string> databaseNames;
-
+﻿#ifndef DATABASE_REGISTRY_H
+#define DATABASE_REGISTRY_H
+
+#include <variant>
+#include <vector>
+#include <map>
+#include <string>
+#include <mysql.h>
+#include <sqlite3.h>
+#include "sqlite_tuning.h"
+
+// Enum to distinguish between MySQL and SQLite connections
+enum class DatabaseType {
+    MYSQL,
+    SQLITE
+};
+
+// What a connection was opened with, so worker threads can open their own
+struct ConnectionParams {
+    std::string host;          // MySQL
+    std::string user;
+    std::string password;
+    std::string database;
+    int port = 3306;
+    std::string path;          // SQLite
+    SQLiteTuning tuning;
+};
+
+// Connection object wrapping a MySQL or SQLite connection
+struct DatabaseConnection {
+    DatabaseType type;
+    std::variant<MYSQL*, sqlite3*> connection;
+
+    // Optional SQLITE_OPEN_READONLY handle for fetches next to the writer (SQLite only)
+    sqlite3* sqliteReader = nullptr;
+
+    ConnectionParams params{};
+
+    // Leave notes out of the initial fetch; they are loaded when a card is flipped
+    bool lazyNotes = false;
+};
+
+// === Global Registry ===
+
+// All database connections (indexed by DB ID)
+extern std::vector<DatabaseConnection> allDatabases;
+
+// Mapping of table name → list of DB IDs it lives in (e.g. "Tasks": [0,1])
+extern std::map<std::string, std::vector<int>> tableToDatabaseIds;
+
+// === Loaders ===
+
+// Load database connection info from a JSON file
+bool loadDatabaseConfigs(const std::string& configPath);
+
+// Load table-to-database mappings from a JSON file
+bool loadTableMappings(const std::string& mappingPath);
+
+// Connection to use for read-only queries: the SQLite reader when one is open,
+// otherwise the main connection
+sqlite3* sqliteReadConnection(const DatabaseConnection& conn);
+
+// Open an additional connection with the same parameters, for use on another
+// thread. The SQLite one is read-only. Returns nullptr on failure.
+MYSQL* openMySQLConnection(const ConnectionParams& params);
+sqlite3* openSQLiteReader(const ConnectionParams& params);
+
+// Human-readable names of databases, e.g., ["Shared DB", "Work DB"]
+extern std::vector<std::string> databaseNames;
+
 #endif // DATABASE_REGISTRY_H
\ No newline at end of file
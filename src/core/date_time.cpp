@@ -0,0 +1,84 @@
+#include "core/date_time.h"
+
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+
+int64_t daysFromCivil(int year, unsigned month, unsigned day) {
+    // Howard Hinnant's days_from_civil
+    year -= month <= 2;
+    const int64_t era = (year >= 0 ? year : year - 399) / 400;
+    const unsigned yoe = static_cast<unsigned>(year - era * 400);
+    const unsigned doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<int64_t>(doe) - 719468;
+}
+
+static bool readDigits(std::string_view text, size_t pos, size_t count, int& out) {
+    if (pos + count > text.size()) return false;
+    out = 0;
+    for (size_t i = pos; i < pos + count; ++i) {
+        char c = text[i];
+        if (c < '0' || c > '9') return false;
+        out = out * 10 + (c - '0');
+    }
+    return true;
+}
+
+std::optional<int64_t> parseDateTime(std::string_view text) {
+    int year, month, day, hour = 0, minute = 0, second = 0;
+
+    if (!readDigits(text, 0, 4, year) || text.size() < 10 || text[4] != '-' ||
+        !readDigits(text, 5, 2, month) || text[7] != '-' || !readDigits(text, 8, 2, day)) {
+        return std::nullopt;
+    }
+    if (month < 1 || month > 12 || day < 1 || day > 31) return std::nullopt;
+
+    if (text.size() > 10) {
+        if ((text[10] != ' ' && text[10] != 'T') ||
+            !readDigits(text, 11, 2, hour) || text.size() < 16 || text[13] != ':' ||
+            !readDigits(text, 14, 2, minute)) {
+            return std::nullopt;
+        }
+        if (text.size() >= 19 && text[16] == ':' && !readDigits(text, 17, 2, second)) {
+            return std::nullopt;
+        }
+    }
+
+    return daysFromCivil(year, static_cast<unsigned>(month), static_cast<unsigned>(day)) * 86400
+        + hour * 3600 + minute * 60 + second;
+}
+
+int64_t localNowSeconds() {
+    std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+    std::tm local{};
+#ifdef _WIN32
+    localtime_s(&local, &now);
+#else
+    localtime_r(&now, &local);
+#endif
+    return daysFromCivil(local.tm_year + 1900, static_cast<unsigned>(local.tm_mon + 1), static_cast<unsigned>(local.tm_mday)) * 86400
+        + local.tm_hour * 3600 + local.tm_min * 60 + local.tm_sec;
+}
+
+std::string formatDateTime(int64_t seconds) {
+    int64_t days = seconds >= 0 ? seconds / 86400 : (seconds - 86399) / 86400;
+    int64_t secs = seconds - days * 86400;
+
+    // Howard Hinnant's civil_from_days
+    days += 719468;
+    const int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+    const unsigned doe = static_cast<unsigned>(days - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp = (5 * doy + 2) / 153;
+    const unsigned day = doy - (153 * mp + 2) / 5 + 1;
+    const unsigned month = mp < 10 ? mp + 3 : mp - 9;
+    const int64_t year = static_cast<int64_t>(yoe) + era * 400 + (month <= 2);
+
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%04lld-%02u-%02u %02d:%02d:%02d",
+        static_cast<long long>(year), month, day,
+        static_cast<int>(secs / 3600), static_cast<int>((secs / 60) % 60), static_cast<int>(secs % 60));
+    return buf;
+}
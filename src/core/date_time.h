@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+// Task dates are stored as "YYYY-MM-DD HH:MM:SS" text in local time (see
+// saveTaskToDatabase). These helpers convert them to seconds on a naive local
+// timeline so they can be compared, packed into sort keys and scheduled.
+
+// Accepts "YYYY-MM-DD", "YYYY-MM-DD HH:MM" and "YYYY-MM-DD HH:MM:SS" (a 'T'
+// separator is also allowed). Returns nullopt for anything else.
+std::optional<int64_t> parseDateTime(std::string_view text);
+
+// Current local wall-clock time on the same timeline as parseDateTime
+int64_t localNowSeconds();
+
+// Inverse of parseDateTime, always with seconds
+std::string formatDateTime(int64_t seconds);
+
+// Days since 1970-01-01 for a civil date (proleptic Gregorian)
+int64_t daysFromCivil(int year, unsigned month, unsigned day);
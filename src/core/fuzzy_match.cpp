@@ -0,0 +1,131 @@
+#include "core/fuzzy_match.h"
+
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GTD_FUZZY_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace {
+
+constexpr int kMatchScore = 16;
+constexpr int kConsecutiveBonus = 12;
+constexpr int kWordStartBonus = 10;
+constexpr int kMaxGapPenalty = 8;
+constexpr int kMaxLeadPenalty = 6;
+
+#ifdef GTD_FUZZY_SSE2
+inline unsigned lowestBit(unsigned mask) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return index;
+#else
+    return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
+#endif
+
+// Position of the first c in text at or after from, or npos
+size_t findByte(std::string_view text, size_t from, char c) {
+    size_t i = from;
+#ifdef GTD_FUZZY_SSE2
+    const __m128i needle = _mm_set1_epi8(c);
+    for (; i + 16 <= text.size(); i += 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text.data() + i));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, needle)));
+        if (mask) return i + lowestBit(mask);
+    }
+#endif
+    for (; i < text.size(); ++i) {
+        if (text[i] == c) return i;
+    }
+    return std::string_view::npos;
+}
+
+// Position of the last c in text before end, or npos
+size_t findByteBackward(std::string_view text, size_t end, char c) {
+    while (end > 0) {
+        if (text[--end] == c) return end;
+    }
+    return std::string_view::npos;
+}
+
+bool isWordChar(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || static_cast<unsigned char>(c) >= 0x80;
+}
+
+} // namespace
+
+std::string foldForMatch(std::string_view text) {
+    std::string folded(text);
+    size_t i = 0;
+#ifdef GTD_FUZZY_SSE2
+    // 'A'..'Z' -> 'a'..'z' sixteen bytes at a time
+    const __m128i upperA = _mm_set1_epi8('A' - 1);
+    const __m128i upperZ = _mm_set1_epi8('Z' + 1);
+    const __m128i caseBit = _mm_set1_epi8(0x20);
+    for (; i + 16 <= folded.size(); i += 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(folded.data() + i));
+        __m128i isUpper = _mm_and_si128(_mm_cmpgt_epi8(chunk, upperA), _mm_cmplt_epi8(chunk, upperZ));
+        chunk = _mm_or_si128(chunk, _mm_and_si128(isUpper, caseBit));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(folded.data() + i), chunk);
+    }
+#endif
+    for (; i < folded.size(); ++i) {
+        char& c = folded[i];
+        if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+    }
+    return folded;
+}
+
+uint64_t matchMask(std::string_view folded) {
+    uint64_t mask = 0;
+    for (char ch : folded) {
+        unsigned char c = static_cast<unsigned char>(ch);
+        if (c >= 'a' && c <= 'z')      mask |= uint64_t(1) << (c - 'a');
+        else if (c >= '0' && c <= '9') mask |= uint64_t(1) << (26 + c - '0');
+        else                           mask |= uint64_t(1) << (36 + c % 28);
+    }
+    return mask;
+}
+
+int fuzzyScore(std::string_view query, std::string_view text) {
+    if (query.empty()) return 1;
+    if (query.size() > text.size()) return 0;
+
+    // Forward: earliest position where the whole query has matched
+    size_t end = 0;
+    for (char c : query) {
+        size_t pos = findByte(text, end, c);
+        if (pos == std::string_view::npos) return 0;
+        end = pos + 1;
+    }
+
+    // Backward from there: the latest start, giving the tightest window
+    size_t start = end;
+    for (size_t q = query.size(); q-- > 0;) {
+        start = findByteBackward(text, start, query[q]);
+    }
+
+    // Score the greedy match inside the window
+    int score = kMaxLeadPenalty - std::min<int>(static_cast<int>(start), kMaxLeadPenalty);
+    size_t prev = std::string_view::npos;
+    size_t pos = start;
+    for (char c : query) {
+        pos = findByte(text, pos, c);
+        score += kMatchScore;
+        if (pos == 0 || !isWordChar(text[pos - 1])) score += kWordStartBonus;
+        if (prev != std::string_view::npos) {
+            if (pos == prev + 1) score += kConsecutiveBonus;
+            else score -= std::min<int>(static_cast<int>(pos - prev - 1), kMaxGapPenalty);
+        }
+        prev = pos++;
+    }
+    return std::max(score, 1);
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// === Fuzzy subsequence matching ===
+// Matching is ASCII case-insensitive: text and query are folded once with
+// foldForMatch and only folded copies are compared. Scans use SSE2 where the
+// target has it (every x64 build) and plain loops elsewhere.
+
+std::string foldForMatch(std::string_view text);
+
+// One bit per letter and digit present (other bytes share a few bits). A query
+// whose mask has a bit the text's mask lacks cannot match it.
+uint64_t matchMask(std::string_view folded);
+
+// Score of query as a subsequence of text, both folded; 0 means no match.
+// Consecutive characters and characters at word starts score higher, gaps
+// and a late start score lower.
+int fuzzyScore(std::string_view query, std::string_view text);
@@ -0,0 +1,273 @@
+#include "core/logger.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Log::detail {
+    std::atomic<uint8_t> g_level{ static_cast<uint8_t>(LogLevel::Info) };
+}
+
+namespace {
+
+using Log::detail::Record;
+
+constexpr size_t kRingSlots = 1024;
+
+// Single-producer / single-consumer ring owned by one writer thread
+struct Ring {
+    std::atomic<uint64_t> head{ 0 };   // next slot the producer fills
+    std::atomic<uint64_t> tail{ 0 };   // next slot the sink reads
+    std::unique_ptr<Record[]> slots{ new Record[kRingSlots] };
+};
+
+// Rings outlive their threads so late records still reach the sink. The
+// mutex guards registration only; writers never take it after the first call.
+std::mutex g_ringsMutex;
+std::vector<std::unique_ptr<Ring>> g_rings;
+
+std::atomic<uint64_t> g_dropped{ 0 };
+std::atomic<bool> g_running{ false };
+std::mutex g_lifecycleMutex;
+std::thread g_sinkThread;
+FILE* g_file = nullptr;
+
+Ring& localRing() {
+    thread_local Ring* ring = nullptr;
+    if (!ring) {
+        auto owned = std::make_unique<Ring>();
+        std::lock_guard<std::mutex> lock(g_ringsMutex);
+        ring = owned.get();
+        g_rings.push_back(std::move(owned));
+    }
+    return *ring;
+}
+
+const char* levelTag(LogLevel level) {
+    switch (level) {
+    case LogLevel::Debug: return "DEBUG";
+    case LogLevel::Info:  return "INFO ";
+    case LogLevel::Warn:  return "WARN ";
+    case LogLevel::Error: return "ERROR";
+    default:              return "     ";
+    }
+}
+
+// Decode the next argument at `offset` and append it to `out`
+bool appendArgument(const Record& r, size_t& offset, std::string& out) {
+    if (offset >= r.used) return false;
+
+    auto tag = static_cast<Log::detail::ArgTag>(r.payload[offset++]);
+    char number[32];
+
+    switch (tag) {
+    case Log::detail::TagInt: {
+        int64_t v;
+        std::memcpy(&v, r.payload + offset, sizeof(v));
+        offset += sizeof(v);
+        std::snprintf(number, sizeof(number), "%lld", static_cast<long long>(v));
+        out += number;
+        return true;
+    }
+    case Log::detail::TagUInt: {
+        uint64_t v;
+        std::memcpy(&v, r.payload + offset, sizeof(v));
+        offset += sizeof(v);
+        std::snprintf(number, sizeof(number), "%llu", static_cast<unsigned long long>(v));
+        out += number;
+        return true;
+    }
+    case Log::detail::TagDouble: {
+        double v;
+        std::memcpy(&v, r.payload + offset, sizeof(v));
+        offset += sizeof(v);
+        std::snprintf(number, sizeof(number), "%g", v);
+        out += number;
+        return true;
+    }
+    case Log::detail::TagString: {
+        uint16_t len;
+        std::memcpy(&len, r.payload + offset, sizeof(len));
+        offset += sizeof(len);
+        out.append(r.payload + offset, len);
+        offset += len;
+        return true;
+    }
+    }
+    return false;
+}
+
+void formatRecord(const Record& r, std::string& out) {
+    std::time_t seconds = static_cast<std::time_t>(r.timeUs / 1000000);
+    std::tm local{};
+#ifdef _WIN32
+    localtime_s(&local, &seconds);
+#else
+    localtime_r(&seconds, &local);
+#endif
+
+    char prefix[48];
+    std::snprintf(prefix, sizeof(prefix), "%02d:%02d:%02d.%03d [%s] ",
+        local.tm_hour, local.tm_min, local.tm_sec,
+        static_cast<int>((r.timeUs / 1000) % 1000), levelTag(r.level));
+    out += prefix;
+
+    size_t offset = 0;
+    for (const char* p = r.format; *p; ++p) {
+        if (p[0] == '{' && p[1] == '}' && appendArgument(r, offset, out)) {
+            ++p;
+            continue;
+        }
+        out += *p;
+    }
+    out += '\n';
+}
+
+// Console output keeps errors on stderr; a log file gets everything in order
+void writeOut(const std::string& normal, const std::string& errors) {
+    if (g_file) {
+        if (!normal.empty()) std::fwrite(normal.data(), 1, normal.size(), g_file);
+        std::fflush(g_file);
+        return;
+    }
+    if (!normal.empty()) {
+        std::fwrite(normal.data(), 1, normal.size(), stdout);
+        std::fflush(stdout);
+    }
+    if (!errors.empty()) {
+        std::fwrite(errors.data(), 1, errors.size(), stderr);
+        std::fflush(stderr);
+    }
+}
+
+size_t drainAll() {
+    std::vector<Ring*> rings;
+    {
+        std::lock_guard<std::mutex> lock(g_ringsMutex);
+        rings.reserve(g_rings.size());
+        for (auto& ring : g_rings) rings.push_back(ring.get());
+    }
+
+    // Merge the rings by timestamp so lines from different threads interleave in order
+    std::vector<const Record*> batch;
+    std::vector<std::pair<Ring*, uint64_t>> consumed;
+
+    for (Ring* ring : rings) {
+        uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+        uint64_t head = ring->head.load(std::memory_order_acquire);
+        if (head == tail) continue;
+
+        for (uint64_t i = tail; i < head; ++i) batch.push_back(&ring->slots[i % kRingSlots]);
+        consumed.emplace_back(ring, head);
+    }
+    if (batch.empty()) return 0;
+
+    std::stable_sort(batch.begin(), batch.end(),
+        [](const Record* a, const Record* b) { return a->timeUs < b->timeUs; });
+
+    std::string normal;
+    std::string errors;
+    for (const Record* r : batch) {
+        formatRecord(*r, (g_file || r->level < LogLevel::Warn) ? normal : errors);
+    }
+
+    // Release the slots only after formatting; producers may then reuse them
+    for (auto& [ring, head] : consumed) ring->tail.store(head, std::memory_order_release);
+
+    writeOut(normal, errors);
+    return batch.size();
+}
+
+void sinkLoop() {
+    while (g_running.load(std::memory_order_acquire)) {
+        if (drainAll() == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+    }
+    drainAll();
+}
+
+}
+
+namespace Log {
+
+namespace detail {
+
+Record* beginRecord(LogLevel level, const char* format) {
+    Ring& ring = localRing();
+    uint64_t head = ring.head.load(std::memory_order_relaxed);
+    uint64_t tail = ring.tail.load(std::memory_order_acquire);
+
+    if (head - tail >= kRingSlots) {
+        g_dropped.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    Record* r = &ring.slots[head % kRingSlots];
+    r->format = format;
+    r->timeUs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+    r->level = level;
+    r->argCount = 0;
+    r->used = 0;
+    return r;
+}
+
+void commitRecord(Record* record) {
+    // Without a sink, warnings and errors must not wait in a ring that may never drain
+    if (!g_running.load(std::memory_order_acquire) && record->level >= LogLevel::Warn) {
+        std::string line;
+        formatRecord(*record, line);
+        std::fwrite(line.data(), 1, line.size(), stderr);
+        return;
+    }
+
+    Ring& ring = localRing();
+    ring.head.store(ring.head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+}
+
+bool start(const std::string& filePath) {
+    std::lock_guard<std::mutex> lock(g_lifecycleMutex);
+    if (g_running.load()) return true;
+
+    if (!filePath.empty()) {
+        g_file = std::fopen(filePath.c_str(), "a");
+        if (!g_file) {
+            std::fprintf(stderr, " Failed to open log file %s; logging to console.\n", filePath.c_str());
+        }
+    }
+
+    g_running.store(true, std::memory_order_release);
+    g_sinkThread = std::thread(sinkLoop);
+    return true;
+}
+
+void stop() {
+    std::lock_guard<std::mutex> lock(g_lifecycleMutex);
+    if (!g_running.load()) return;
+
+    g_running.store(false, std::memory_order_release);
+    g_sinkThread.join();
+
+    if (g_file) {
+        std::fclose(g_file);
+        g_file = nullptr;
+    }
+}
+
+void setLevel(LogLevel level) {
+    detail::g_level.store(static_cast<uint8_t>(level), std::memory_order_relaxed);
+}
+
+uint64_t droppedCount() {
+    return g_dropped.load(std::memory_order_relaxed);
+}
+
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+// === Asynchronous logger ===
+// Call sites write a fixed-size record into a lock-free per-thread ring; a
+// background sink thread formats the records and writes them to a file or the
+// console. Format strings use "{}" placeholders and must be string literals.
+// Arguments are only evaluated when the level is enabled (see LOG_* macros).
+//
+//   LOG_INFO("Loaded {} tasks from DB {}", tasks.size(), db_id);
+
+enum class LogLevel : uint8_t {
+    Debug,
+    Info,
+    Warn,
+    Error,
+    Off
+};
+
+namespace Log {
+
+    // Start the sink thread. An empty path logs to the console (stdout for
+    // Debug/Info, stderr for Warn/Error). Records written before start() are
+    // kept (up to the ring size) and flushed once the sink runs.
+    bool start(const std::string& filePath = "");
+
+    // Drain every ring and stop the sink thread
+    void stop();
+
+    void setLevel(LogLevel level);
+
+    // Records dropped because a thread's ring was full
+    uint64_t droppedCount();
+
+    namespace detail {
+        extern std::atomic<uint8_t> g_level;
+
+        constexpr size_t kPayloadSize = 224;
+
+        enum ArgTag : uint8_t { TagInt, TagUInt, TagDouble, TagString };
+
+        struct Record {
+            const char* format;
+            uint64_t timeUs;
+            LogLevel level;
+            uint8_t argCount;
+            uint16_t used;
+            char payload[kPayloadSize];
+        };
+
+        Record* beginRecord(LogLevel level, const char* format);
+        void commitRecord(Record* record);
+
+        inline void put(Record& r, ArgTag tag, const void* data, size_t size) {
+            if (r.used + 1u + size > kPayloadSize) return;
+            r.payload[r.used++] = static_cast<char>(tag);
+            std::memcpy(r.payload + r.used, data, size);
+            r.used = static_cast<uint16_t>(r.used + size);
+            ++r.argCount;
+        }
+
+        inline void putString(Record& r, std::string_view s) {
+            if (r.used + 3u > kPayloadSize) return;
+            uint16_t len = static_cast<uint16_t>(std::min(s.size(), kPayloadSize - r.used - 3));
+            r.payload[r.used++] = static_cast<char>(TagString);
+            std::memcpy(r.payload + r.used, &len, sizeof(len));
+            std::memcpy(r.payload + r.used + sizeof(len), s.data(), len);
+            r.used = static_cast<uint16_t>(r.used + sizeof(len) + len);
+            ++r.argCount;
+        }
+
+        template <typename T>
+        void encode(Record& r, const T& value) {
+            if constexpr (std::is_same_v<T, bool>) {
+                putString(r, value ? "true" : "false");
+            }
+            else if constexpr (std::is_same_v<T, char>) {
+                putString(r, std::string_view(&value, 1));
+            }
+            else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+                int64_t v = value;
+                put(r, TagInt, &v, sizeof(v));
+            }
+            else if constexpr (std::is_integral_v<T>) {
+                uint64_t v = value;
+                put(r, TagUInt, &v, sizeof(v));
+            }
+            else if constexpr (std::is_floating_point_v<T>) {
+                double v = value;
+                put(r, TagDouble, &v, sizeof(v));
+            }
+            else if constexpr (std::is_enum_v<T>) {
+                int64_t v = static_cast<int64_t>(value);
+                put(r, TagInt, &v, sizeof(v));
+            }
+            else if constexpr (std::is_convertible_v<const T&, const char*>) {
+                const char* s = value;
+                putString(r, s ? s : "(null)");
+            }
+            else if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+                putString(r, std::string_view(value));
+            }
+            else {
+                static_assert(std::is_void_v<T>, "unsupported log argument type");
+            }
+        }
+    }
+
+    inline bool enabled(LogLevel level) {
+        return static_cast<uint8_t>(level) >= detail::g_level.load(std::memory_order_relaxed);
+    }
+
+    template <typename... Args>
+    void write(LogLevel level, const char* format, const Args&... args) {
+        detail::Record* record = detail::beginRecord(level, format);
+        if (!record) return;
+        (detail::encode(*record, args), ...);
+        detail::commitRecord(record);
+    }
+}
+
+#define GTD_LOG_AT(level, ...) \
+    do { if (::Log::enabled(level)) ::Log::write(level, __VA_ARGS__); } while (0)
+
+#define LOG_DEBUG(...) GTD_LOG_AT(LogLevel::Debug, __VA_ARGS__)
+#define LOG_INFO(...)  GTD_LOG_AT(LogLevel::Info, __VA_ARGS__)
+#define LOG_WARN(...)  GTD_LOG_AT(LogLevel::Warn, __VA_ARGS__)
+#define LOG_ERROR(...) GTD_LOG_AT(LogLevel::Error, __VA_ARGS__)
@@ -1,105 +1,330 @@
-#include "core/lookup_maps.h"
-#include "core/database_registry.h"
-
-#include <mysql.h>
-#include <sqlite3.h>
-#include <iostream>
-#include <map>
-
-// Global lookup maps
-std::map<int, std::string> contextLookup;
-std::map<int, std::string> topicLookup;
-std::map<int, std::string> personLookup;
-std::map<int, std::string> categoryLookup;
-// Note: projectLookup now maps from string (uuid) to name
-std::map<std::string, std::string> projectLookup;
-
-void loadLookupTableFromMySQL(const std::string& table, MYSQL* conn) {
-    std::string idCol = (table == "Projects") ? "uuid" : "id";
-    std::string query = "SELECT " + idCol + ", name FROM " + table;
-
-    if (mysql_query(conn, query.c_str()) != 0) {
-        std::cerr << " MySQL query failed for table " << table << ": " << mysql_error(conn) << "\n";
-        return;
-    }
-
-    MYSQL_RES* result = mysql_store_result(conn);
-    if (!result) return;
-
-    MYSQL_ROW row;
-    while ((row = mysql_fetch_row(result))) {
-        if (table == "Projects") {
-            std::string uuid = row[0];
-            std::string name = row[1];
-            projectLookup[uuid] = name;
-        }
-        else {
-            int id = std::stoi(row[0]);
-            std::string name = row[1];
-
-            if (table == "Contexts") contextLookup[id] = name;
-            else if (table == "Topics") topicLookup[id] = name;
-            else if (table == "People") personLookup[id] = name;
-            else if (table == "Categories") categoryLookup[id] = name;
-        }
-    }
-
-    mysql_free_result(result);
-}
-
-void loadLookupTableFromSQLite(const std::string& table, sqlite3* db) {
-    std::string idCol = (table == "Projects") ? "uuid" : "id";
-    std::string query = "SELECT " + idCol + ", name FROM " + table;
-    sqlite3_stmt* stmt = nullptr;
-
-    if (sqlite3_prepare_v2(db, query.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
-        std::cerr << " SQLite query failed for table " << table << ": " << sqlite3_errmsg(db) << "\n";
-        return;
-    }
-
-    while (sqlite3_step(stmt) == SQLITE_ROW) {
-        if (table == "Projects") {
-            std::string uuid = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
-            std::string name = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
-            projectLookup[uuid] = name;
-        }
-        else {
-            int id = sqlite3_column_int(stmt, 0);
-            std::string name = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
-
-            if (table == "Contexts") contextLookup[id] = name;
-            else if (table == "Topics") topicLookup[id] = name;
-            else if (table == "People") personLookup[id] = name;
-            else if (table == "Categories") categoryLookup[id] = name;
-        }
-    }
-
-    sqlite3_finalize(stmt);
-}
-
-void populateLookupMaps() {
-    std::vector<std::string> tables = { "Projects", "Contexts", "Topics", "People", "Categories" };
-
-    for (const auto& table : tables) {
-        if (!tableToDatabaseIds.count(table)) continue;
-
-        for (int dbId : tableToDatabaseIds[table]) {
-            if (dbId < 0 || dbId >= allDatabases.size()) continue;
-
-            const auto& dbConn = allDatabases[dbId];
-            if (dbConn.type == DatabaseType::MYSQL) {
-                loadLookupTableFromMySQL(table, std::get<MYSQL*>(dbConn.connection));
-            }
-            else if (dbConn.type == DatabaseType::SQLITE) {
-                loadLookupTableFromSQLite(table, std::get<sqlite3*>(dbConn.connection));
-            }
-        }
-    }
-
-    std::cout << "[DEBUG] Lookup map sizes:\n";
-    std::cout << "  Projects:   " << projectLookup.size() << "\n";
-    std::cout << "  Contexts:   " << contextLookup.size() << "\n";
-    std::cout << "  Topics:     " << topicLookup.size() << "\n";
-    std::cout << "  People:     " << personLookup.size() << "\n";
-    std::cout << "  Categories: " << categoryLookup.size() << "\n";
-}
\ No newline at end of file
+#include "core/lookup_maps.h"
+#include "core/database_registry.h"
+#include "core/trace.h"
+#include "core/logger.h"
+
+#include <mysql.h>
+#include <sqlite3.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <variant>
+#include <vector>
+
+namespace {
+
+// === Publication and reclamation ===
+
+// One per thread that has ever read a snapshot. `epoch` is the global epoch the
+// thread's outermost guard started in, or 0 while it holds no guard.
+struct ReaderSlot {
+    std::atomic<uint64_t> epoch{ 0 };
+    int depth = 0;  // nested guards, touched only by the owning thread
+};
+
+const LookupSnapshot g_emptySnapshot;
+std::atomic<const LookupSnapshot*> g_current{ &g_emptySnapshot };
+std::atomic<uint64_t> g_epoch{ 1 };
+
+// Slot registration happens once per thread; readers never take this mutex after
+std::mutex g_slotsMutex;
+std::vector<std::unique_ptr<ReaderSlot>> g_slots;
+
+// Publishers only: retired snapshots tagged with the first epoch that cannot see them
+std::mutex g_publishMutex;
+std::vector<std::pair<uint64_t, const LookupSnapshot*>> g_retired;
+uint64_t g_version = 0;
+
+ReaderSlot& localSlot() {
+    thread_local ReaderSlot* slot = nullptr;
+    if (!slot) {
+        auto owned = std::make_unique<ReaderSlot>();
+        std::lock_guard<std::mutex> lock(g_slotsMutex);
+        slot = owned.get();
+        g_slots.push_back(std::move(owned));
+    }
+    return *slot;
+}
+
+// Caller holds g_publishMutex
+void reclaimLocked() {
+    uint64_t oldestActive = std::numeric_limits<uint64_t>::max();
+    {
+        std::lock_guard<std::mutex> lock(g_slotsMutex);
+        for (const auto& slot : g_slots) {
+            uint64_t epoch = slot->epoch.load();
+            if (epoch != 0) oldestActive = std::min(oldestActive, epoch);
+        }
+    }
+
+    // A reader that entered in epoch e may still hold anything retired after e
+    auto reclaimable = [oldestActive](const std::pair<uint64_t, const LookupSnapshot*>& retired) {
+        return retired.first <= oldestActive;
+    };
+    for (const auto& retired : g_retired) {
+        if (reclaimable(retired)) delete retired.second;
+    }
+    g_retired.erase(std::remove_if(g_retired.begin(), g_retired.end(), reclaimable), g_retired.end());
+}
+
+// === Loading ===
+
+void loadLookupTableFromMySQL(const std::string& table, MYSQL* conn, LookupSnapshot& lookups) {
+    std::string idCol = (table == "Projects") ? "uuid" : "id";
+    std::string query = "SELECT " + idCol + ", name FROM " + table;
+
+    if (mysql_query(conn, query.c_str()) != 0) {
+        LOG_ERROR("MySQL query failed for table {}: {}", table, mysql_error(conn));
+        return;
+    }
+
+    MYSQL_RES* result = mysql_store_result(conn);
+    if (!result) return;
+
+    MYSQL_ROW row;
+    while ((row = mysql_fetch_row(result))) {
+        if (table == "Projects") {
+            std::string uuid = row[0];
+            std::string name = row[1];
+            lookups.projects[Uuid::fromText(uuid)] = { uuid, name };
+        }
+        else {
+            int id = std::stoi(row[0]);
+            std::string name = row[1];
+
+            if (table == "Contexts") lookups.contexts[id] = name;
+            else if (table == "Topics") lookups.topics[id] = name;
+            else if (table == "People") lookups.people[id] = name;
+            else if (table == "Categories") lookups.categories[id] = name;
+        }
+    }
+
+    mysql_free_result(result);
+}
+
+void loadLookupTableFromSQLite(const std::string& table, sqlite3* db, LookupSnapshot& lookups) {
+    std::string idCol = (table == "Projects") ? "uuid" : "id";
+    std::string query = "SELECT " + idCol + ", name FROM " + table;
+    sqlite3_stmt* stmt = nullptr;
+
+    if (sqlite3_prepare_v2(db, query.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+        LOG_ERROR("SQLite query failed for table {}: {}", table, sqlite3_errmsg(db));
+        return;
+    }
+
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        if (table == "Projects") {
+            std::string uuid = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+            std::string name = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
+            lookups.projects[Uuid::fromText(uuid)] = { uuid, name };
+        }
+        else {
+            int id = sqlite3_column_int(stmt, 0);
+            std::string name = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
+
+            if (table == "Contexts") lookups.contexts[id] = name;
+            else if (table == "Topics") lookups.topics[id] = name;
+            else if (table == "People") lookups.people[id] = name;
+            else if (table == "Categories") lookups.categories[id] = name;
+        }
+    }
+
+    sqlite3_finalize(stmt);
+}
+
+const char* const kLookupTables[] = { "Projects", "Contexts", "Topics", "People", "Categories" };
+
+// connectionFor(db_id) returns the MYSQL* or sqlite3* to read from, or monostate to skip
+template <typename ConnectionFor>
+LookupSnapshot buildSnapshot(ConnectionFor connectionFor) {
+    LookupSnapshot lookups;
+
+    for (const char* table : kLookupTables) {
+        auto mapped = tableToDatabaseIds.find(table);
+        if (mapped == tableToDatabaseIds.end()) continue;
+
+        for (int dbId : mapped->second) {
+            if (dbId < 0 || dbId >= static_cast<int>(allDatabases.size())) continue;
+
+            auto conn = connectionFor(dbId);
+            if (auto* mysql = std::get_if<MYSQL*>(&conn)) {
+                loadLookupTableFromMySQL(table, *mysql, lookups);
+            }
+            else if (auto* sqlite = std::get_if<sqlite3*>(&conn)) {
+                loadLookupTableFromSQLite(table, *sqlite, lookups);
+            }
+        }
+    }
+
+    return lookups;
+}
+
+bool sameContents(const LookupSnapshot& a, const LookupSnapshot& b) {
+    return a.projects == b.projects && a.contexts == b.contexts && a.topics == b.topics &&
+        a.people == b.people && a.categories == b.categories;
+}
+
+// === Background refresh ===
+
+using RefreshConnection = std::variant<std::monostate, MYSQL*, sqlite3*>;
+
+std::mutex g_refreshMutex;
+std::condition_variable g_refreshWake;
+std::thread g_refreshThread;
+bool g_refreshRunning = false;
+bool g_refreshStopping = false;
+
+void refreshMain(std::chrono::seconds interval) {
+    mysql_thread_init();
+    std::vector<RefreshConnection> conns(allDatabases.size());
+
+    auto connectionFor = [&conns](int dbId) -> RefreshConnection {
+        RefreshConnection& slot = conns[dbId];
+        if (std::holds_alternative<std::monostate>(slot)) {
+            const DatabaseConnection& db = allDatabases[dbId];
+            if (db.type == DatabaseType::MYSQL) {
+                if (MYSQL* mysql = openMySQLConnection(db.params)) slot = mysql;
+            }
+            else if (sqlite3* sqlite = openSQLiteReader(db.params)) {
+                slot = sqlite;
+            }
+            if (std::holds_alternative<std::monostate>(slot)) {
+                LOG_WARN("Lookup refresh could not connect to DB ID {}", dbId);
+            }
+        }
+        return slot;
+    };
+
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(g_refreshMutex);
+            if (g_refreshWake.wait_for(lock, interval, [] { return g_refreshStopping; })) break;
+        }
+
+        LookupSnapshot fresh;
+        {
+            GTD_TRACE_SCOPE("refreshLookupMaps");
+            fresh = buildSnapshot(connectionFor);
+        }
+
+        bool changed;
+        {
+            LookupReadGuard current;
+            changed = !sameContents(*current, fresh);
+        }
+        if (changed) {
+            publishLookupSnapshot(std::move(fresh));
+            LOG_INFO("Lookup tables changed; published version {}", lookupVersion());
+        }
+    }
+
+    for (auto& slot : conns) {
+        if (auto* mysql = std::get_if<MYSQL*>(&slot)) mysql_close(*mysql);
+        if (auto* sqlite = std::get_if<sqlite3*>(&slot)) sqlite3_close(*sqlite);
+    }
+    mysql_thread_end();
+}
+
+const std::string* findLabel(const std::map<int, std::string>& map, const std::optional<int>& id) {
+    auto it = id ? map.find(*id) : map.end();
+    return it != map.end() ? &it->second : nullptr;
+}
+
+const std::string* findLabel(const std::map<Uuid, LookupProject>& map, const Uuid& id) {
+    auto it = id.isNil() ? map.end() : map.find(id);
+    return it != map.end() ? &it->second.name : nullptr;
+}
+
+// Labels are rewritten in place so a refresh reuses the existing buffers
+// (which may live in the task's arena); growing one in place would allocate
+// from the arena again, so a label that does not fit is rebuilt from resource
+void assignLabel(std::optional<TaskString>& label, const std::string* text, std::pmr::memory_resource* resource) {
+    if (!text) label.reset();
+    else if (label && text->size() <= label->capacity()) label->assign(*text);
+    else label.emplace(*text, resource);
+}
+
+} // namespace
+
+LookupReadGuard::LookupReadGuard() {
+    ReaderSlot& slot = localSlot();
+    if (slot.depth++ == 0) {
+        // Announce the epoch before loading the pointer: a publisher that sees
+        // this slot idle has already swapped, so we can only load the new one
+        slot.epoch.store(g_epoch.load());
+    }
+    snapshot_ = g_current.load();
+}
+
+LookupReadGuard::~LookupReadGuard() {
+    ReaderSlot& slot = localSlot();
+    if (--slot.depth == 0) {
+        slot.epoch.store(0, std::memory_order_release);
+    }
+}
+
+uint64_t lookupVersion() {
+    return g_current.load(std::memory_order_acquire)->version;
+}
+
+void publishLookupSnapshot(LookupSnapshot snapshot) {
+    std::lock_guard<std::mutex> lock(g_publishMutex);
+    snapshot.version = ++g_version;
+
+    const LookupSnapshot* previous = g_current.exchange(new LookupSnapshot(std::move(snapshot)));
+    uint64_t retiredAt = g_epoch.fetch_add(1) + 1;
+    if (previous != &g_emptySnapshot) {
+        g_retired.emplace_back(retiredAt, previous);
+    }
+    reclaimLocked();
+}
+
+void applyLookupLabels(Task& t, const LookupSnapshot& lookups, std::pmr::memory_resource* resource) {
+    assignLabel(t.category_label, findLabel(lookups.categories, t.category_id), resource);
+    assignLabel(t.context_label, findLabel(lookups.contexts, t.context_id), resource);
+    assignLabel(t.project_title, findLabel(lookups.projects, t.project_id), resource);
+    assignLabel(t.topic_label, findLabel(lookups.topics, t.topic_id), resource);
+    assignLabel(t.delegate_name, findLabel(lookups.people, t.delegated_to), resource);
+}
+
+void populateLookupMaps() {
+    GTD_TRACE_SCOPE("populateLookupMaps");
+
+    LookupSnapshot lookups = buildSnapshot([](int dbId) -> RefreshConnection {
+        const auto& dbConn = allDatabases[dbId];
+        if (dbConn.type == DatabaseType::MYSQL) return std::get<MYSQL*>(dbConn.connection);
+        return sqliteReadConnection(dbConn);
+    });
+
+    LOG_DEBUG("Lookup map sizes: Projects {}, Contexts {}, Topics {}, People {}, Categories {}",
+        lookups.projects.size(), lookups.contexts.size(), lookups.topics.size(),
+        lookups.people.size(), lookups.categories.size());
+    publishLookupSnapshot(std::move(lookups));
+}
+
+void startLookupRefresh(std::chrono::seconds interval) {
+    std::lock_guard<std::mutex> lock(g_refreshMutex);
+    if (g_refreshRunning) return;
+
+    g_refreshStopping = false;
+    g_refreshRunning = true;
+    g_refreshThread = std::thread(refreshMain, interval);
+}
+
+void stopLookupRefresh() {
+    {
+        std::lock_guard<std::mutex> lock(g_refreshMutex);
+        if (!g_refreshRunning) return;
+        g_refreshStopping = true;
+    }
+    g_refreshWake.notify_all();
+    g_refreshThread.join();
+
+    std::lock_guard<std::mutex> lock(g_refreshMutex);
+    g_refreshRunning = false;
+}
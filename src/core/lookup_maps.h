@@ -1,17 +1,73 @@
-﻿#pragma once
-
-#include <string>
-#include <map>
-#include <mysql.h>
-#include <sqlite3.h>
-
-// === Global lookup maps ===
-// All map from ID to name, except Projects (which maps from UUID string)
-extern std::map<std::string, std::string> projectLookup;
-extern std::map<int, std::string> contextLookup;
-extern std::map<int, std::string> topicLookup;
-extern std::map<int, std::string> personLookup;
-extern std::map<int, std::string> categoryLookup;
-
-// === Populates all lookup maps from all databases ===
-void populateLookupMaps();
\ No newline at end of file
+﻿#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <map>
+#include "task.h"
+#include "core/uuid.h"
+
+// === Lookup snapshots ===
+// Lookup tables are published as immutable, versioned snapshots behind an
+// atomic pointer. Readers pin the current snapshot with a LookupReadGuard and
+// never take a lock; a refresh builds a whole new snapshot and swaps it in.
+// A replaced snapshot is freed once every guard that could still see it has
+// been released (epoch-based reclamation).
+struct LookupProject {
+    std::string uuid;   // as stored; what a task's project_uuid is set to
+    std::string name;
+
+    bool operator==(const LookupProject& other) const { return uuid == other.uuid && name == other.name; }
+};
+
+struct LookupSnapshot {
+    uint64_t version = 0;   // assigned on publish, increases by one each time
+
+    // All map from ID to name, except projects (which maps from the parsed
+    // UUID to the stored key text and the name)
+    std::map<Uuid, LookupProject> projects;
+    std::map<int, std::string> contexts;
+    std::map<int, std::string> topics;
+    std::map<int, std::string> people;
+    std::map<int, std::string> categories;
+};
+
+// Keep guards short-lived (a fetch, a frame's worth of drawing): a guard held
+// forever keeps every later snapshot from being reclaimed.
+class LookupReadGuard {
+public:
+    LookupReadGuard();
+    ~LookupReadGuard();
+
+    LookupReadGuard(const LookupReadGuard&) = delete;
+    LookupReadGuard& operator=(const LookupReadGuard&) = delete;
+
+    const LookupSnapshot& operator*() const { return *snapshot_; }
+    const LookupSnapshot* operator->() const { return snapshot_; }
+
+private:
+    const LookupSnapshot* snapshot_;
+};
+
+// Version of the current snapshot; caches built from lookup data compare it
+// with the version they were built from
+uint64_t lookupVersion();
+
+// Replace the current snapshot. Its version field is overwritten.
+void publishLookupSnapshot(LookupSnapshot snapshot);
+
+// Fill the display labels of a task (category_label, project_title, ...) from its ids.
+// A label is rewritten in place when it fits its buffer; one that needs new
+// storage is allocated from resource. Fetches pass the resource they build the
+// task with; later refreshes allocate from the heap so they never grow an arena.
+void applyLookupLabels(Task& task, const LookupSnapshot& lookups,
+                       std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+// === Populates the lookup snapshot from all databases ===
+void populateLookupMaps();
+
+// Rebuild the snapshot every interval on a background thread with its own
+// connections. A rebuild that finds nothing changed publishes nothing.
+void startLookupRefresh(std::chrono::seconds interval);
+void stopLookupRefresh();
@@ -0,0 +1,116 @@
+#include "core/metrics.h"
+
+#include <algorithm>
+#include <chrono>
+
+static int highestBit(uint64_t v) {
+    int bit = 0;
+    while (v >>= 1) ++bit;
+    return bit;
+}
+
+uint64_t metricsNowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// === LatencyHistogram ===
+
+LatencyHistogram::LatencyHistogram() {
+    reset();
+}
+
+int LatencyHistogram::bucketIndex(uint64_t us) {
+    if (us < static_cast<uint64_t>(kSubBuckets)) return static_cast<int>(us);
+
+    int msb = highestBit(us);
+    int major = msb - kSubBucketBits + 1;
+    if (major >= kMajorBuckets) return kBucketCount - 1;
+
+    int sub = static_cast<int>((us >> (msb - kSubBucketBits)) & (kSubBuckets - 1));
+    return major * kSubBuckets + sub;
+}
+
+uint64_t LatencyHistogram::bucketUpperUs(int index) {
+    int major = index / kSubBuckets;
+    int sub = index % kSubBuckets;
+    if (major == 0) return static_cast<uint64_t>(sub);
+
+    int msb = major + kSubBucketBits - 1;
+    uint64_t width = 1ull << (msb - kSubBucketBits);
+    return (1ull << msb) + (sub + 1) * width - 1;
+}
+
+void LatencyHistogram::recordNs(uint64_t ns) {
+    counts_[bucketIndex(ns / 1000)].fetch_add(1, std::memory_order_relaxed);
+    total_.fetch_add(1, std::memory_order_relaxed);
+
+    uint64_t seen = maxNs_.load(std::memory_order_relaxed);
+    while (ns > seen && !maxNs_.compare_exchange_weak(seen, ns, std::memory_order_relaxed)) {
+    }
+}
+
+void LatencyHistogram::reset() {
+    for (auto& c : counts_) c.store(0, std::memory_order_relaxed);
+    total_.store(0, std::memory_order_relaxed);
+    maxNs_.store(0, std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::count() const {
+    return total_.load(std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::maxNs() const {
+    return maxNs_.load(std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::percentileNs(double p) const {
+    uint64_t total = count();
+    if (total == 0) return 0;
+
+    uint64_t target = static_cast<uint64_t>(std::clamp(p, 0.0, 100.0) / 100.0 * total);
+    if (target == 0) target = 1;
+
+    uint64_t seen = 0;
+    for (int i = 0; i < kBucketCount; ++i) {
+        seen += counts_[i].load(std::memory_order_relaxed);
+        if (seen >= target) {
+            return std::min(bucketUpperUs(i) * 1000, maxNs());
+        }
+    }
+    return maxNs();
+}
+
+int LatencyHistogram::powerOfTwoCounts(float* out, int maxBars) const {
+    std::fill(out, out + maxBars, 0.0f);
+
+    int bars = 0;
+    for (int i = 0; i < kBucketCount; ++i) {
+        uint64_t n = counts_[i].load(std::memory_order_relaxed);
+        if (n == 0) continue;
+
+        int bar = std::min(highestBit(std::max<uint64_t>(bucketUpperUs(i), 1)), maxBars - 1);
+        out[bar] += static_cast<float>(n);
+        bars = std::max(bars, bar + 1);
+    }
+    return bars;
+}
+
+// === ScopedLatency ===
+
+ScopedLatency::ScopedLatency(LatencyHistogram& histogram)
+    : histogram_(histogram)
+    , startNs_(metricsNowNs())
+{
+}
+
+ScopedLatency::~ScopedLatency() {
+    histogram_.recordNs(metricsNowNs() - startNs_);
+}
+
+// === Per-database metrics ===
+
+DatabaseMetrics& databaseMetrics(int db_id) {
+    static DatabaseMetrics metrics[kMaxTrackedDatabases];
+    return metrics[std::clamp(db_id, 0, kMaxTrackedDatabases - 1)];
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// === Latency histogram ===
+// HDR-style log-linear buckets: each power of two (in microseconds) is split
+// into 16 linear sub-buckets, so percentiles are within ~6% from 1 us to ~12 days.
+// Recording is a single relaxed atomic increment; safe from any thread.
+class LatencyHistogram {
+public:
+    static constexpr int kSubBucketBits = 4;
+    static constexpr int kSubBuckets = 1 << kSubBucketBits;
+    static constexpr int kMajorBuckets = 37;
+    static constexpr int kBucketCount = kMajorBuckets * kSubBuckets;
+
+    LatencyHistogram();
+
+    void recordNs(uint64_t ns);
+    void reset();
+
+    uint64_t count() const;
+    uint64_t maxNs() const;
+
+    // Upper bound of the bucket holding the p-th percentile (p in 0..100); 0 if empty
+    uint64_t percentileNs(double p) const;
+
+    // Counts folded into one bar per power of two (from 1 us), for plotting.
+    // Returns the number of bars written (trailing empty bars are dropped).
+    int powerOfTwoCounts(float* out, int maxBars) const;
+
+private:
+    static int bucketIndex(uint64_t us);
+    static uint64_t bucketUpperUs(int index);
+
+    std::atomic<uint64_t> counts_[kBucketCount];
+    std::atomic<uint64_t> total_;
+    std::atomic<uint64_t> maxNs_;
+};
+
+// Times a scope into a histogram
+class ScopedLatency {
+public:
+    explicit ScopedLatency(LatencyHistogram& histogram);
+    ~ScopedLatency();
+
+    ScopedLatency(const ScopedLatency&) = delete;
+    ScopedLatency& operator=(const ScopedLatency&) = delete;
+
+private:
+    LatencyHistogram& histogram_;
+    uint64_t startNs_;
+};
+
+// === Per-database metrics ===
+struct DatabaseMetrics {
+    LatencyHistogram fetchLatency;
+    LatencyHistogram saveLatency;
+    std::atomic<uint64_t> failedWrites{ 0 };
+};
+
+// Fixed table so lookups never allocate or lock; ids past the end share the last slot
+constexpr int kMaxTrackedDatabases = 16;
+DatabaseMetrics& databaseMetrics(int db_id);
+
+uint64_t metricsNowNs();
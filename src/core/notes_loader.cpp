@@ -0,0 +1,243 @@
+#include "core/notes_loader.h"
+#include "core/database.h"
+#include "core/database_registry.h"
+#include "core/logger.h"
+#include "core/trace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// A failed fetch is retried after this long, doubling per failure up to the cap
+constexpr std::chrono::seconds kRetryFirst{ 2 };
+constexpr std::chrono::seconds kRetryMax{ 60 };
+
+struct NotesRequest {
+    std::string uuid;
+    int db_id = 0;
+};
+
+// Most recently used at the front
+using LruList = std::list<std::pair<std::string, std::string>>;
+
+std::mutex g_mutex;
+std::condition_variable g_wake;
+std::thread g_worker;
+bool g_running = false;
+bool g_stopping = false;
+
+std::deque<NotesRequest> g_queue;
+struct Failure {
+    Clock::time_point retryAt;
+    int attempts = 0;
+};
+
+std::unordered_set<std::string> g_pending;
+std::unordered_map<std::string, Failure> g_failed;
+
+LruList g_lru;
+std::unordered_map<std::string, LruList::iterator> g_index;
+size_t g_bytes = 0;
+size_t g_capacity = 0;
+uint64_t g_hits = 0;
+uint64_t g_misses = 0;
+
+// Caller holds g_mutex
+void insertLocked(const std::string& uuid, std::string notes) {
+    auto found = g_index.find(uuid);
+    if (found != g_index.end()) {
+        g_bytes -= found->second->second.size();
+        g_lru.erase(found->second);
+        g_index.erase(found);
+    }
+
+    g_bytes += notes.size();
+    g_lru.emplace_front(uuid, std::move(notes));
+    g_index[uuid] = g_lru.begin();
+
+    // Always keep the newest entry, even if it alone exceeds the budget
+    while (g_bytes > g_capacity && g_lru.size() > 1) {
+        auto& oldest = g_lru.back();
+        g_bytes -= oldest.second.size();
+        g_index.erase(oldest.first);
+        g_lru.pop_back();
+    }
+}
+
+// Caller holds g_mutex
+void recordFailureLocked(const std::string& uuid) {
+    Failure& failure = g_failed[uuid];
+    const auto backoff = std::min<std::chrono::seconds>(kRetryFirst * (1 << std::min(failure.attempts, 5)), kRetryMax);
+    failure.retryAt = Clock::now() + backoff;
+    ++failure.attempts;
+}
+
+// Worker-owned connections, opened on first use per database
+struct WorkerConnections {
+    std::vector<std::variant<std::monostate, MYSQL*, sqlite3*>> conns;
+
+    std::optional<std::string> fetch(const NotesRequest& request) {
+        if (request.db_id < 0 || request.db_id >= static_cast<int>(allDatabases.size())) return std::nullopt;
+        if (conns.size() < allDatabases.size()) conns.resize(allDatabases.size());
+
+        auto& slot = conns[request.db_id];
+        const DatabaseConnection& db = allDatabases[request.db_id];
+        if (std::holds_alternative<std::monostate>(slot)) {
+            if (db.type == DatabaseType::MYSQL) {
+                if (MYSQL* mysql = openMySQLConnection(db.params)) slot = mysql;
+            }
+            else if (sqlite3* sqlite = openSQLiteReader(db.params)) {
+                slot = sqlite;
+            }
+            if (std::holds_alternative<std::monostate>(slot)) {
+                LOG_ERROR("Notes loader could not connect to DB ID {}", request.db_id);
+                return std::nullopt;
+            }
+        }
+
+        if (MYSQL** mysql = std::get_if<MYSQL*>(&slot)) {
+            std::optional<std::string> notes = fetchTaskNotes(*mysql, request.uuid);
+            // A dropped connection is reopened on the next request
+            if (!notes && mysql_ping(*mysql) != 0) {
+                mysql_close(*mysql);
+                slot = std::monostate{};
+            }
+            return notes;
+        }
+        return fetchTaskNotes(std::get<sqlite3*>(slot), request.uuid);
+    }
+
+    void close() {
+        for (auto& slot : conns) {
+            if (auto* mysql = std::get_if<MYSQL*>(&slot)) mysql_close(*mysql);
+            if (auto* sqlite = std::get_if<sqlite3*>(&slot)) sqlite3_close(*sqlite);
+        }
+        conns.clear();
+    }
+};
+
+void workerMain() {
+    mysql_thread_init();
+    WorkerConnections connections;
+
+    for (;;) {
+        NotesRequest request;
+        {
+            std::unique_lock<std::mutex> lock(g_mutex);
+            g_wake.wait(lock, [] { return g_stopping || !g_queue.empty(); });
+            if (g_stopping) break;
+            request = std::move(g_queue.front());
+            g_queue.pop_front();
+        }
+
+        std::optional<std::string> notes;
+        {
+            GTD_TRACE_SCOPE("NotesLoader::fetch");
+            notes = connections.fetch(request);
+        }
+
+        std::lock_guard<std::mutex> lock(g_mutex);
+        g_pending.erase(request.uuid);
+        if (notes) {
+            g_failed.erase(request.uuid);
+            insertLocked(request.uuid, std::move(*notes));
+        }
+        else {
+            LOG_WARN("Notes for task {} could not be loaded from DB ID {}", request.uuid, request.db_id);
+            recordFailureLocked(request.uuid);
+        }
+    }
+
+    connections.close();
+    mysql_thread_end();
+}
+
+} // namespace
+
+void startNotesLoader(size_t cacheBytes) {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    if (g_running) return;
+
+    g_capacity = cacheBytes;
+    g_stopping = false;
+    g_running = true;
+    g_worker = std::thread(workerMain);
+}
+
+void stopNotesLoader() {
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        if (!g_running) return;
+        g_stopping = true;
+    }
+    g_wake.notify_all();
+    g_worker.join();
+
+    std::lock_guard<std::mutex> lock(g_mutex);
+    g_running = false;
+    g_queue.clear();
+    g_pending.clear();
+}
+
+NotesStatus requestNotes(std::string_view taskUuid, int db_id, std::string& out) {
+    const std::string uuid(taskUuid);
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+
+        auto found = g_index.find(uuid);
+        if (found != g_index.end()) {
+            g_lru.splice(g_lru.begin(), g_lru, found->second);
+            out = found->second->second;
+            ++g_hits;
+            return NotesStatus::Ready;
+        }
+        auto failed = g_failed.find(uuid);
+        if (failed != g_failed.end() && Clock::now() < failed->second.retryAt) return NotesStatus::Failed;
+        if (g_pending.count(uuid)) return NotesStatus::Loading;
+
+        if (!g_running) {
+            LOG_WARN("Notes for task {} requested but the notes loader is not running", uuid);
+            recordFailureLocked(uuid);
+            return NotesStatus::Failed;
+        }
+
+        ++g_misses;
+        g_pending.insert(uuid);
+        g_queue.push_back({ uuid, db_id });
+    }
+    g_wake.notify_one();
+    return NotesStatus::Loading;
+}
+
+void cacheNotes(std::string_view taskUuid, std::string notes) {
+    const std::string uuid(taskUuid);
+    std::lock_guard<std::mutex> lock(g_mutex);
+    g_failed.erase(uuid);
+    insertLocked(uuid, std::move(notes));
+}
+
+NotesCacheStats notesCacheStats() {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    NotesCacheStats stats;
+    stats.entries = g_lru.size();
+    stats.bytes = g_bytes;
+    stats.capacityBytes = g_capacity;
+    stats.pending = g_pending.size();
+    stats.hits = g_hits;
+    stats.misses = g_misses;
+    return stats;
+}
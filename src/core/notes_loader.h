@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Background loading of task notes for databases configured with lazy_notes.
+// One worker thread serves requests in order over its own connection to each
+// database. Loaded notes are kept in an LRU cache bounded by total note bytes.
+
+enum class NotesStatus {
+    Ready,      // out holds the notes
+    Loading,    // queued or in flight; ask again next frame
+    Failed,     // the last fetch failed; asking again after a backoff retries it
+};
+
+void startNotesLoader(size_t cacheBytes);
+void stopNotesLoader();
+
+// Non-blocking. Queues a fetch the first time notes are missing from the cache.
+NotesStatus requestNotes(std::string_view uuid, int db_id, std::string& out);
+
+// Hand notes back to the cache, e.g. when a card is closed after editing
+void cacheNotes(std::string_view uuid, std::string notes);
+
+struct NotesCacheStats {
+    size_t entries = 0;
+    size_t bytes = 0;
+    size_t capacityBytes = 0;
+    size_t pending = 0;
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+};
+
+NotesCacheStats notesCacheStats();
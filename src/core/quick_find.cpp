@@ -0,0 +1,246 @@
+#include "core/quick_find.h"
+#include "core/fuzzy_match.h"
+#include "core/trace.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+// Candidates checked between deadline checks (per worker)
+constexpr size_t kBatchSize = 4096;
+
+// Below this many remaining candidates a single thread finishes sooner
+constexpr size_t kParallelThreshold = 16384;
+
+// Matches outside the title rank below an equally good title match
+constexpr int kTitleBonus = 8;
+
+bool better(const QuickFindResult& a, const QuickFindResult& b) {
+    if (a.score != b.score) return a.score > b.score;
+    return a.taskIndex < b.taskIndex;
+}
+
+} // namespace
+
+// Threads that wait between rounds instead of being started per batch.
+// run(n, job) calls job(0) on the caller and job(1..n-1) on the workers,
+// and returns once all of them have finished.
+class QuickFind::ScanPool {
+public:
+    explicit ScanPool(unsigned threads) {
+        threads_.reserve(threads);
+        for (unsigned i = 0; i < threads; ++i) threads_.emplace_back(&ScanPool::workerMain, this, i + 1);
+    }
+
+    ~ScanPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        for (std::thread& thread : threads_) thread.join();
+    }
+
+    ScanPool(const ScanPool&) = delete;
+    ScanPool& operator=(const ScanPool&) = delete;
+
+    unsigned size() const { return static_cast<unsigned>(threads_.size()) + 1; }
+
+    void run(unsigned jobs, const std::function<void(unsigned)>& job) {
+        jobs = std::min(jobs, size());
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            job_ = &job;
+            jobs_ = jobs;
+            running_ = jobs - 1;
+            ++round_;
+        }
+        wake_.notify_all();
+        job(0);
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        finished_.wait(lock, [this] { return running_ == 0; });
+        job_ = nullptr;
+    }
+
+private:
+    void workerMain(unsigned index) {
+        uint64_t seen = 0;
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (;;) {
+            wake_.wait(lock, [&] { return stopping_ || round_ != seen; });
+            if (stopping_) return;
+            seen = round_;
+            if (index >= jobs_) continue;
+
+            const std::function<void(unsigned)>& job = *job_;
+            lock.unlock();
+            job(index);
+            lock.lock();
+            if (--running_ == 0) finished_.notify_one();
+        }
+    }
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable finished_;
+    const std::function<void(unsigned)>* job_ = nullptr;
+    unsigned jobs_ = 0;
+    unsigned running_ = 0;      // workers still on this round's jobs
+    uint64_t round_ = 0;
+    bool stopping_ = false;
+    std::vector<std::thread> threads_;
+};
+
+QuickFind::QuickFind() = default;
+QuickFind::~QuickFind() = default;
+
+QuickFind::Entry QuickFind::makeEntry(const Task& task) {
+    Entry entry;
+    entry.title = foldForMatch(task.title);
+    if (task.project_title) entry.project = foldForMatch(*task.project_title);
+    if (task.context_label) entry.context = foldForMatch(*task.context_label);
+    entry.mask = matchMask(entry.title) | matchMask(entry.project) | matchMask(entry.context);
+    return entry;
+}
+
+void QuickFind::rebuild(const std::vector<Task>& tasks) {
+    GTD_TRACE_SCOPE("QuickFind::rebuild");
+    entries_.clear();
+    entries_.reserve(tasks.size());
+    for (const Task& task : tasks) entries_.push_back(makeEntry(task));
+
+    // Start over with the current query
+    std::string query;
+    query.swap(query_);
+    candidates_.clear();
+    setQuery(query);
+}
+
+void QuickFind::updateTask(size_t taskIndex, const Task& task) {
+    if (taskIndex >= entries_.size()) return;
+    entries_[taskIndex] = makeEntry(task);
+    if (query_.empty()) return;
+
+    // A candidate the search has not reached yet is scored when it gets there
+    const uint32_t id = static_cast<uint32_t>(taskIndex);
+    if (std::find(candidates_.begin() + next_, candidates_.end(), id) != candidates_.end()) return;
+
+    // Otherwise replace its old result, if any, with a fresh one
+    auto stale = [taskIndex](const QuickFindResult& r) { return r.taskIndex == taskIndex; };
+    matches_.erase(std::remove_if(matches_.begin(), matches_.end(), stale), matches_.end());
+    if (std::any_of(top_.begin(), top_.end(), stale)) {
+        // A slot opened up; the best remaining match takes it
+        top_.clear();
+        for (const QuickFindResult& m : matches_) addToTop(m);
+    }
+
+    const int s = score(entries_[taskIndex]);
+    if (s > 0) addMatch({ taskIndex, s });
+}
+
+void QuickFind::setQuery(std::string_view query) {
+    std::string folded = foldForMatch(query);
+    if (folded == query_ && !candidates_.empty()) return;
+
+    // Refine: everything the longer query can match is among the previous
+    // matches or in the part of the previous search not reached yet
+    bool refine = !query_.empty() && folded.size() > query_.size() &&
+        folded.compare(0, query_.size(), query_) == 0;
+
+    if (refine) {
+        std::vector<uint32_t> narrowed;
+        narrowed.reserve(matches_.size() + (candidates_.size() - next_));
+        for (const QuickFindResult& m : matches_) narrowed.push_back(static_cast<uint32_t>(m.taskIndex));
+        narrowed.insert(narrowed.end(), candidates_.begin() + next_, candidates_.end());
+        candidates_ = std::move(narrowed);
+    }
+    else if (folded.empty()) {
+        candidates_.clear();    // an empty query lists nothing
+    }
+    else {
+        candidates_.resize(entries_.size());
+        for (size_t i = 0; i < entries_.size(); ++i) candidates_[i] = static_cast<uint32_t>(i);
+    }
+
+    query_ = std::move(folded);
+    queryMask_ = matchMask(query_);
+    next_ = 0;
+    matches_.clear();
+    top_.clear();
+}
+
+int QuickFind::score(const Entry& entry) const {
+    if ((entry.mask & queryMask_) != queryMask_) return 0;
+
+    int best = fuzzyScore(query_, entry.title);
+    if (best > 0) best += kTitleBonus;
+    if (!entry.project.empty()) best = std::max(best, fuzzyScore(query_, entry.project));
+    if (!entry.context.empty()) best = std::max(best, fuzzyScore(query_, entry.context));
+    return best;
+}
+
+void QuickFind::scan(size_t begin, size_t end, std::vector<QuickFindResult>& out) const {
+    for (size_t c = begin; c < end; ++c) {
+        size_t taskIndex = candidates_[c];
+        int s = score(entries_[taskIndex]);
+        if (s > 0) out.push_back({ taskIndex, s });
+    }
+}
+
+void QuickFind::addToTop(const QuickFindResult& result) {
+    if (top_.size() == kMaxResults && !better(result, top_.back())) return;
+    top_.insert(std::upper_bound(top_.begin(), top_.end(), result, better), result);
+    if (top_.size() > kMaxResults) top_.pop_back();
+}
+
+void QuickFind::addMatch(const QuickFindResult& result) {
+    matches_.push_back(result);
+    addToTop(result);
+}
+
+bool QuickFind::step(std::chrono::microseconds budget) {
+    if (done()) return true;
+    GTD_TRACE_SCOPE("QuickFind::step");
+
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point deadline = Clock::now() + budget;
+    const unsigned workers = std::max(1u, std::thread::hardware_concurrency());
+
+    std::vector<std::vector<QuickFindResult>> found(workers);
+    do {
+        size_t remaining = candidates_.size() - next_;
+        size_t begin = next_;
+
+        if (remaining < kParallelThreshold || workers == 1) {
+            size_t end = begin + std::min(remaining, kBatchSize);
+            found[0].clear();
+            scan(begin, end, found[0]);
+            next_ = end;
+            for (const QuickFindResult& r : found[0]) addMatch(r);
+            continue;
+        }
+
+        // One batch per worker, merged in candidate order
+        if (!pool_) pool_ = std::make_unique<ScanPool>(workers - 1);
+        size_t end = begin + std::min(remaining, kBatchSize * workers);
+        size_t chunk = (end - begin + workers - 1) / workers;
+        pool_->run(workers, [&](unsigned w) {
+            size_t from = std::min(begin + w * chunk, end);
+            size_t to = std::min(from + chunk, end);
+            found[w].clear();
+            scan(from, to, found[w]);
+        });
+
+        next_ = end;
+        for (const auto& part : found) {
+            for (const QuickFindResult& r : part) addMatch(r);
+        }
+    } while (!done() && Clock::now() < deadline);
+
+    return done();
+}
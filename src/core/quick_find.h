@@ -0,0 +1,75 @@
+#pragma once
+
+#include "core/task.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct QuickFindResult {
+    size_t taskIndex;
+    int score;
+};
+
+// Fuzzy search over task titles, project titles and context labels.
+// A search runs in time-boxed steps so typing never stalls a frame: step()
+// works until its budget is spent and picks up where it left off next call.
+// A query that extends the previous one only re-checks the previous matches
+// (plus whatever that search had not reached yet). Large candidate sets are
+// split across worker threads, which are started once and kept for the life
+// of the QuickFind.
+class QuickFind {
+public:
+    static constexpr size_t kMaxResults = 50;
+
+    QuickFind();
+    ~QuickFind();
+
+    // Index tasks[i] for every i; labels must already be applied
+    void rebuild(const std::vector<Task>& tasks);
+
+    // Re-index one task after an edit. If the current search has already
+    // checked it, it is scored again so its result matches the edit.
+    void updateTask(size_t taskIndex, const Task& task);
+
+    void setQuery(std::string_view query);
+
+    // Returns true once every candidate has been checked
+    bool step(std::chrono::microseconds budget);
+    bool done() const { return next_ >= candidates_.size(); }
+
+    // Best matches found so far, best first
+    const std::vector<QuickFindResult>& results() const { return top_; }
+    size_t matchCount() const { return matches_.size(); }
+
+private:
+    class ScanPool;
+
+    struct Entry {
+        std::string title;      // all folded
+        std::string project;
+        std::string context;
+        uint64_t mask = 0;
+    };
+
+    static Entry makeEntry(const Task& task);
+    int score(const Entry& entry) const;
+    void scan(size_t begin, size_t end, std::vector<QuickFindResult>& out) const;
+    void addToTop(const QuickFindResult& result);
+    void addMatch(const QuickFindResult& result);
+
+    std::vector<Entry> entries_;        // indexed by task index
+    std::string query_;                 // folded
+    uint64_t queryMask_ = 0;
+
+    std::vector<uint32_t> candidates_;  // task indexes the current query must check
+    size_t next_ = 0;                   // candidates_[0, next_) are checked
+    std::vector<QuickFindResult> matches_;
+    std::vector<QuickFindResult> top_;  // at most kMaxResults, best first
+
+    std::unique_ptr<ScanPool> pool_;    // started by the first search large enough to split
+};
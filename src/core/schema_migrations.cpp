@@ -0,0 +1,430 @@
+#include "core/schema_migrations.h"
+#include "core/database_registry.h"
+#include "core/trace.h"
+#include "core/logger.h"
+
+#include <mysql.h>
+#include <sqlite3.h>
+#include <string>
+#include <vector>
+
+// A migration is a list of statements per backend. Statements must be safe to
+// re-run (IF NOT EXISTS) so hand-created tables from before versioning are adopted.
+// A backend with no statements just records the version.
+struct SchemaMigration {
+    int version;
+    const char* description;
+    std::vector<const char*> sqliteStatements;
+    std::vector<const char*> mysqlStatements;
+};
+
+// An index our access paths rely on. `unique` indexes stand in for a missing
+// primary key on tables that were created by hand.
+struct RequiredIndex {
+    const char* table;
+    const char* name;
+    const char* columns;
+    bool unique;
+};
+
+static const std::vector<SchemaMigration> kMigrations = {
+    {
+        1, "Create Tasks table",
+        {
+            R"(CREATE TABLE IF NOT EXISTS Tasks (
+                uuid TEXT NOT NULL PRIMARY KEY,
+                title TEXT NOT NULL DEFAULT '',
+                notes TEXT,
+                category_id INTEGER,
+                context_id INTEGER,
+                project_uuid TEXT,
+                topic_id INTEGER,
+                delegated_to INTEGER,
+                time_required_minutes INTEGER,
+                in_focus INTEGER NOT NULL DEFAULT 0,
+                due_date TEXT,
+                defer_date TEXT,
+                created_at TEXT,
+                updated_at TEXT,
+                is_done INTEGER NOT NULL DEFAULT 0,
+                completed_at TEXT,
+                link_from TEXT,
+                link_to TEXT,
+                is_locked INTEGER NOT NULL DEFAULT 0
+            ))",
+        },
+        {
+            R"(CREATE TABLE IF NOT EXISTS Tasks (
+                uuid CHAR(36) NOT NULL PRIMARY KEY,
+                title VARCHAR(512) NOT NULL DEFAULT '',
+                notes MEDIUMTEXT,
+                category_id INT NULL,
+                context_id INT NULL,
+                project_uuid CHAR(36) NULL,
+                topic_id INT NULL,
+                delegated_to INT NULL,
+                time_required_minutes INT NULL,
+                in_focus TINYINT(1) NOT NULL DEFAULT 0,
+                due_date DATETIME NULL,
+                defer_date DATETIME NULL,
+                created_at DATETIME NULL,
+                updated_at DATETIME NULL,
+                is_done TINYINT(1) NOT NULL DEFAULT 0,
+                completed_at DATETIME NULL,
+                link_from CHAR(36) NULL,
+                link_to CHAR(36) NULL,
+                is_locked TINYINT(1) NOT NULL DEFAULT 0
+            ))",
+        },
+    },
+    {
+        2, "Create lookup tables",
+        {
+            "CREATE TABLE IF NOT EXISTS Projects (uuid TEXT NOT NULL PRIMARY KEY, name TEXT NOT NULL DEFAULT '')",
+            "CREATE TABLE IF NOT EXISTS Contexts (id INTEGER PRIMARY KEY, name TEXT NOT NULL DEFAULT '')",
+            "CREATE TABLE IF NOT EXISTS Topics (id INTEGER PRIMARY KEY, name TEXT NOT NULL DEFAULT '')",
+            "CREATE TABLE IF NOT EXISTS People (id INTEGER PRIMARY KEY, name TEXT NOT NULL DEFAULT '')",
+            "CREATE TABLE IF NOT EXISTS Categories (id INTEGER PRIMARY KEY, name TEXT NOT NULL DEFAULT '')",
+        },
+        {
+            "CREATE TABLE IF NOT EXISTS Projects (uuid CHAR(36) NOT NULL PRIMARY KEY, name VARCHAR(255) NOT NULL DEFAULT '')",
+            "CREATE TABLE IF NOT EXISTS Contexts (id INT NOT NULL AUTO_INCREMENT PRIMARY KEY, name VARCHAR(255) NOT NULL DEFAULT '')",
+            "CREATE TABLE IF NOT EXISTS Topics (id INT NOT NULL AUTO_INCREMENT PRIMARY KEY, name VARCHAR(255) NOT NULL DEFAULT '')",
+            "CREATE TABLE IF NOT EXISTS People (id INT NOT NULL AUTO_INCREMENT PRIMARY KEY, name VARCHAR(255) NOT NULL DEFAULT '')",
+            "CREATE TABLE IF NOT EXISTS Categories (id INT NOT NULL AUTO_INCREMENT PRIMARY KEY, name VARCHAR(255) NOT NULL DEFAULT '')",
+        },
+    },
+    {
+        3, "Create CardPositions table",
+        {
+            R"(CREATE TABLE IF NOT EXISTS CardPositions (
+                task_uuid TEXT NOT NULL PRIMARY KEY,
+                x REAL NOT NULL,
+                y REAL NOT NULL,
+                updated_at TEXT
+            ))",
+        },
+        // Positions are local layout state and only ever stored in SQLite (see card_positions.h)
+        {},
+    },
+    {
+        // Same columns as Tasks, so rows move with INSERT ... SELECT (see task_archive.h)
+        4, "Create TasksArchive table",
+        {
+            R"(CREATE TABLE IF NOT EXISTS TasksArchive (
+                uuid TEXT NOT NULL PRIMARY KEY,
+                title TEXT NOT NULL DEFAULT '',
+                notes TEXT,
+                category_id INTEGER,
+                context_id INTEGER,
+                project_uuid TEXT,
+                topic_id INTEGER,
+                delegated_to INTEGER,
+                time_required_minutes INTEGER,
+                in_focus INTEGER NOT NULL DEFAULT 0,
+                due_date TEXT,
+                defer_date TEXT,
+                created_at TEXT,
+                updated_at TEXT,
+                is_done INTEGER NOT NULL DEFAULT 0,
+                completed_at TEXT,
+                link_from TEXT,
+                link_to TEXT,
+                is_locked INTEGER NOT NULL DEFAULT 0
+            ))",
+        },
+        {
+            R"(CREATE TABLE IF NOT EXISTS TasksArchive (
+                uuid CHAR(36) NOT NULL PRIMARY KEY,
+                title VARCHAR(512) NOT NULL DEFAULT '',
+                notes MEDIUMTEXT,
+                category_id INT NULL,
+                context_id INT NULL,
+                project_uuid CHAR(36) NULL,
+                topic_id INT NULL,
+                delegated_to INT NULL,
+                time_required_minutes INT NULL,
+                in_focus TINYINT(1) NOT NULL DEFAULT 0,
+                due_date DATETIME NULL,
+                defer_date DATETIME NULL,
+                created_at DATETIME NULL,
+                updated_at DATETIME NULL,
+                is_done TINYINT(1) NOT NULL DEFAULT 0,
+                completed_at DATETIME NULL,
+                link_from CHAR(36) NULL,
+                link_to CHAR(36) NULL,
+                is_locked TINYINT(1) NOT NULL DEFAULT 0
+            ))",
+        },
+    },
+};
+
+static const std::vector<RequiredIndex> kRequiredIndexes = {
+    { "Tasks", "idx_tasks_uuid",           "uuid",                  true  },
+    { "Tasks", "idx_tasks_updated_at",     "updated_at",            false },
+    { "Tasks", "idx_tasks_project_uuid",   "project_uuid",          false },
+    { "Tasks", "idx_tasks_context_id",     "context_id",            false },
+    { "Tasks", "idx_tasks_is_done",        "is_done",               false },
+    { "Tasks", "idx_tasks_done_completed", "is_done, completed_at", false },
+};
+
+static const char* kSchemaVersionTableSQLite =
+    "CREATE TABLE IF NOT EXISTS SchemaVersion ("
+    "version INTEGER NOT NULL PRIMARY KEY, "
+    "description TEXT, "
+    "applied_at TEXT DEFAULT CURRENT_TIMESTAMP)";
+
+static const char* kSchemaVersionTableMySQL =
+    "CREATE TABLE IF NOT EXISTS SchemaVersion ("
+    "version INT NOT NULL PRIMARY KEY, "
+    "description VARCHAR(255), "
+    "applied_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP)";
+
+// === MySQL helpers ===
+
+static bool execMySQL(MYSQL* conn, const std::string& sql) {
+    if (mysql_query(conn, sql.c_str()) != 0) {
+        LOG_ERROR("MySQL schema statement failed: {}", mysql_error(conn));
+        return false;
+    }
+    // Statements here return no rows, but drain defensively so the connection stays usable
+    if (MYSQL_RES* res = mysql_store_result(conn)) mysql_free_result(res);
+    return true;
+}
+
+static long long queryScalarMySQL(MYSQL* conn, const std::string& sql) {
+    if (mysql_query(conn, sql.c_str()) != 0) return -1;
+
+    MYSQL_RES* res = mysql_store_result(conn);
+    if (!res) return -1;
+
+    long long value = 0;
+    MYSQL_ROW row = mysql_fetch_row(res);
+    if (row && row[0]) value = std::stoll(row[0]);
+    mysql_free_result(res);
+    return value;
+}
+
+// Primary keys satisfy the uuid requirement without a separate index
+static bool hasPrimaryKeyOnMySQL(MYSQL* conn, const RequiredIndex& index) {
+    std::string sql =
+        "SELECT COUNT(*) FROM information_schema.statistics "
+        "WHERE table_schema = DATABASE() AND table_name = '" + std::string(index.table) + "' "
+        "AND index_name = 'PRIMARY' AND column_name = '" + std::string(index.columns) + "'";
+    return queryScalarMySQL(conn, sql) > 0;
+}
+
+// === SQLite helpers ===
+
+static bool execSQLite(sqlite3* conn, const char* sql) {
+    char* err = nullptr;
+    if (sqlite3_exec(conn, sql, nullptr, nullptr, &err) != SQLITE_OK) {
+        LOG_ERROR("SQLite schema statement failed: {}", err ? err : sqlite3_errmsg(conn));
+        sqlite3_free(err);
+        return false;
+    }
+    return true;
+}
+
+static bool hasIndexOnSQLite(sqlite3* conn, const RequiredIndex& index) {
+    // PRAGMA index_list also reports the implicit index behind a TEXT PRIMARY KEY,
+    // so a single-column unique index on the same column counts as present.
+    std::string sql = "SELECT name, \"unique\" FROM pragma_index_list('" + std::string(index.table) + "')";
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(conn, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) return false;
+
+    std::vector<std::string> uniqueIndexes;
+    bool found = false;
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        const char* name = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+        if (!name) continue;
+        if (std::string(name) == index.name) found = true;
+        if (index.unique && sqlite3_column_int(stmt, 1) != 0) uniqueIndexes.push_back(name);
+    }
+    sqlite3_finalize(stmt);
+    if (found) return true;
+
+    for (const auto& name : uniqueIndexes) {
+        std::string infoSql = "SELECT name FROM pragma_index_info('" + name + "')";
+        if (sqlite3_prepare_v2(conn, infoSql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) continue;
+
+        int columnCount = 0;
+        bool matches = false;
+        while (sqlite3_step(stmt) == SQLITE_ROW) {
+            const char* col = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+            ++columnCount;
+            matches = col && std::string(col) == index.columns;
+        }
+        sqlite3_finalize(stmt);
+        if (columnCount == 1 && matches) return true;
+    }
+    return false;
+}
+
+// === Schema version ===
+
+int readSchemaVersion(MYSQL* conn) {
+    if (!execMySQL(conn, kSchemaVersionTableMySQL)) return 0;
+    long long version = queryScalarMySQL(conn, "SELECT COALESCE(MAX(version), 0) FROM SchemaVersion");
+    return version > 0 ? static_cast<int>(version) : 0;
+}
+
+int readSchemaVersion(sqlite3* conn) {
+    if (!execSQLite(conn, kSchemaVersionTableSQLite)) return 0;
+
+    sqlite3_stmt* stmt = nullptr;
+    int version = 0;
+    if (sqlite3_prepare_v2(conn, "SELECT COALESCE(MAX(version), 0) FROM SchemaVersion", -1, &stmt, nullptr) == SQLITE_OK) {
+        if (sqlite3_step(stmt) == SQLITE_ROW) version = sqlite3_column_int(stmt, 0);
+        sqlite3_finalize(stmt);
+    }
+    return version;
+}
+
+// === Migrations ===
+
+bool migrateSchema(MYSQL* conn) {
+    int version = readSchemaVersion(conn);
+
+    for (const auto& migration : kMigrations) {
+        if (migration.version <= version) continue;
+
+        LOG_INFO("Applying MySQL schema migration {} ({})...", migration.version, migration.description);
+
+        // MySQL commits DDL implicitly, so a failure part-way leaves earlier
+        // statements applied; they are all IF NOT EXISTS and safe to re-run.
+        for (const char* sql : migration.mysqlStatements) {
+            if (!execMySQL(conn, sql)) return false;
+        }
+
+        std::string record = "INSERT INTO SchemaVersion (version, description) VALUES ("
+            + std::to_string(migration.version) + ", '" + migration.description + "')";
+        if (!execMySQL(conn, record)) return false;
+        version = migration.version;
+    }
+
+    return ensureRequiredIndexes(conn);
+}
+
+bool migrateSchema(sqlite3* conn) {
+    int version = readSchemaVersion(conn);
+
+    for (const auto& migration : kMigrations) {
+        if (migration.version <= version) continue;
+
+        LOG_INFO("Applying SQLite schema migration {} ({})...", migration.version, migration.description);
+
+        if (!execSQLite(conn, "BEGIN")) return false;
+
+        bool ok = true;
+        for (const char* sql : migration.sqliteStatements) {
+            if (!execSQLite(conn, sql)) { ok = false; break; }
+        }
+
+        if (ok) {
+            std::string record = "INSERT INTO SchemaVersion (version, description) VALUES ("
+                + std::to_string(migration.version) + ", '" + migration.description + "')";
+            ok = execSQLite(conn, record.c_str());
+        }
+
+        if (!ok) {
+            execSQLite(conn, "ROLLBACK");
+            return false;
+        }
+        if (!execSQLite(conn, "COMMIT")) return false;
+        version = migration.version;
+    }
+
+    return ensureRequiredIndexes(conn);
+}
+
+// === Index checks ===
+
+bool ensureRequiredIndexes(MYSQL* conn) {
+    bool ok = true;
+
+    for (const auto& index : kRequiredIndexes) {
+        if (index.unique && hasPrimaryKeyOnMySQL(conn, index)) continue;
+
+        std::string existsSql =
+            "SELECT COUNT(*) FROM information_schema.statistics "
+            "WHERE table_schema = DATABASE() AND table_name = '" + std::string(index.table) + "' "
+            "AND index_name = '" + std::string(index.name) + "'";
+        long long count = queryScalarMySQL(conn, existsSql);
+        if (count > 0) continue;
+        if (count < 0) {
+            LOG_ERROR("Could not inspect MySQL indexes: {}", mysql_error(conn));
+            ok = false;
+            continue;
+        }
+
+        LOG_WARN("Missing MySQL index {} on {}({}); creating it.", index.name, index.table, index.columns);
+        std::string createSql = std::string("CREATE ") + (index.unique ? "UNIQUE " : "")
+            + "INDEX " + index.name + " ON " + index.table + " (" + index.columns + ")";
+        ok &= execMySQL(conn, createSql);
+    }
+
+    return ok;
+}
+
+bool ensureRequiredIndexes(sqlite3* conn) {
+    bool ok = true;
+
+    for (const auto& index : kRequiredIndexes) {
+        if (hasIndexOnSQLite(conn, index)) continue;
+
+        LOG_WARN("Missing SQLite index {} on {}({}); creating it.", index.name, index.table, index.columns);
+        std::string createSql = std::string("CREATE ") + (index.unique ? "UNIQUE " : "")
+            + "INDEX IF NOT EXISTS " + index.name + " ON " + index.table + " (" + index.columns + ")";
+        ok &= execSQLite(conn, createSql.c_str());
+    }
+
+    return ok;
+}
+
+// === Bulk loading ===
+
+bool dropSecondaryIndexes(sqlite3* conn, const char* table) {
+    bool ok = true;
+    for (const auto& index : kRequiredIndexes) {
+        if (index.unique || std::string(index.table) != table) continue;
+        std::string dropSql = std::string("DROP INDEX IF EXISTS ") + index.name;
+        ok &= execSQLite(conn, dropSql.c_str());
+    }
+    return ok;
+}
+
+bool createSecondaryIndexes(sqlite3* conn, const char* table) {
+    bool ok = true;
+    for (const auto& index : kRequiredIndexes) {
+        if (index.unique || std::string(index.table) != table) continue;
+        std::string createSql = std::string("CREATE INDEX IF NOT EXISTS ") + index.name
+            + " ON " + index.table + " (" + index.columns + ")";
+        ok &= execSQLite(conn, createSql.c_str());
+    }
+    return ok;
+}
+
+bool migrateAllDatabases() {
+    GTD_TRACE_SCOPE("migrateAllDatabases");
+    bool ok = true;
+
+    for (size_t db_id = 0; db_id < allDatabases.size(); ++db_id) {
+        const auto& dbConn = allDatabases[db_id];
+        bool migrated = false;
+
+        if (dbConn.type == DatabaseType::MYSQL) {
+            migrated = migrateSchema(std::get<MYSQL*>(dbConn.connection));
+        }
+        else if (dbConn.type == DatabaseType::SQLITE) {
+            migrated = migrateSchema(std::get<sqlite3*>(dbConn.connection));
+        }
+
+        if (!migrated) {
+            LOG_ERROR("Schema migration failed for DB ID {}", db_id);
+            ok = false;
+        }
+    }
+
+    return ok;
+}
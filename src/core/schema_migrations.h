@@ -0,0 +1,35 @@
+#pragma once
+
+#include <mysql.h>
+#include <sqlite3.h>
+
+// Latest schema version known to this build. Every database records the
+// version it has been migrated to in its SchemaVersion table.
+constexpr int kLatestSchemaVersion = 4;
+
+// === Schema version ===
+// Returns 0 for a database that has never been migrated.
+int readSchemaVersion(MYSQL* conn);
+int readSchemaVersion(sqlite3* conn);
+
+// === Migrations ===
+// Bring a single database up to kLatestSchemaVersion, then verify its indexes.
+// Returns false if a step failed; the database is left at the last good version.
+bool migrateSchema(MYSQL* conn);
+bool migrateSchema(sqlite3* conn);
+
+// === Index checks ===
+// Create any missing index from the required set (uuid key, updated_at for
+// delta sync, project_uuid / context_id / is_done for filtering, is_done +
+// completed_at for archiving).
+bool ensureRequiredIndexes(MYSQL* conn);
+bool ensureRequiredIndexes(sqlite3* conn);
+
+// === Bulk loading ===
+// Drop the non-unique required indexes on one table so a bulk load does not
+// maintain them row by row, then build them once with createSecondaryIndexes.
+bool dropSecondaryIndexes(sqlite3* conn, const char* table);
+bool createSecondaryIndexes(sqlite3* conn, const char* table);
+
+// Migrate and index-check every entry in allDatabases.
+bool migrateAllDatabases();
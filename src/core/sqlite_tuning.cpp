@@ -0,0 +1,112 @@
+#include "core/sqlite_tuning.h"
+#include "core/logger.h"
+
+#include <algorithm>
+#include <cctype>
+#include <string>
+
+// PRAGMA values are spliced into SQL, so only accept the keywords SQLite knows
+static bool isAllowedKeyword(const std::string& value, std::initializer_list<const char*> allowed) {
+    std::string upper = value;
+    std::transform(upper.begin(), upper.end(), upper.begin(),
+        [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+
+    for (const char* keyword : allowed) {
+        if (upper == keyword) return true;
+    }
+    return false;
+}
+
+static bool execPragma(sqlite3* conn, const std::string& pragma) {
+    char* err = nullptr;
+    if (sqlite3_exec(conn, pragma.c_str(), nullptr, nullptr, &err) != SQLITE_OK) {
+        LOG_ERROR("SQLite {} failed: {}", pragma, err ? err : sqlite3_errmsg(conn));
+        sqlite3_free(err);
+        return false;
+    }
+    return true;
+}
+
+SQLiteTuning sqliteTuningForProfile(const std::string& profile) {
+    SQLiteTuning tuning;
+
+    if (profile == "balanced" || profile == "fast") {
+        tuning.journalMode = "WAL";
+        tuning.synchronous = (profile == "fast") ? "OFF" : "NORMAL";
+        tuning.cacheSize = (profile == "fast") ? -65536 : -16384;   // 64 MiB / 16 MiB
+        tuning.mmapSize = (profile == "fast") ? 268435456LL : 67108864LL;
+        tuning.tempStore = "MEMORY";
+        tuning.busyTimeoutMs = 5000;
+        tuning.readOnlyConnection = true;
+    }
+    else if (profile != "default" && !profile.empty()) {
+        LOG_WARN("Unknown SQLite profile '{}'; using default.", profile);
+    }
+
+    return tuning;
+}
+
+bool applySQLiteTuning(sqlite3* conn, const SQLiteTuning& tuning, bool readOnly) {
+    bool ok = true;
+
+    if (tuning.busyTimeoutMs > 0) {
+        ok &= sqlite3_busy_timeout(conn, tuning.busyTimeoutMs) == SQLITE_OK;
+    }
+
+    // journal_mode is stored in the database file; the writer sets it once
+    if (!readOnly && !tuning.journalMode.empty()) {
+        if (isAllowedKeyword(tuning.journalMode, { "DELETE", "TRUNCATE", "PERSIST", "MEMORY", "WAL", "OFF" }))
+            ok &= execPragma(conn, "PRAGMA journal_mode=" + tuning.journalMode);
+        else {
+            LOG_WARN("Ignoring invalid journal_mode: {}", tuning.journalMode);
+            ok = false;
+        }
+    }
+
+    if (!readOnly && !tuning.synchronous.empty()) {
+        if (isAllowedKeyword(tuning.synchronous, { "OFF", "NORMAL", "FULL", "EXTRA" }))
+            ok &= execPragma(conn, "PRAGMA synchronous=" + tuning.synchronous);
+        else {
+            LOG_WARN("Ignoring invalid synchronous level: {}", tuning.synchronous);
+            ok = false;
+        }
+    }
+
+    if (tuning.cacheSize) {
+        ok &= execPragma(conn, "PRAGMA cache_size=" + std::to_string(*tuning.cacheSize));
+    }
+
+    if (tuning.mmapSize) {
+        ok &= execPragma(conn, "PRAGMA mmap_size=" + std::to_string(*tuning.mmapSize));
+    }
+
+    if (!tuning.tempStore.empty()) {
+        if (isAllowedKeyword(tuning.tempStore, { "DEFAULT", "FILE", "MEMORY" }))
+            ok &= execPragma(conn, "PRAGMA temp_store=" + tuning.tempStore);
+        else {
+            LOG_WARN("Ignoring invalid temp_store: {}", tuning.tempStore);
+            ok = false;
+        }
+    }
+
+    return ok;
+}
+
+sqlite3* openTunedSQLite(const std::string& path, const SQLiteTuning& tuning, bool readOnly) {
+    sqlite3* conn = nullptr;
+    int flags = readOnly
+        ? SQLITE_OPEN_READONLY
+        : (SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE);
+
+    if (sqlite3_open_v2(path.c_str(), &conn, flags, nullptr) != SQLITE_OK) {
+        LOG_ERROR("sqlite3_open_v2() failed for path: {} ({})", path, conn ? sqlite3_errmsg(conn) : "out of memory");
+        sqlite3_close(conn);
+        return nullptr;
+    }
+
+    if (!applySQLiteTuning(conn, tuning, readOnly)) {
+        LOG_WARN("Some SQLite settings could not be applied for: {}", path);
+    }
+
+    return conn;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <sqlite3.h>
+
+// Per-database SQLite settings, applied as PRAGMAs right after open.
+// Unset fields leave SQLite's own default in place.
+struct SQLiteTuning {
+    std::string journalMode;            // DELETE, TRUNCATE, PERSIST, MEMORY, WAL, OFF
+    std::string synchronous;            // OFF, NORMAL, FULL, EXTRA
+    std::optional<int> cacheSize;       // pages if positive, KiB if negative
+    std::optional<long long> mmapSize;  // bytes
+    std::string tempStore;              // DEFAULT, FILE, MEMORY
+    int busyTimeoutMs = 0;
+
+    // Open a second SQLITE_OPEN_READONLY handle used for fetches
+    bool readOnlyConnection = false;
+};
+
+// Named presets for database_config.json "profile":
+//   "default"  - plain sqlite3_open behaviour (safe on network drives)
+//   "balanced" - WAL + synchronous=NORMAL, larger cache, mmap, reader connection
+//   "fast"     - as balanced but synchronous=OFF; bulk loads and benchmarks only
+// Unknown names fall back to "default".
+SQLiteTuning sqliteTuningForProfile(const std::string& profile);
+
+// Open a SQLite database and apply the tuning. Returns nullptr on failure.
+// Read-only handles skip the settings that would need a write (journal mode).
+sqlite3* openTunedSQLite(const std::string& path, const SQLiteTuning& tuning, bool readOnly);
+
+// Apply the PRAGMAs to an already open handle. Returns false if any was rejected.
+bool applySQLiteTuning(sqlite3* conn, const SQLiteTuning& tuning, bool readOnly);
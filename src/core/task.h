@@ -1,43 +1,86 @@
-#ifndef TASK_H
-#define TASK_H
-
-#include <string>
-#include <optional>
-#include <chrono>
-
-struct Task {
-    std::string uuid;
-    std::string title;
-    std::string notes;
-
-    std::optional<int> category_id;
-    std::optional<int> context_id;
-    std::optional<std::string> project_uuid;
-    std::optional<int> topic_id;
-    std::optional<int> delegated_to;
-    int db_id = 0;  // 0 = shared (MySQL), 1 = local (SQLite), etc.
-
-    std::optional<int> time_required_minutes;
-
-    bool in_focus = false;
-    bool is_done = false;
-    bool is_locked = false;
-
-    std::optional<std::string> due_date;    // ISO 8601 format
-    std::optional<std::string> defer_date;
-    std::optional<std::string> created_at;
-    std::optional<std::string> updated_at;
-    std::optional<std::string> completed_at;
-
-    std::optional<std::string> link_from;
-    std::optional<std::string> link_to;
-
-    // ?? Enriched display labels (optional, populated later via JOINs)
-    std::optional<std::string> category_label;
-    std::optional<std::string> context_label;
-    std::optional<std::string> project_title;
-    std::optional<std::string> topic_label;
-    std::optional<std::string> delegate_name;
-};
-
+#ifndef TASK_H
+#define TASK_H
+
+#include <string>
+#include <optional>
+#include <chrono>
+#include <cstdint>
+#include <memory_resource>
+#include "core/uuid.h"
+
+// Task text is allocator-aware so a whole load can live in one arena (see
+// TaskGeneration). Copies of a task always allocate from the default heap;
+// moves keep the source's allocator.
+using TaskString = std::pmr::string;
+
+struct Task {
+    using allocator_type = std::pmr::polymorphic_allocator<char>;
+
+    Task() = default;
+    explicit Task(allocator_type alloc)
+        : uuid(alloc), title(alloc), notes(alloc) {}
+
+    Task(const Task&) = default;
+    Task(Task&&) = default;
+    Task& operator=(const Task&) = default;
+    Task& operator=(Task&&) = default;
+
+    // Allocator of this task's strings; optional fields filled later should use
+    // it too: t.due_date.emplace(text, t.get_allocator())
+    allocator_type get_allocator() const { return uuid.get_allocator(); }
+
+    TaskString uuid;
+    TaskString title;
+    TaskString notes;
+    bool notes_loaded = true;   // false while notes were left out of the fetch (lazy_notes)
+
+    std::optional<int> category_id;
+    std::optional<int> context_id;
+    std::optional<TaskString> project_uuid;
+    std::optional<int> topic_id;
+    std::optional<int> delegated_to;
+    int db_id = 0;  // 0 = shared (MySQL), 1 = local (SQLite), etc.
+    bool archived = false;  // row lives in TasksArchive (see task_archive.h)
+
+    std::optional<int> time_required_minutes;
+
+    bool in_focus = false;
+    bool is_done = false;
+    bool is_locked = false;
+
+    std::optional<TaskString> due_date;    // ISO 8601 format
+    std::optional<TaskString> defer_date;
+    std::optional<TaskString> created_at;
+    std::optional<TaskString> updated_at;
+    std::optional<TaskString> completed_at;
+
+    std::optional<TaskString> link_from;
+    std::optional<TaskString> link_to;
+
+    // The uuid fields above parsed once at load; nil where the text is unset.
+    // Compare and hash these rather than the text; call parseIds() after
+    // changing any of the text fields.
+    Uuid id;
+    Uuid project_id;
+    Uuid link_from_id;
+    Uuid link_to_id;
+
+    void parseIds() {
+        id = Uuid::fromText(uuid);
+        project_id = project_uuid ? Uuid::fromText(*project_uuid) : Uuid{};
+        link_from_id = link_from && !link_from->empty() ? Uuid::fromText(*link_from) : Uuid{};
+        link_to_id = link_to && !link_to->empty() ? Uuid::fromText(*link_to) : Uuid{};
+    }
+
+    // ?? Enriched display labels (optional, populated later via JOINs)
+    std::optional<TaskString> category_label;
+    std::optional<TaskString> context_label;
+    std::optional<TaskString> project_title;
+    std::optional<TaskString> topic_label;
+    std::optional<TaskString> delegate_name;
+
+    // Bumped on every save so views can cache data derived from the task
+    uint32_t revision = 0;
+};
+
 #endif // TASK_H
\ No newline at end of file
@@ -0,0 +1,159 @@
+#include "core/task_aggregates.h"
+#include "core/date_time.h"
+#include "core/trace.h"
+
+namespace {
+
+constexpr int64_t kSecondsPerDay = 86400;
+
+// Monday 00:00 of the week containing t (1970-01-01 was a Thursday)
+int64_t startOfWeek(int64_t t) {
+    int64_t day = t / kSecondsPerDay - (t % kSecondsPerDay < 0 ? 1 : 0);
+    int64_t weekday = ((day + 3) % 7 + 7) % 7;   // Monday = 0
+    return (day - weekday) * kSecondsPerDay;
+}
+
+std::string idKey(const std::optional<int>& id) {
+    return id ? std::to_string(*id) : std::string();
+}
+
+void addTotals(AggregateTotals& totals, const AggregateTotals& delta, int64_t sign) {
+    totals.open += sign * delta.open;
+    totals.inFocus += sign * delta.inFocus;
+    totals.overdue += sign * delta.overdue;
+    totals.done += sign * delta.done;
+    totals.doneThisWeek += sign * delta.doneThisWeek;
+    totals.openMinutes += sign * delta.openMinutes;
+    totals.doneMinutes += sign * delta.doneMinutes;
+}
+
+} // namespace
+
+void TaskAggregates::reset(const std::vector<Task>& tasks, const TaskScheduler& scheduler, int64_t now) {
+    GTD_TRACE_SCOPE("TaskAggregates::reset");
+    for (size_t d = 0; d < kAggregateDimensions; ++d) {
+        buckets_[d].clear();
+        bucketIndex_[d].clear();
+    }
+    total_ = AggregateTotals{};
+    weekStart_ = startOfWeek(now);
+
+    // The buckets were cleared, so the unloaded groups look theirs up again
+    for (UnloadedGroup& group : unloaded_) {
+        for (size_t d = 0; d < kAggregateDimensions; ++d) group.bucket[d] = bucketFor(d, group.key[d]);
+        apply(group.bucket, group.totals, 1);
+    }
+
+    contributions_.resize(tasks.size());
+    for (size_t i = 0; i < tasks.size(); ++i) {
+        contributions_[i] = contributionOf(tasks[i], scheduler.overdue(i));
+        apply(contributions_[i], 1);
+    }
+    ++generation_;
+}
+
+void TaskAggregates::update(size_t taskIndex, const Task& task, bool overdue) {
+    if (taskIndex >= contributions_.size()) return;
+
+    Contribution next = contributionOf(task, overdue);
+    apply(contributions_[taskIndex], -1);
+    apply(next, 1);
+    contributions_[taskIndex] = next;
+    ++generation_;
+}
+
+void TaskAggregates::advanceClock(int64_t now) {
+    int64_t week = startOfWeek(now);
+    if (week == weekStart_) return;
+
+    GTD_TRACE_SCOPE("TaskAggregates::advanceClock");
+    for (const Contribution& c : contributions_) apply(c, -1);
+    weekStart_ = week;
+    for (const Contribution& c : contributions_) apply(c, 1);
+
+    // Unloaded tasks were all completed before now, so none are in the new week
+    for (UnloadedGroup& group : unloaded_) {
+        AggregateTotals delta;
+        delta.doneThisWeek = group.totals.doneThisWeek;
+        apply(group.bucket, delta, -1);
+        group.totals.doneThisWeek = 0;
+    }
+    ++generation_;
+}
+
+void TaskAggregates::setUnloadedDone(const std::vector<DoneTaskGroup>& groups) {
+    GTD_TRACE_SCOPE("TaskAggregates::setUnloadedDone");
+    for (const UnloadedGroup& group : unloaded_) apply(group.bucket, group.totals, -1);
+
+    unloaded_.resize(groups.size());
+    for (size_t i = 0; i < groups.size(); ++i) {
+        const DoneTaskGroup& g = groups[i];
+        UnloadedGroup& group = unloaded_[i];
+        group.key[static_cast<size_t>(AggregateDimension::Category)] = idKey(g.category_id);
+        group.key[static_cast<size_t>(AggregateDimension::Context)] = idKey(g.context_id);
+        group.key[static_cast<size_t>(AggregateDimension::Project)] = g.project_uuid.value_or(std::string());
+        group.key[static_cast<size_t>(AggregateDimension::Topic)] = idKey(g.topic_id);
+        group.key[static_cast<size_t>(AggregateDimension::Delegate)] = idKey(g.delegated_to);
+        group.key[static_cast<size_t>(AggregateDimension::Database)] = std::to_string(g.db_id);
+        for (size_t d = 0; d < kAggregateDimensions; ++d) group.bucket[d] = bucketFor(d, group.key[d]);
+
+        group.totals = AggregateTotals{};
+        group.totals.done = g.count;
+        group.totals.doneThisWeek = g.doneThisWeek;
+        group.totals.doneMinutes = g.minutes;
+        apply(group.bucket, group.totals, 1);
+    }
+    ++generation_;
+}
+
+TaskAggregates::Contribution TaskAggregates::contributionOf(const Task& task, bool overdue) {
+    Contribution c;
+    auto assign = [&](AggregateDimension dimension, std::string key) {
+        size_t d = static_cast<size_t>(dimension);
+        c.bucket[d] = bucketFor(d, std::move(key));
+    };
+    assign(AggregateDimension::Category, idKey(task.category_id));
+    assign(AggregateDimension::Context, idKey(task.context_id));
+    assign(AggregateDimension::Project, task.project_uuid ? std::string(*task.project_uuid) : std::string());
+    assign(AggregateDimension::Topic, idKey(task.topic_id));
+    assign(AggregateDimension::Delegate, idKey(task.delegated_to));
+    assign(AggregateDimension::Database, std::to_string(task.db_id));
+
+    if (task.completed_at) {
+        if (auto when = parseDateTime(*task.completed_at)) c.completedAt = *when;
+    }
+    c.minutes = task.time_required_minutes.value_or(0);
+    c.done = task.is_done;
+    c.inFocus = task.in_focus;
+    c.overdue = overdue;
+    return c;
+}
+
+uint32_t TaskAggregates::bucketFor(size_t dimension, std::string key) {
+    auto [it, inserted] = bucketIndex_[dimension].emplace(key, static_cast<uint32_t>(buckets_[dimension].size()));
+    if (inserted) buckets_[dimension].push_back({ std::move(key), AggregateTotals{} });
+    return it->second;
+}
+
+void TaskAggregates::apply(const Contribution& c, int64_t sign) {
+    AggregateTotals delta;
+    if (c.done) {
+        delta.done = 1;
+        delta.doneThisWeek = c.completedAt >= weekStart_ ? 1 : 0;
+        delta.doneMinutes = c.minutes;
+    }
+    else {
+        delta.open = 1;
+        delta.inFocus = c.inFocus ? 1 : 0;
+        delta.overdue = c.overdue ? 1 : 0;
+        delta.openMinutes = c.minutes;
+    }
+    apply(c.bucket, delta, sign);
+}
+
+void TaskAggregates::apply(const uint32_t (&bucket)[kAggregateDimensions], const AggregateTotals& delta, int64_t sign) {
+    addTotals(total_, delta, sign);
+    for (size_t d = 0; d < kAggregateDimensions; ++d) {
+        addTotals(buckets_[d][bucket[d]].totals, delta, sign);
+    }
+}
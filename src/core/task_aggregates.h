@@ -0,0 +1,115 @@
+#pragma once
+
+#include "core/task.h"
+#include "core/task_scheduler.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+enum class AggregateDimension : uint8_t {
+    Category,
+    Context,
+    Project,
+    Topic,
+    Delegate,
+    Database,
+};
+
+inline constexpr size_t kAggregateDimensions = 6;
+
+struct AggregateTotals {
+    int64_t open = 0;
+    int64_t inFocus = 0;        // open tasks in focus
+    int64_t overdue = 0;        // open tasks past their due date
+    int64_t done = 0;
+    int64_t doneThisWeek = 0;   // completed since Monday 00:00
+    int64_t openMinutes = 0;    // sum of time_required_minutes over open tasks
+    int64_t doneMinutes = 0;
+};
+
+// Done tasks that are not in the task list and share one bucket in every
+// dimension, as counted in the database (see countDoneTasks). A negative count
+// takes back tasks the database counted that are in the list after all.
+struct DoneTaskGroup {
+    std::optional<int> category_id;
+    std::optional<int> context_id;
+    std::optional<std::string> project_uuid;
+    std::optional<int> topic_id;
+    std::optional<int> delegated_to;
+    int db_id = 0;
+    int64_t count = 0;
+    int64_t doneThisWeek = 0;
+    int64_t minutes = 0;
+};
+
+struct AggregateBucket {
+    std::string key;    // id as text, project uuid or database index; empty for "none"
+    AggregateTotals totals;
+};
+
+// Counts and time sums per category, context, project, topic, delegate and
+// database, built once from the task list and then kept current one task at a
+// time. Each task's last contribution is cached so an edit subtracts the old
+// one and adds the new one: O(1) per edit, no matter how many tasks there are.
+class TaskAggregates {
+public:
+    void reset(const std::vector<Task>& tasks, const TaskScheduler& scheduler, int64_t now);
+
+    // Call after every edit of tasks[taskIndex] (the same path that saves it)
+    void update(size_t taskIndex, const Task& task, bool overdue);
+
+    // Recount "done this week" once the week rolls over; O(1) otherwise
+    void advanceClock(int64_t now);
+
+    // Done tasks outside the task list (not fetched by the current filters, or
+    // archived), so the done columns count every task and not only the loaded
+    // ones. Replaces the previous set and is kept across reset(). Their "this
+    // week" count is as of weekStart(); it drops to zero when the week rolls over.
+    void setUnloadedDone(const std::vector<DoneTaskGroup>& groups);
+
+    // Monday 00:00 of the current week, on the parseDateTime timeline
+    int64_t weekStart() const { return weekStart_; }
+
+    const AggregateTotals& total() const { return total_; }
+
+    // Buckets are never removed; ones that emptied out keep zero totals
+    const std::vector<AggregateBucket>& buckets(AggregateDimension dimension) const {
+        return buckets_[static_cast<size_t>(dimension)];
+    }
+
+    // Bumped whenever any total changes
+    uint64_t generation() const { return generation_; }
+
+private:
+    struct Contribution {
+        uint32_t bucket[kAggregateDimensions] = {};
+        int64_t completedAt = INT64_MIN;
+        int32_t minutes = 0;
+        bool done = false;
+        bool inFocus = false;
+        bool overdue = false;
+    };
+
+    struct UnloadedGroup {
+        std::string key[kAggregateDimensions];
+        uint32_t bucket[kAggregateDimensions] = {};
+        AggregateTotals totals;
+    };
+
+    Contribution contributionOf(const Task& task, bool overdue);
+    uint32_t bucketFor(size_t dimension, std::string key);
+    void apply(const Contribution& c, int64_t sign);
+    void apply(const uint32_t (&bucket)[kAggregateDimensions], const AggregateTotals& delta, int64_t sign);
+
+    std::vector<Contribution> contributions_;   // indexed like the task list
+    std::vector<UnloadedGroup> unloaded_;
+    std::vector<AggregateBucket> buckets_[kAggregateDimensions];
+    std::unordered_map<std::string, uint32_t> bucketIndex_[kAggregateDimensions];
+    AggregateTotals total_;
+    int64_t weekStart_ = 0;
+    uint64_t generation_ = 0;
+};
@@ -0,0 +1,213 @@
+#include "core/task_archive.h"
+#include "core/database_registry.h"
+#include "core/date_time.h"
+#include "core/task_schema.h"
+#include "core/trace.h"
+#include "core/logger.h"
+
+#include <mysql.h>
+#include <sqlite3.h>
+#include <string>
+#include <variant>
+
+namespace {
+
+// "uuid, title, ..." in schema order, shared by both tables
+std::string columnList() {
+    std::string columns;
+    for (const char* column : kTaskColumns) {
+        if (!columns.empty()) columns += ", ";
+        columns += column;
+    }
+    return columns;
+}
+
+std::string moveSql(const char* verb, const char* from, const char* to, const std::string& where) {
+    const std::string columns = columnList();
+    return std::string(verb) + " INTO " + to + " (" + columns + ") SELECT " + columns + " FROM " + from + " WHERE " + where;
+}
+
+bool execSQLite(sqlite3* conn, const char* sql) {
+    char* error = nullptr;
+    if (sqlite3_exec(conn, sql, nullptr, nullptr, &error) == SQLITE_OK) return true;
+    LOG_ERROR("SQLite archive statement failed: {} ({})", error ? error : "unknown error", sql);
+    sqlite3_free(error);
+    return false;
+}
+
+bool execMySQL(MYSQL* conn, const std::string& sql) {
+    if (mysql_query(conn, sql.c_str()) == 0) return true;
+    LOG_ERROR("MySQL archive statement failed: {}", mysql_error(conn));
+    return false;
+}
+
+bool stepSQLite(sqlite3* conn, sqlite3_stmt* stmt) {
+    bool ok = sqlite3_step(stmt) == SQLITE_DONE;
+    if (!ok) LOG_ERROR("SQLite archive statement failed: {}", sqlite3_errmsg(conn));
+    sqlite3_reset(stmt);
+    return ok;
+}
+
+// BEGIN IMMEDIATE holds the write lock for the whole batch, so the copy and
+// the delete pick the same rows from the same subquery
+size_t archiveSQLite(sqlite3* conn, const std::string& cutoff, size_t batchSize) {
+    const std::string batch = "uuid IN (SELECT uuid FROM Tasks WHERE is_done = 1 AND completed_at IS NOT NULL "
+        "AND completed_at < ?1 ORDER BY completed_at, uuid LIMIT ?2)";
+    const std::string copySql = moveSql("INSERT OR REPLACE", "Tasks", "TasksArchive", batch);
+    const std::string deleteSql = "DELETE FROM Tasks WHERE " + batch;
+
+    sqlite3_stmt* copy = nullptr;
+    sqlite3_stmt* remove = nullptr;
+    if (sqlite3_prepare_v2(conn, copySql.c_str(), -1, &copy, nullptr) != SQLITE_OK ||
+        sqlite3_prepare_v2(conn, deleteSql.c_str(), -1, &remove, nullptr) != SQLITE_OK) {
+        LOG_ERROR("SQLite archive prepare failed: {}", sqlite3_errmsg(conn));
+        sqlite3_finalize(copy);
+        return 0;
+    }
+    for (sqlite3_stmt* stmt : { copy, remove }) {
+        sqlite3_bind_text(stmt, 1, cutoff.data(), static_cast<int>(cutoff.size()), SQLITE_STATIC);
+        sqlite3_bind_int64(stmt, 2, static_cast<sqlite3_int64>(batchSize));
+    }
+
+    size_t moved = 0;
+    for (;;) {
+        if (!execSQLite(conn, "BEGIN IMMEDIATE")) break;
+        size_t rows = 0;
+        bool ok = stepSQLite(conn, copy) && stepSQLite(conn, remove);
+        if (ok) {
+            rows = static_cast<size_t>(sqlite3_changes(conn));
+            ok = execSQLite(conn, "COMMIT");
+        }
+        if (!ok) {
+            execSQLite(conn, "ROLLBACK");
+            break;
+        }
+        moved += rows;
+        if (rows < batchSize) break;
+    }
+
+    sqlite3_finalize(copy);
+    sqlite3_finalize(remove);
+    return moved;
+}
+
+// Other clients write to the shared database between our statements, so each
+// batch locks its rows and names them explicitly
+size_t archiveMySQL(MYSQL* conn, const std::string& cutoff, size_t batchSize) {
+    const std::string select = "SELECT uuid FROM Tasks WHERE is_done = 1 AND completed_at IS NOT NULL "
+        "AND completed_at < '" + cutoff + "' ORDER BY completed_at, uuid LIMIT " + std::to_string(batchSize) + " FOR UPDATE";
+
+    size_t moved = 0;
+    for (;;) {
+        if (!execMySQL(conn, "START TRANSACTION")) break;
+
+        std::string uuids;
+        size_t rows = 0;
+        bool ok = execMySQL(conn, select);
+        if (ok) {
+            MYSQL_RES* res = mysql_store_result(conn);
+            while (MYSQL_ROW row = res ? mysql_fetch_row(res) : nullptr) {
+                unsigned long* lengths = mysql_fetch_lengths(res);
+                std::string escaped(lengths[0] * 2 + 1, '\0');
+                escaped.resize(mysql_real_escape_string(conn, &escaped[0], row[0], lengths[0]));
+                uuids += (rows++ == 0 ? "'" : ", '") + escaped + "'";
+            }
+            if (res) mysql_free_result(res);
+            ok = res != nullptr;
+        }
+
+        if (ok && rows > 0) {
+            const std::string where = "uuid IN (" + uuids + ")";
+            ok = execMySQL(conn, moveSql("REPLACE", "Tasks", "TasksArchive", where)) &&
+                execMySQL(conn, "DELETE FROM Tasks WHERE " + where);
+        }
+        if (!ok || !execMySQL(conn, "COMMIT")) {
+            execMySQL(conn, "ROLLBACK");
+            break;
+        }
+        moved += rows;
+        if (rows < batchSize) break;
+    }
+    return moved;
+}
+
+// One task's row from one tier to the other, in a single transaction
+bool moveTaskRow(int db_id, std::string_view uuid, const char* from, const char* to) {
+    if (db_id < 0 || db_id >= static_cast<int>(allDatabases.size())) return false;
+    const DatabaseConnection& db = allDatabases[db_id];
+
+    if (db.type == DatabaseType::MYSQL) {
+        MYSQL* conn = std::get<MYSQL*>(db.connection);
+        std::string escaped(uuid.size() * 2 + 1, '\0');
+        escaped.resize(mysql_real_escape_string(conn, &escaped[0], uuid.data(), static_cast<unsigned long>(uuid.size())));
+        const std::string where = "uuid = '" + escaped + "'";
+
+        bool ok = execMySQL(conn, "START TRANSACTION") &&
+            execMySQL(conn, moveSql("REPLACE", from, to, where)) &&
+            execMySQL(conn, std::string("DELETE FROM ") + from + " WHERE " + where) &&
+            execMySQL(conn, "COMMIT");
+        if (!ok) execMySQL(conn, "ROLLBACK");
+        return ok;
+    }
+
+    sqlite3* conn = std::get<sqlite3*>(db.connection);
+    const std::string copySql = moveSql("INSERT OR REPLACE", from, to, "uuid = ?1");
+    const std::string deleteSql = std::string("DELETE FROM ") + from + " WHERE uuid = ?1";
+    sqlite3_stmt* copy = nullptr;
+    sqlite3_stmt* remove = nullptr;
+    if (sqlite3_prepare_v2(conn, copySql.c_str(), -1, &copy, nullptr) != SQLITE_OK ||
+        sqlite3_prepare_v2(conn, deleteSql.c_str(), -1, &remove, nullptr) != SQLITE_OK) {
+        LOG_ERROR("SQLite tier move prepare failed: {}", sqlite3_errmsg(conn));
+        sqlite3_finalize(copy);
+        return false;
+    }
+    for (sqlite3_stmt* stmt : { copy, remove }) {
+        sqlite3_bind_text(stmt, 1, uuid.data(), static_cast<int>(uuid.size()), SQLITE_STATIC);
+    }
+
+    bool ok = execSQLite(conn, "BEGIN IMMEDIATE") && stepSQLite(conn, copy) && stepSQLite(conn, remove) &&
+        execSQLite(conn, "COMMIT");
+    if (!ok) execSQLite(conn, "ROLLBACK");
+    sqlite3_finalize(copy);
+    sqlite3_finalize(remove);
+    return ok;
+}
+
+
+} // namespace
+
+size_t archiveCompletedTasks(int db_id, int days, size_t batchSize) {
+    GTD_TRACE_SCOPE("archiveCompletedTasks");
+    if (db_id < 0 || db_id >= static_cast<int>(allDatabases.size()) || days <= 0 || batchSize == 0) return 0;
+
+    // completed_at is local "YYYY-MM-DD HH:MM:SS" text, which compares in date order
+    const std::string cutoff = formatDateTime(localNowSeconds() - static_cast<int64_t>(days) * 86400);
+    const DatabaseConnection& db = allDatabases[db_id];
+    size_t moved = db.type == DatabaseType::MYSQL
+        ? archiveMySQL(std::get<MYSQL*>(db.connection), cutoff, batchSize)
+        : archiveSQLite(std::get<sqlite3*>(db.connection), cutoff, batchSize);
+
+    if (moved > 0) {
+        LOG_INFO("Archived {} tasks completed before {} in DB ID {}", moved, cutoff, db_id);
+    }
+    return moved;
+}
+
+size_t archiveAllDatabases(int days, size_t batchSize) {
+    if (days <= 0) return 0;
+    size_t moved = 0;
+    for (size_t db_id = 0; db_id < allDatabases.size(); ++db_id) {
+        moved += archiveCompletedTasks(static_cast<int>(db_id), days, batchSize);
+    }
+    return moved;
+}
+
+bool restoreArchivedTask(int db_id, std::string_view uuid) {
+    GTD_TRACE_SCOPE("restoreArchivedTask");
+    return moveTaskRow(db_id, uuid, "TasksArchive", "Tasks");
+}
+
+bool archiveTask(int db_id, std::string_view uuid) {
+    GTD_TRACE_SCOPE("archiveTask");
+    return moveTaskRow(db_id, uuid, "Tasks", "TasksArchive");
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+// === Archive tier ===
+// Tasks finished more than a set number of days ago move from Tasks to
+// TasksArchive in the same database (same columns), so a start loads, labels
+// and holds only the active tier. Archived rows are read on demand through
+// TaskQuery::archive when the Done filter asks for done tasks; saving an
+// archived task moves it back to Tasks first.
+
+// Move tasks completed more than `days` days ago, `batchSize` rows per
+// transaction. Returns the number of tasks moved; a failed batch is rolled
+// back and ends the run.
+size_t archiveCompletedTasks(int db_id, int days, size_t batchSize);
+
+// archiveCompletedTasks over every database; days <= 0 turns archiving off
+size_t archiveAllDatabases(int days, size_t batchSize);
+
+// Move one archived task back to Tasks. False if the move failed.
+bool restoreArchivedTask(int db_id, std::string_view uuid);
+
+// Move one task to TasksArchive regardless of its age (reconciliation uses it
+// to match the tier of the other store). False if the move failed.
+bool archiveTask(int db_id, std::string_view uuid);
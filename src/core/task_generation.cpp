@@ -0,0 +1,35 @@
+#include "core/task_generation.h"
+
+#include <new>
+#include <utility>
+
+void* CountingResource::do_allocate(size_t bytes, size_t alignment) {
+    void* p = upstream_->allocate(bytes, alignment);
+    ++stats_.allocations;
+    stats_.bytesAllocated += bytes;
+    stats_.bytesInUse += bytes;
+    return p;
+}
+
+void CountingResource::do_deallocate(void* p, size_t bytes, size_t alignment) {
+    upstream_->deallocate(p, bytes, alignment);
+    ++stats_.deallocations;
+    stats_.bytesInUse -= bytes;
+}
+
+TaskGeneration::TaskGeneration(size_t initialBytes, std::pmr::memory_resource* upstream)
+    : heapCounter_(upstream)
+    , arena_(initialBytes, &heapCounter_)
+    , arenaCounter_(&arena_)
+{
+}
+
+void moveTaskToHeap(Task& task) {
+    if (task.get_allocator().resource() == std::pmr::get_default_resource()) return;
+
+    // Copies allocate from the default resource, and a move keeps it; assigning
+    // would copy back into the arena, so the task is rebuilt instead
+    Task copy(task);
+    task.~Task();
+    ::new (static_cast<void*>(&task)) Task(std::move(copy));
+}
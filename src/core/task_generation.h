@@ -0,0 +1,80 @@
+#pragma once
+
+#include "core/task.h"
+#include "core/task_filter_criteria.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+struct AllocatorStats {
+    uint64_t allocations = 0;
+    uint64_t deallocations = 0;
+    uint64_t bytesAllocated = 0;    // total ever requested
+    uint64_t bytesInUse = 0;        // requested minus released
+};
+
+// Forwards to another resource and counts what passes through.
+// Not thread-safe, like the monotonic arena it usually sits in front of.
+class CountingResource : public std::pmr::memory_resource {
+public:
+    explicit CountingResource(std::pmr::memory_resource* upstream) : upstream_(upstream) {}
+
+    const AllocatorStats& stats() const { return stats_; }
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+    std::pmr::memory_resource* upstream_;
+    AllocatorStats stats_;
+};
+
+// === Task load generations ===
+// One fetch of the task list and the arena its strings live in. Task strings
+// are bump-allocated from a monotonic buffer that grows in large heap blocks,
+// so a load makes a few dozen heap allocations instead of one per string, and
+// destroying the generation hands those blocks back in one go.
+// Memory released into the arena is only reclaimed with the generation, so
+// only the load allocates from it: a task is moved to the heap before it is
+// edited or given its notes (moveTaskToHeap), and later fetches and label
+// refreshes allocate from the heap. The arena is then no larger than the load.
+class TaskGeneration {
+public:
+    static constexpr size_t kInitialArenaBytes = 1 << 20;
+
+    // The arena's blocks come from `upstream`, which must outlive the generation
+    explicit TaskGeneration(size_t initialBytes = kInitialArenaBytes,
+        std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+
+    TaskGeneration(const TaskGeneration&) = delete;
+    TaskGeneration& operator=(const TaskGeneration&) = delete;
+
+    // Pass to fetchTasksFromDatabase so the tasks are built in the arena
+    std::pmr::memory_resource* resource() { return &arenaCounter_; }
+
+    std::vector<Task>& tasks() { return tasks_; }
+
+    // Filter the tasks were fetched with; the canvas starts on it and fetches
+    // whatever a wider filter needs on top
+    const TaskFilterCriteria& loadedFilter() const { return loadedFilter_; }
+    void setLoadedFilter(const TaskFilterCriteria& filter) { loadedFilter_ = filter; }
+
+    // What task strings asked the arena for, and what the arena took from the heap
+    const AllocatorStats& arenaStats() const { return arenaCounter_.stats(); }
+    const AllocatorStats& heapStats() const { return heapCounter_.stats(); }
+
+private:
+    CountingResource heapCounter_;
+    std::pmr::monotonic_buffer_resource arena_;
+    CountingResource arenaCounter_;
+    TaskFilterCriteria loadedFilter_;
+    std::vector<Task> tasks_;   // declared last so it is destroyed before the arena
+};
+
+// Rebuilds the task's strings on the default heap, in place, so it can grow
+// and shrink without touching the arena it was loaded into. The old copy stays
+// in the arena until the generation goes. Does nothing for a task on the heap.
+void moveTaskToHeap(Task& task);
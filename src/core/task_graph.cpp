@@ -0,0 +1,321 @@
+#include "core/task_graph.h"
+#include "core/trace.h"
+
+#include <algorithm>
+#include <iterator>
+
+TaskGraph::Links TaskGraph::resolve(const std::vector<Task>& tasks, const UuidIndex& index, size_t taskIndex) const {
+    const Task& t = tasks[taskIndex];
+    Links links;
+    if (!t.link_from_id.isNil()) links.from = index.find(t.link_from_id);
+    if (!t.link_to_id.isNil()) links.to = index.find(t.link_to_id);
+    if (links.from == taskIndex) links.from = kNone;
+    if (links.to == taskIndex) links.to = kNone;
+    return links;
+}
+
+void TaskGraph::rebuild(const std::vector<Task>& tasks, const UuidIndex& index) {
+    GTD_TRACE_SCOPE("TaskGraph::rebuild");
+    const size_t n = tasks.size();
+    links_.resize(n);
+    done_.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        links_[i] = resolve(tasks, index, i);
+        done_[i] = tasks[i].is_done ? 1 : 0;
+    }
+
+    buildAdjacency();
+
+    openPredecessors_.assign(n, 0);
+    for (size_t i = 0; i < n; ++i) {
+        if (done_[i]) continue;
+        for (uint32_t s : successors(i)) ++openPredecessors_[s];
+    }
+
+    buildOrder();
+}
+
+// Counting sort of the declared links into both CSR directions. Called on
+// every link edit too: it is a few linear passes over flat arrays.
+void TaskGraph::buildAdjacency() {
+    const size_t n = links_.size();
+
+    // Out-edges by source; the same edge may be declared from both ends
+    outOffsets_.assign(n + 1, 0);
+    for (size_t i = 0; i < n; ++i) {
+        if (links_[i].from != kNone) ++outOffsets_[links_[i].from + 1];
+        if (links_[i].to != kNone) ++outOffsets_[i + 1];
+    }
+    for (size_t i = 0; i < n; ++i) outOffsets_[i + 1] += outOffsets_[i];
+
+    outTargets_.resize(outOffsets_[n]);
+    stack_.assign(outOffsets_.begin(), outOffsets_.end() - 1);
+    for (size_t i = 0; i < n; ++i) {
+        const uint32_t self = static_cast<uint32_t>(i);
+        if (links_[i].from != kNone) outTargets_[stack_[links_[i].from]++] = self;
+        if (links_[i].to != kNone) outTargets_[stack_[i]++] = links_[i].to;
+    }
+
+    // Sort and dedupe each (short) run, compacting the array as we go
+    uint32_t write = 0;
+    for (size_t i = 0; i < n; ++i) {
+        auto first = outTargets_.begin() + outOffsets_[i];
+        auto last = outTargets_.begin() + outOffsets_[i + 1];
+        std::sort(first, last);
+        last = std::unique(first, last);
+        outOffsets_[i] = write;
+        write = static_cast<uint32_t>(std::copy(first, last, outTargets_.begin() + write) - outTargets_.begin());
+    }
+    outOffsets_[n] = write;
+    outTargets_.resize(write);
+
+    // In-edges from the out-edges; sources come out ascending per target
+    inOffsets_.assign(n + 1, 0);
+    for (uint32_t t : outTargets_) ++inOffsets_[t + 1];
+    for (size_t i = 0; i < n; ++i) inOffsets_[i + 1] += inOffsets_[i];
+
+    inSources_.resize(outTargets_.size());
+    stack_.assign(inOffsets_.begin(), inOffsets_.end() - 1);
+    for (size_t i = 0; i < n; ++i) {
+        for (uint32_t t : successors(i)) inSources_[stack_[t]++] = static_cast<uint32_t>(i);
+    }
+}
+
+TaskRange TaskGraph::successors(size_t taskIndex) const {
+    return { outTargets_.data() + outOffsets_[taskIndex], outTargets_.data() + outOffsets_[taskIndex + 1] };
+}
+
+TaskRange TaskGraph::predecessors(size_t taskIndex) const {
+    return { inSources_.data() + inOffsets_[taskIndex], inSources_.data() + inOffsets_[taskIndex + 1] };
+}
+
+bool TaskGraph::isCyclic(uint32_t from, uint32_t to) const {
+    return !cyclicEdges_.empty() && std::binary_search(cyclicEdges_.begin(), cyclicEdges_.end(), Edge{ from, to });
+}
+
+// Full order: strongly connected components (iterative Tarjan) find the
+// cycles, then Kahn's algorithm orders everything over the remaining edges
+void TaskGraph::buildOrder() {
+    GTD_TRACE_SCOPE("TaskGraph::buildOrder");
+    const uint32_t n = static_cast<uint32_t>(links_.size());
+
+    std::vector<uint32_t> component(n, kNone);
+    std::vector<uint32_t> componentSize;
+    {
+        std::vector<uint32_t> visitIndex(n, kNone);
+        std::vector<uint32_t> low(n, 0);
+        std::vector<uint8_t> onStack(n, 0);
+        std::vector<uint32_t> sccStack;
+        std::vector<std::pair<uint32_t, uint32_t>> calls;   // node, next out-edge offset
+        uint32_t counter = 0;
+
+        for (uint32_t root = 0; root < n; ++root) {
+            if (visitIndex[root] != kNone) continue;
+            calls.emplace_back(root, outOffsets_[root]);
+            visitIndex[root] = low[root] = counter++;
+            sccStack.push_back(root);
+            onStack[root] = 1;
+
+            while (!calls.empty()) {
+                auto& [v, next] = calls.back();
+                if (next < outOffsets_[v + 1]) {
+                    uint32_t w = outTargets_[next++];
+                    if (visitIndex[w] == kNone) {
+                        visitIndex[w] = low[w] = counter++;
+                        sccStack.push_back(w);
+                        onStack[w] = 1;
+                        calls.emplace_back(w, outOffsets_[w]);
+                    }
+                    else if (onStack[w]) {
+                        low[v] = std::min(low[v], visitIndex[w]);
+                    }
+                    continue;
+                }
+
+                uint32_t done = v;
+                calls.pop_back();
+                if (!calls.empty()) {
+                    uint32_t parent = calls.back().first;
+                    low[parent] = std::min(low[parent], low[done]);
+                }
+                if (low[done] == visitIndex[done]) {
+                    uint32_t id = static_cast<uint32_t>(componentSize.size());
+                    uint32_t size = 0;
+                    uint32_t w;
+                    do {
+                        w = sccStack.back();
+                        sccStack.pop_back();
+                        onStack[w] = 0;
+                        component[w] = id;
+                        ++size;
+                    } while (w != done);
+                    componentSize.push_back(size);
+                }
+            }
+        }
+    }
+
+    inCycle_.assign(n, 0);
+    cyclicEdges_.clear();
+    for (uint32_t v = 0; v < n; ++v) {
+        if (componentSize[component[v]] > 1) inCycle_[v] = 1;
+        for (uint32_t w : successors(v)) {
+            if (component[v] == component[w]) cyclicEdges_.push_back({ v, w });
+        }
+    }
+    // Built in source order, so already sorted for isCyclic()
+
+    std::vector<uint32_t> indegree(n, 0);
+    for (uint32_t v = 0; v < n; ++v) {
+        for (uint32_t w : successors(v)) {
+            if (!isCyclic(v, w)) ++indegree[w];
+        }
+    }
+
+    order_.clear();
+    order_.reserve(n);
+    for (uint32_t v = 0; v < n; ++v) {
+        if (indegree[v] == 0) order_.push_back(v);
+    }
+    for (size_t head = 0; head < order_.size(); ++head) {
+        uint32_t v = order_[head];
+        for (uint32_t w : successors(v)) {
+            if (!isCyclic(v, w) && --indegree[w] == 0) order_.push_back(w);
+        }
+    }
+
+    rank_.assign(n, 0);
+    for (uint32_t r = 0; r < order_.size(); ++r) rank_[order_[r]] = r;
+}
+
+// Pearce-Kelly: only tasks ranked between the edge's ends can be out of order.
+// Collect those reachable from `to` and those reaching `from`, then hand the
+// first group's ranks to the second group and vice versa, keeping each
+// group's internal order. Returns false if the edge closes a cycle.
+bool TaskGraph::addToOrder(uint32_t from, uint32_t to) {
+    const uint32_t lower = rank_[to];
+    const uint32_t upper = rank_[from];
+    if (upper < lower) return true;
+
+    mark_.resize(links_.size(), 0);
+    forward_.clear();
+    backward_.clear();
+    bool cycle = false;
+
+    stack_.assign(1, to);
+    mark_[to] = 1;
+    while (!stack_.empty() && !cycle) {
+        uint32_t v = stack_.back();
+        stack_.pop_back();
+        forward_.push_back(v);
+        for (uint32_t w : successors(v)) {
+            if (w == from) { cycle = true; break; }
+            if (mark_[w] || rank_[w] > upper || isCyclic(v, w)) continue;
+            mark_[w] = 1;
+            stack_.push_back(w);
+        }
+    }
+
+    if (!cycle) {
+        stack_.assign(1, from);
+        mark_[from] = 1;
+        while (!stack_.empty()) {
+            uint32_t v = stack_.back();
+            stack_.pop_back();
+            backward_.push_back(v);
+            for (uint32_t w : predecessors(v)) {
+                if (mark_[w] || rank_[w] < lower || isCyclic(w, v)) continue;
+                mark_[w] = 1;
+                stack_.push_back(w);
+            }
+        }
+    }
+
+    for (uint32_t v : forward_) mark_[v] = 0;
+    for (uint32_t v : backward_) mark_[v] = 0;
+    for (uint32_t v : stack_) mark_[v] = 0;
+    if (cycle) return false;
+
+    auto byRank = [this](uint32_t a, uint32_t b) { return rank_[a] < rank_[b]; };
+    std::sort(forward_.begin(), forward_.end(), byRank);
+    std::sort(backward_.begin(), backward_.end(), byRank);
+
+    stack_.clear();
+    for (uint32_t v : backward_) stack_.push_back(rank_[v]);
+    for (uint32_t v : forward_) stack_.push_back(rank_[v]);
+    std::sort(stack_.begin(), stack_.end());
+
+    size_t slot = 0;
+    for (uint32_t v : backward_) rank_[v] = stack_[slot++];
+    for (uint32_t v : forward_) rank_[v] = stack_[slot++];
+    for (uint32_t r : stack_) order_[r] = kNone;
+    for (uint32_t v : backward_) order_[rank_[v]] = v;
+    for (uint32_t v : forward_) order_[rank_[v]] = v;
+    return true;
+}
+
+void TaskGraph::collectIncident(size_t taskIndex, std::vector<Edge>& out) const {
+    const uint32_t self = static_cast<uint32_t>(taskIndex);
+    for (uint32_t s : successors(taskIndex)) out.push_back({ self, s });
+    for (uint32_t p : predecessors(taskIndex)) out.push_back({ p, self });
+    std::sort(out.begin(), out.end());
+}
+
+const std::vector<size_t>& TaskGraph::updateTask(const std::vector<Task>& tasks, const UuidIndex& index, size_t taskIndex) {
+    changed_.clear();
+    const Links links = resolve(tasks, index, taskIndex);
+    const bool done = tasks[taskIndex].is_done;
+    const bool linksChanged = links.from != links_[taskIndex].from || links.to != links_[taskIndex].to;
+    const bool doneChanged = done != (done_[taskIndex] != 0);
+    if (!linksChanged && !doneChanged) return changed_;
+
+    // Only the task, its successors and the ends of its old and new links can change state
+    std::vector<size_t> candidates = { taskIndex };
+    for (uint32_t s : successors(taskIndex)) candidates.push_back(s);
+    for (uint32_t end : { links_[taskIndex].from, links_[taskIndex].to, links.from, links.to }) {
+        if (end != kNone) candidates.push_back(end);
+    }
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+    std::vector<uint8_t> wasNext;
+    for (size_t c : candidates) wasNext.push_back(isNextAction(c) ? 1 : 0);
+
+    if (doneChanged) {
+        for (uint32_t s : successors(taskIndex)) {
+            if (done) --openPredecessors_[s];
+            else ++openPredecessors_[s];
+        }
+        done_[taskIndex] = done ? 1 : 0;
+    }
+
+    if (linksChanged) {
+        std::vector<Edge> before, after, removed, added;
+        collectIncident(taskIndex, before);
+        links_[taskIndex] = links;
+        buildAdjacency();
+        collectIncident(taskIndex, after);
+        std::set_difference(before.begin(), before.end(), after.begin(), after.end(), std::back_inserter(removed));
+        std::set_difference(after.begin(), after.end(), before.begin(), before.end(), std::back_inserter(added));
+
+        for (const Edge& e : removed) {
+            if (!done_[e.from]) --openPredecessors_[e.to];
+        }
+        for (const Edge& e : added) {
+            if (!done_[e.from]) ++openPredecessors_[e.to];
+        }
+
+        // Removing an edge never breaks a valid order. While cycles exist the
+        // bounded search below cannot follow their edges, so re-derive the
+        // whole order then (an edit may join, split or break a cycle).
+        bool rebuildOrder = !cyclicEdges_.empty() && (!removed.empty() || !added.empty());
+        for (size_t k = 0; k < added.size() && !rebuildOrder; ++k) {
+            rebuildOrder = !addToOrder(added[k].from, added[k].to);
+        }
+        if (rebuildOrder) buildOrder();
+    }
+
+    for (size_t k = 0; k < candidates.size(); ++k) {
+        if ((isNextAction(candidates[k]) ? 1 : 0) != wasNext[k]) changed_.push_back(candidates[k]);
+    }
+    return changed_;
+}
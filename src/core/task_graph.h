@@ -0,0 +1,99 @@
+#pragma once
+
+#include "core/task.h"
+#include "core/uuid_index.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Task indexes adjacent to one task; a slice of a CSR array
+struct TaskRange {
+    const uint32_t* first = nullptr;
+    const uint32_t* last = nullptr;
+
+    const uint32_t* begin() const { return first; }
+    const uint32_t* end() const { return last; }
+    size_t size() const { return static_cast<size_t>(last - first); }
+    bool empty() const { return first == last; }
+};
+
+// === Task dependency graph ===
+// Edges come from the link fields: link_from = P means P has to be done before
+// the task (P -> task), link_to = S means the task comes before S (task -> S).
+// Links to tasks that are not loaded, or to the task itself, are ignored.
+//
+// Adjacency is kept as CSR arrays (one offsets array and one flat target array
+// per direction). A topological order is kept up to date as links change:
+// added edges reorder only the tasks between their two ends (Pearce-Kelly).
+// An edge that would close a cycle is kept for display and for the next-action
+// counts but left out of the order, and the tasks on the cycle are flagged.
+class TaskGraph {
+public:
+    static constexpr uint32_t kNone = UINT32_MAX;
+
+    void rebuild(const std::vector<Task>& tasks, const UuidIndex& index);
+
+    // Re-read one task's links and done flag after an edit. Returns every task
+    // whose isNextAction() answer changed, the edited task included if it did.
+    const std::vector<size_t>& updateTask(const std::vector<Task>& tasks, const UuidIndex& index, size_t taskIndex);
+
+    // Open and every predecessor done (a task without predecessors included)
+    bool isNextAction(size_t taskIndex) const { return !done_[taskIndex] && openPredecessors_[taskIndex] == 0; }
+    // Open and waiting on at least one open predecessor
+    bool blocked(size_t taskIndex) const { return !done_[taskIndex] && openPredecessors_[taskIndex] > 0; }
+    bool inCycle(size_t taskIndex) const { return inCycle_[taskIndex] != 0; }
+    // The edge closes a cycle and is left out of the order
+    bool isCyclic(uint32_t from, uint32_t to) const;
+
+    TaskRange successors(size_t taskIndex) const;
+    TaskRange predecessors(size_t taskIndex) const;
+
+    // Position in the topological order; predecessors rank lower unless the
+    // edge between them closes a cycle
+    uint32_t rank(size_t taskIndex) const { return rank_[taskIndex]; }
+    const std::vector<uint32_t>& order() const { return order_; }
+
+    size_t edgeCount() const { return outTargets_.size(); }
+    size_t cyclicEdgeCount() const { return cyclicEdges_.size(); }
+
+private:
+    struct Links {
+        uint32_t from = kNone;  // resolved link_from
+        uint32_t to = kNone;    // resolved link_to
+    };
+    struct Edge {
+        uint32_t from;
+        uint32_t to;
+        bool operator==(const Edge& other) const { return from == other.from && to == other.to; }
+        bool operator<(const Edge& other) const { return from != other.from ? from < other.from : to < other.to; }
+    };
+
+    Links resolve(const std::vector<Task>& tasks, const UuidIndex& index, size_t taskIndex) const;
+    void buildAdjacency();
+    void buildOrder();
+    bool addToOrder(uint32_t from, uint32_t to);
+    void collectIncident(size_t taskIndex, std::vector<Edge>& out) const;
+
+    std::vector<Links> links_;              // per task, as declared
+    std::vector<uint8_t> done_;
+    std::vector<uint32_t> openPredecessors_;
+
+    // CSR over the distinct edges
+    std::vector<uint32_t> outOffsets_;      // size n + 1
+    std::vector<uint32_t> outTargets_;
+    std::vector<uint32_t> inOffsets_;
+    std::vector<uint32_t> inSources_;
+
+    std::vector<uint32_t> rank_;
+    std::vector<uint32_t> order_;
+    std::vector<Edge> cyclicEdges_;         // sorted; left out of the order
+    std::vector<uint8_t> inCycle_;
+
+    // Scratch
+    std::vector<uint32_t> forward_;
+    std::vector<uint32_t> backward_;
+    std::vector<uint32_t> stack_;
+    std::vector<uint8_t> mark_;
+    std::vector<size_t> changed_;
+};
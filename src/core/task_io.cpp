@@ -0,0 +1,887 @@
+#include "core/task_io.h"
+#include "core/database.h"
+#include "core/database_registry.h"
+#include "core/schema_migrations.h"
+#include "core/trace.h"
+#include "core/logger.h"
+
+#include <mysql.h>
+#include <sqlite3.h>
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// Rows per transaction on import
+constexpr uint64_t kImportBatchRows = 50000;
+// Rejected rows beyond this are only counted
+constexpr uint64_t kMaxRowWarnings = 10;
+
+struct TableSpec {
+    const char* name;
+    const char* key;
+    std::vector<const char*> columns;
+};
+
+// Lookup tables come first so an import fills them before the tasks that reference them
+const std::vector<TableSpec>& tableSpecs() {
+    static const std::vector<TableSpec> specs = {
+        { "Projects",     "uuid", { "uuid", "name" } },
+        { "Contexts",     "id",   { "id", "name" } },
+        { "Topics",       "id",   { "id", "name" } },
+        { "People",       "id",   { "id", "name" } },
+        { "Categories",   "id",   { "id", "name" } },
+        { "Tasks",        "uuid", std::vector<const char*>(std::begin(kTaskColumns), std::end(kTaskColumns)) },
+        { "TasksArchive", "uuid", std::vector<const char*>(std::begin(kTaskColumns), std::end(kTaskColumns)) },
+    };
+    return specs;
+}
+
+int findTableSpec(std::string_view name) {
+    const auto& specs = tableSpecs();
+    for (size_t i = 0; i < specs.size(); ++i) {
+        if (name == specs[i].name) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+bool tableLivesIn(const TableSpec& spec, int db_id) {
+    // Both task tiers live in every database
+    if (std::string_view(spec.name) == "Tasks" || std::string_view(spec.name) == "TasksArchive") return true;
+    auto mapped = tableToDatabaseIds.find(spec.name);
+    return mapped != tableToDatabaseIds.end() &&
+        std::find(mapped->second.begin(), mapped->second.end(), db_id) != mapped->second.end();
+}
+
+std::string selectSql(const TableSpec& spec) {
+    std::string sql = "SELECT ";
+    for (size_t i = 0; i < spec.columns.size(); ++i) {
+        if (i) sql += ", ";
+        sql += spec.columns[i];
+    }
+    return sql + " FROM " + spec.name;
+}
+
+// Writes only the columns in `columns` (bit i for spec.columns[i]), which must
+// include the key: a new row gets the defaults for the rest, an existing row
+// keeps them.
+std::string upsertSql(const TableSpec& spec, uint64_t columns, bool mysql) {
+    std::string names, placeholders, updates;
+    for (size_t i = 0; i < spec.columns.size(); ++i) {
+        if (!(columns >> i & 1)) continue;
+        const char* column = spec.columns[i];
+        if (!names.empty()) {
+            names += ", ";
+            placeholders += ", ";
+        }
+        names += column;
+        placeholders += "?";
+
+        if (std::string_view(column) == spec.key) continue;
+        if (!updates.empty()) updates += ", ";
+        updates += std::string(column) + (mysql ? " = new." : " = excluded.") + column;
+    }
+
+    std::string sql = "INSERT INTO " + std::string(spec.name) + " (" + names + ") VALUES (" + placeholders + ") ";
+    if (mysql) {
+        // A key-only row changes nothing, but ON DUPLICATE KEY UPDATE needs an assignment
+        if (updates.empty()) updates = std::string(spec.key) + " = new." + spec.key;
+        return sql + "AS new ON DUPLICATE KEY UPDATE " + updates;
+    }
+    return sql + "ON CONFLICT(" + spec.key + ") " + (updates.empty() ? "DO NOTHING" : "DO UPDATE SET " + updates);
+}
+
+// === Export ===
+
+void appendJsonString(std::string& out, const char* s, size_t length) {
+    static const char kHex[] = "0123456789abcdef";
+    out += '"';
+    for (size_t i = 0; i < length; ++i) {
+        unsigned char c = static_cast<unsigned char>(s[i]);
+        switch (c) {
+        case '"':  out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\n': out += "\\n"; break;
+        case '\r': out += "\\r"; break;
+        case '\t': out += "\\t"; break;
+        default:
+            if (c < 0x20) {
+                out += "\\u00";
+                out += kHex[c >> 4];
+                out += kHex[c & 0xF];
+            }
+            else {
+                out += static_cast<char>(c);
+            }
+        }
+    }
+    out += '"';
+}
+
+void beginRow(std::string& line, const TableSpec& spec) {
+    line.clear();
+    line += "{\"table\":\"";
+    line += spec.name;
+    line += "\",\"row\":{";
+}
+
+void appendKey(std::string& line, const char* column, bool first) {
+    if (!first) line += ',';
+    appendJsonString(line, column, std::strlen(column));
+    line += ':';
+}
+
+bool exportSQLiteTable(sqlite3* conn, const TableSpec& spec, std::ofstream& out, uint64_t& rows) {
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(conn, selectSql(spec).c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+        LOG_ERROR("Export of {} failed: {}", spec.name, sqlite3_errmsg(conn));
+        return false;
+    }
+
+    std::string line;
+    char number[32];
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        beginRow(line, spec);
+        for (size_t i = 0; i < spec.columns.size(); ++i) {
+            int col = static_cast<int>(i);
+            appendKey(line, spec.columns[i], i == 0);
+            switch (sqlite3_column_type(stmt, col)) {
+            case SQLITE_NULL:
+                line += "null";
+                break;
+            case SQLITE_INTEGER:
+                std::snprintf(number, sizeof(number), "%lld", static_cast<long long>(sqlite3_column_int64(stmt, col)));
+                line += number;
+                break;
+            case SQLITE_FLOAT:
+                std::snprintf(number, sizeof(number), "%.17g", sqlite3_column_double(stmt, col));
+                line += number;
+                break;
+            default:
+                appendJsonString(line, reinterpret_cast<const char*>(sqlite3_column_text(stmt, col)),
+                    static_cast<size_t>(sqlite3_column_bytes(stmt, col)));
+            }
+        }
+        line += "}}\n";
+        out.write(line.data(), static_cast<std::streamsize>(line.size()));
+        ++rows;
+    }
+
+    bool ok = rc == SQLITE_DONE;
+    if (!ok) LOG_ERROR("Export of {} stopped: {}", spec.name, sqlite3_errmsg(conn));
+    sqlite3_finalize(stmt);
+    return ok;
+}
+
+bool exportMySQLTable(MYSQL* conn, const TableSpec& spec, std::ofstream& out, uint64_t& rows) {
+    if (mysql_query(conn, selectSql(spec).c_str()) != 0) {
+        LOG_ERROR("Export of {} failed: {}", spec.name, mysql_error(conn));
+        return false;
+    }
+
+    // Unbuffered: rows come off the wire one at a time instead of the whole result
+    MYSQL_RES* res = mysql_use_result(conn);
+    if (!res) {
+        LOG_ERROR("Export of {} failed: {}", spec.name, mysql_error(conn));
+        return false;
+    }
+
+    MYSQL_FIELD* fields = mysql_fetch_fields(res);
+    std::string line;
+    MYSQL_ROW row;
+    while ((row = mysql_fetch_row(res))) {
+        unsigned long* lengths = mysql_fetch_lengths(res);
+        beginRow(line, spec);
+        for (size_t i = 0; i < spec.columns.size(); ++i) {
+            appendKey(line, spec.columns[i], i == 0);
+            if (!row[i]) line += "null";
+            else if (IS_NUM(fields[i].type)) line.append(row[i], lengths[i]);
+            else appendJsonString(line, row[i], lengths[i]);
+        }
+        line += "}}\n";
+        out.write(line.data(), static_cast<std::streamsize>(line.size()));
+        ++rows;
+    }
+
+    bool ok = mysql_errno(conn) == 0;
+    if (!ok) LOG_ERROR("Export of {} stopped: {}", spec.name, mysql_error(conn));
+    mysql_free_result(res);
+    return ok;
+}
+
+// === Import ===
+
+struct FieldValue {
+    enum class Kind { Null, Integer, Real, Text };
+    Kind kind = Kind::Null;
+    int64_t integer = 0;
+    double real = 0.0;
+    std::string text;
+};
+
+// One parsed line: a value slot per column of its table, filled in place, and
+// a bit per column the line named. Slots are reused from line to line so
+// steady-state parsing does not allocate.
+struct ImportRecord {
+    int tableIndex = -1;    // into tableSpecs()
+    uint64_t columns = 0;   // bit i set if the line named spec.columns[i]
+    std::vector<FieldValue> values;
+    uint64_t line = 0;
+};
+
+static_assert(kTaskColumnCount <= 64, "ImportRecord::columns has one bit per column");
+
+// Accepts exactly {"table": "...", "row": {column: scalar, ...}}, either key
+// first, and fills the record's column slots straight from the line. Unknown
+// top-level keys with scalar values and row columns the table does not have
+// are ignored. A general JSON parser building keys and values for every field
+// took most of the import time.
+class LineParser {
+public:
+    // nullptr if the line was parsed, otherwise why it was not
+    const char* parse(std::string_view line, ImportRecord& record) {
+        static const char* const kNotARow = "not a {\"table\", \"row\"} object";
+        p_ = line.data();
+        end_ = p_ + line.size();
+        record.tableIndex = -1;
+        record.columns = 0;
+        const char* row = nullptr;
+
+        skipSpace();
+        if (!consume('{')) return kNotARow;
+        skipSpace();
+        if (!consume('}')) {
+            for (;;) {
+                skipSpace();
+                if (!parseString(key_)) return kNotARow;
+                skipSpace();
+                if (!consume(':')) return kNotARow;
+                skipSpace();
+
+                if (key_ == "table") {
+                    if (!parseString(value_.text)) return kNotARow;
+                    if ((record.tableIndex = findTableSpec(value_.text)) < 0) return "unknown table";
+                }
+                else if (key_ == "row") {
+                    // Before "table" the columns are unknown: check the row now, read it once the table is known
+                    row = p_;
+                    if (!parseRow(record.tableIndex < 0 ? nullptr : &record)) return kNotARow;
+                }
+                else if (!parseScalar(value_)) {
+                    return kNotARow;
+                }
+
+                skipSpace();
+                if (consume(',')) continue;
+                if (consume('}')) break;
+                return kNotARow;
+            }
+        }
+        skipSpace();
+        if (p_ != end_) return kNotARow;
+
+        if (record.tableIndex < 0) return "unknown table";
+        if (row && record.columns == 0) {
+            p_ = row;
+            parseRow(&record);
+        }
+        const TableSpec& spec = tableSpecs()[record.tableIndex];
+        if (!(record.columns >> columnIndex(spec, spec.key) & 1)) return "row has no key column";
+        return nullptr;
+    }
+
+private:
+    static bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+    void skipSpace() {
+        while (p_ != end_ && (*p_ == ' ' || *p_ == '\t' || *p_ == '\n' || *p_ == '\r')) ++p_;
+    }
+
+    bool consume(char c) {
+        if (p_ == end_ || *p_ != c) return false;
+        ++p_;
+        return true;
+    }
+
+    bool literal(std::string_view word) {
+        if (static_cast<size_t>(end_ - p_) < word.size() || std::string_view(p_, word.size()) != word) return false;
+        p_ += word.size();
+        return true;
+    }
+
+    bool digits() {
+        const char* start = p_;
+        while (p_ != end_ && isDigit(*p_)) ++p_;
+        return p_ != start;
+    }
+
+    // Columns are exported in schema order, so the one after the previous is tried first
+    static int columnIndex(const TableSpec& spec, std::string_view name, size_t hint = 0) {
+        if (hint < spec.columns.size() && name == spec.columns[hint]) return static_cast<int>(hint);
+        for (size_t i = 0; i < spec.columns.size(); ++i) {
+            if (name == spec.columns[i]) return static_cast<int>(i);
+        }
+        return -1;
+    }
+
+    // With no record the row is only checked
+    bool parseRow(ImportRecord* record) {
+        if (!consume('{')) return false;
+        const TableSpec* spec = record ? &tableSpecs()[record->tableIndex] : nullptr;
+        if (spec) {
+            record->columns = 0;
+            if (record->values.size() < spec->columns.size()) record->values.resize(spec->columns.size());
+        }
+
+        skipSpace();
+        if (consume('}')) return true;
+        size_t hint = 0;
+        for (;;) {
+            skipSpace();
+            if (!parseString(key_)) return false;
+            skipSpace();
+            if (!consume(':')) return false;
+            skipSpace();
+
+            FieldValue* slot = &value_;
+            int column = spec ? columnIndex(*spec, key_, hint) : -1;
+            if (column >= 0) {
+                slot = &record->values[column];
+                record->columns |= uint64_t(1) << column;
+                hint = column + 1;
+            }
+            if (!parseScalar(*slot)) return false;
+
+            skipSpace();
+            if (consume(',')) continue;
+            return consume('}');
+        }
+    }
+
+    bool parseScalar(FieldValue& value) {
+        if (p_ == end_) return false;
+        switch (*p_) {
+        case '"':
+            value.kind = FieldValue::Kind::Text;
+            return parseString(value.text);
+        case 'n':
+            value.kind = FieldValue::Kind::Null;
+            return literal("null");
+        case 't':
+            value.kind = FieldValue::Kind::Integer;
+            value.integer = 1;
+            return literal("true");
+        case 'f':
+            value.kind = FieldValue::Kind::Integer;
+            value.integer = 0;
+            return literal("false");
+        default:
+            return parseNumber(value);
+        }
+    }
+
+    bool parseNumber(FieldValue& value) {
+        const char* start = p_;
+        bool integral = true;
+        consume('-');
+        if (p_ == end_ || !isDigit(*p_)) return false;
+        if (!consume('0')) digits();
+        if (consume('.')) {
+            integral = false;
+            if (!digits()) return false;
+        }
+        if (consume('e') || consume('E')) {
+            integral = false;
+            if (!consume('+')) consume('-');
+            if (!digits()) return false;
+        }
+
+        if (integral) {
+            value.kind = FieldValue::Kind::Integer;
+            if (std::from_chars(start, p_, value.integer).ec == std::errc()) return true;
+            if (*start != '-') {
+                // Past INT64_MAX: clamped, as SQLite has no wider integer
+                value.integer = std::numeric_limits<int64_t>::max();
+                return true;
+            }
+        }
+        value.kind = FieldValue::Kind::Real;
+        return std::from_chars(start, p_, value.real).ec == std::errc();
+    }
+
+    bool parseString(std::string& out) {
+        if (!consume('"')) return false;
+        out.clear();
+        for (;;) {
+            const char* run = p_;
+            while (p_ != end_ && *p_ != '"' && *p_ != '\\' && static_cast<unsigned char>(*p_) >= 0x20) ++p_;
+            out.append(run, p_);
+            if (p_ == end_) return false;
+
+            char c = *p_++;
+            if (c == '"') return true;
+            if (c != '\\' || p_ == end_) return false;     // raw control character, or cut short
+            switch (*p_++) {
+            case '"':  out += '"'; break;
+            case '\\': out += '\\'; break;
+            case '/':  out += '/'; break;
+            case 'b':  out += '\b'; break;
+            case 'f':  out += '\f'; break;
+            case 'n':  out += '\n'; break;
+            case 'r':  out += '\r'; break;
+            case 't':  out += '\t'; break;
+            case 'u':
+                if (!parseCodePoint(out)) return false;
+                break;
+            default:
+                return false;
+            }
+        }
+    }
+
+    bool parseHex4(uint32_t& value) {
+        if (end_ - p_ < 4) return false;
+        value = 0;
+        for (int i = 0; i < 4; ++i) {
+            char c = *p_++;
+            value <<= 4;
+            if (isDigit(c)) value |= c - '0';
+            else if (c >= 'a' && c <= 'f') value |= c - 'a' + 10;
+            else if (c >= 'A' && c <= 'F') value |= c - 'A' + 10;
+            else return false;
+        }
+        return true;
+    }
+
+    // After "\u": one code point, or a surrogate pair, appended as UTF-8
+    bool parseCodePoint(std::string& out) {
+        uint32_t cp;
+        if (!parseHex4(cp)) return false;
+        if (cp >= 0xDC00 && cp <= 0xDFFF) return false;
+        if (cp >= 0xD800 && cp <= 0xDBFF) {
+            uint32_t low;
+            if (!literal("\\u") || !parseHex4(low) || low < 0xDC00 || low > 0xDFFF) return false;
+            cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+        }
+
+        if (cp < 0x80) {
+            out += static_cast<char>(cp);
+        }
+        else if (cp < 0x800) {
+            out += static_cast<char>(0xC0 | (cp >> 6));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+        }
+        else if (cp < 0x10000) {
+            out += static_cast<char>(0xE0 | (cp >> 12));
+            out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+        }
+        else {
+            out += static_cast<char>(0xF0 | (cp >> 18));
+            out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+        }
+        return true;
+    }
+
+    const char* p_ = nullptr;
+    const char* end_ = nullptr;
+    std::string key_;
+    FieldValue value_;      // top-level values and columns that are not kept
+};
+
+class SQLiteImporter {
+public:
+    explicit SQLiteImporter(sqlite3* conn)
+        : conn_(conn)
+    {
+    }
+
+    ~SQLiteImporter() {
+        for (auto& entry : statements_) sqlite3_finalize(entry.second);
+    }
+
+    bool begin() { return exec("BEGIN"); }
+    bool commit() { return exec("COMMIT"); }
+    void rollback() { exec("ROLLBACK"); }
+    const char* error() const { return sqlite3_errmsg(conn_); }
+
+    // false if the table is missing in this database or the row was rejected
+    bool insert(const ImportRecord& record) {
+        sqlite3_stmt* stmt = statement(record.tableIndex, record.columns);
+        if (!stmt) return false;
+
+        const TableSpec& spec = tableSpecs()[record.tableIndex];
+        int index = 0;
+        for (size_t i = 0; i < spec.columns.size(); ++i) {
+            if (!(record.columns >> i & 1)) continue;
+            const FieldValue& field = record.values[i];
+            ++index;
+            if (field.kind == FieldValue::Kind::Null) sqlite3_bind_null(stmt, index);
+            else if (field.kind == FieldValue::Kind::Integer) sqlite3_bind_int64(stmt, index, field.integer);
+            else if (field.kind == FieldValue::Kind::Real) sqlite3_bind_double(stmt, index, field.real);
+            else sqlite3_bind_text(stmt, index, field.text.data(), static_cast<int>(field.text.size()), SQLITE_STATIC);
+        }
+
+        bool ok = sqlite3_step(stmt) == SQLITE_DONE;
+        sqlite3_reset(stmt);
+        return ok;
+    }
+
+private:
+    bool exec(const char* sql) {
+        return sqlite3_exec(conn_, sql, nullptr, nullptr, nullptr) == SQLITE_OK;
+    }
+
+    // One statement per table and set of columns; a failed prepare is remembered as nullptr
+    sqlite3_stmt* statement(int table, uint64_t columns) {
+        auto [entry, added] = statements_.try_emplace({ table, columns }, nullptr);
+        if (!added) return entry->second;
+        const TableSpec& spec = tableSpecs()[table];
+        if (sqlite3_prepare_v2(conn_, upsertSql(spec, columns, false).c_str(), -1, &entry->second, nullptr) != SQLITE_OK) {
+            LOG_WARN("Skipping {} rows: {}", spec.name, sqlite3_errmsg(conn_));
+        }
+        return entry->second;
+    }
+
+    sqlite3* conn_;
+    std::map<std::pair<int, uint64_t>, sqlite3_stmt*> statements_;
+};
+
+class MySQLImporter {
+public:
+    explicit MySQLImporter(MYSQL* conn)
+        : conn_(conn)
+    {
+    }
+
+    ~MySQLImporter() {
+        for (auto& entry : statements_) {
+            if (entry.second) mysql_stmt_close(entry.second);
+        }
+    }
+
+    bool begin() { return mysql_query(conn_, "START TRANSACTION") == 0; }
+    bool commit() { return mysql_query(conn_, "COMMIT") == 0; }
+    void rollback() { mysql_query(conn_, "ROLLBACK"); }
+    const char* error() const { return mysql_error(conn_); }
+
+    bool insert(const ImportRecord& record) {
+        MYSQL_STMT* stmt = statement(record.tableIndex, record.columns);
+        if (!stmt) return false;
+
+        const TableSpec& spec = tableSpecs()[record.tableIndex];
+        binds_.clear();
+        for (size_t i = 0; i < spec.columns.size(); ++i) {
+            if (!(record.columns >> i & 1)) continue;
+            const FieldValue& field = record.values[i];
+            MYSQL_BIND& bind = binds_.emplace_back();
+            if (field.kind == FieldValue::Kind::Null) {
+                bind.buffer_type = MYSQL_TYPE_NULL;
+            }
+            else if (field.kind == FieldValue::Kind::Integer) {
+                bind.buffer_type = MYSQL_TYPE_LONGLONG;
+                bind.buffer = const_cast<int64_t*>(&field.integer);
+            }
+            else if (field.kind == FieldValue::Kind::Real) {
+                bind.buffer_type = MYSQL_TYPE_DOUBLE;
+                bind.buffer = const_cast<double*>(&field.real);
+            }
+            else {
+                bind.buffer_type = MYSQL_TYPE_STRING;
+                bind.buffer = const_cast<char*>(field.text.data());
+                bind.buffer_length = static_cast<unsigned long>(field.text.size());
+            }
+        }
+
+        return mysql_stmt_bind_param(stmt, binds_.data()) == 0 && mysql_stmt_execute(stmt) == 0;
+    }
+
+private:
+    MYSQL_STMT* statement(int table, uint64_t columns) {
+        auto [entry, added] = statements_.try_emplace({ table, columns }, nullptr);
+        if (!added) return entry->second;
+        const TableSpec& spec = tableSpecs()[table];
+        std::string sql = upsertSql(spec, columns, true);
+
+        MYSQL_STMT* stmt = mysql_stmt_init(conn_);
+        if (!stmt || mysql_stmt_prepare(stmt, sql.c_str(), static_cast<unsigned long>(sql.size())) != 0) {
+            LOG_WARN("Skipping {} rows: {}", spec.name, stmt ? mysql_stmt_error(stmt) : mysql_error(conn_));
+            if (stmt) mysql_stmt_close(stmt);
+            return nullptr;
+        }
+        entry->second = stmt;
+        return stmt;
+    }
+
+    MYSQL* conn_;
+    std::map<std::pair<int, uint64_t>, MYSQL_STMT*> statements_;
+    std::vector<MYSQL_BIND> binds_;
+};
+
+// A batch of parsed rows handed from the parse thread to the inserter
+struct ParsedBatch {
+    std::vector<ImportRecord> records;
+    size_t count = 0;
+};
+
+// Reads and parses lines on its own thread, a few batches ahead of the inserter.
+// Only kPipelineDepth batches ever exist and they are recycled, so memory stays
+// flat however long the file is.
+class ParsePipeline {
+public:
+    explicit ParsePipeline(std::ifstream& in)
+        : in_(in)
+    {
+        for (auto& batch : batches_) {
+            batch = std::make_unique<ParsedBatch>();
+            free_.push_back(batch.get());
+        }
+        thread_ = std::thread(&ParsePipeline::run, this);
+    }
+
+    ~ParsePipeline() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        thread_.join();
+    }
+
+    // Next batch in file order, or nullptr once the input is exhausted
+    ParsedBatch* next() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        wake_.wait(lock, [this] { return !ready_.empty() || finished_; });
+        if (ready_.empty()) return nullptr;
+        ParsedBatch* batch = ready_.front();
+        ready_.pop_front();
+        return batch;
+    }
+
+    void recycle(ParsedBatch* batch) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            free_.push_back(batch);
+        }
+        wake_.notify_all();
+    }
+
+    // Valid after next() returned nullptr
+    uint64_t malformed() const { return malformed_; }
+
+private:
+    static constexpr size_t kPipelineDepth = 4;
+    static constexpr size_t kBatchRows = 2048;
+
+    void run() {
+        LineParser parser;
+        std::string line;
+        uint64_t lineNumber = 0;
+        bool eof = false;
+
+        while (!eof) {
+            ParsedBatch* batch;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                wake_.wait(lock, [this] { return !free_.empty() || stopping_; });
+                if (stopping_) return;
+                batch = free_.front();
+                free_.pop_front();
+            }
+
+            batch->count = 0;
+            while (batch->count < kBatchRows) {
+                if (!std::getline(in_, line)) {
+                    eof = true;
+                    break;
+                }
+                ++lineNumber;
+                if (line.empty() || line == "\r") continue;
+
+                if (batch->count == batch->records.size()) batch->records.emplace_back();
+                ImportRecord& record = batch->records[batch->count];
+                if (const char* reason = parser.parse(line, record)) {
+                    if (++malformed_ <= kMaxRowWarnings) LOG_WARN("Import line {} skipped: {}", lineNumber, reason);
+                    continue;
+                }
+                record.line = lineNumber;
+                ++batch->count;
+            }
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            ready_.push_back(batch);
+            finished_ = eof;
+            wake_.notify_all();
+        }
+    }
+
+    std::ifstream& in_;
+    std::unique_ptr<ParsedBatch> batches_[kPipelineDepth];
+    std::deque<ParsedBatch*> free_;
+    std::deque<ParsedBatch*> ready_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    bool stopping_ = false;
+    bool finished_ = false;
+    uint64_t malformed_ = 0;
+    std::thread thread_;
+};
+
+template <typename Importer>
+bool importLines(Importer& importer, std::ifstream& in, TaskIoStats& stats) {
+    uint64_t inBatch = 0;
+    uint64_t warnings = 0;
+
+    if (!importer.begin()) {
+        LOG_ERROR("Import could not start a transaction: {}", importer.error());
+        return false;
+    }
+
+    ParsePipeline pipeline(in);
+    while (ParsedBatch* batch = pipeline.next()) {
+        for (size_t i = 0; i < batch->count; ++i) {
+            const ImportRecord& record = batch->records[i];
+            if (!importer.insert(record)) {
+                ++stats.skipped;
+                if (++warnings <= kMaxRowWarnings) LOG_WARN("Import line {} skipped: {}", record.line, importer.error());
+                continue;
+            }
+            ++stats.rows;
+
+            if (++inBatch == kImportBatchRows) {
+                if (!importer.commit() || !importer.begin()) {
+                    LOG_ERROR("Import commit failed after {} rows: {}", stats.rows, importer.error());
+                    importer.rollback();
+                    return false;
+                }
+                inBatch = 0;
+            }
+        }
+        pipeline.recycle(batch);
+    }
+    stats.skipped += pipeline.malformed();
+
+    if (!importer.commit()) {
+        LOG_ERROR("Import commit failed: {}", importer.error());
+        importer.rollback();
+        return false;
+    }
+    return true;
+}
+
+bool sqliteTableIsEmpty(sqlite3* conn, const char* table) {
+    std::string sql = std::string("SELECT EXISTS (SELECT 1 FROM ") + table + ")";
+    sqlite3_stmt* stmt = nullptr;
+    bool empty = false;
+    if (sqlite3_prepare_v2(conn, sql.c_str(), -1, &stmt, nullptr) == SQLITE_OK) {
+        empty = sqlite3_step(stmt) == SQLITE_ROW && sqlite3_column_int(stmt, 0) == 0;
+        sqlite3_finalize(stmt);
+    }
+    return empty;
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+bool exportDatabaseToJsonl(int db_id, const std::string& path, TaskIoStats* stats) {
+    GTD_TRACE_SCOPE("exportDatabaseToJsonl");
+    if (db_id < 0 || db_id >= static_cast<int>(allDatabases.size())) {
+        LOG_ERROR("Export: no database with ID {}", db_id);
+        return false;
+    }
+
+    std::ofstream out(path, std::ios::binary);
+    if (!out) {
+        LOG_ERROR("Export: cannot write {}", path);
+        return false;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    const DatabaseConnection& db = allDatabases[db_id];
+    TaskIoStats result;
+    bool ok = true;
+
+    for (const TableSpec& spec : tableSpecs()) {
+        if (!tableLivesIn(spec, db_id)) continue;
+        ok = db.type == DatabaseType::MYSQL
+            ? exportMySQLTable(std::get<MYSQL*>(db.connection), spec, out, result.rows)
+            : exportSQLiteTable(sqliteReadConnection(db), spec, out, result.rows);
+        if (!ok) break;
+    }
+
+    out.flush();
+    if (!out) {
+        LOG_ERROR("Export: write to {} failed", path);
+        ok = false;
+    }
+
+    result.seconds = secondsSince(start);
+    LOG_INFO("Exported {} rows from DB ID {} to {} in {} s", result.rows, db_id, path, result.seconds);
+    if (stats) *stats = result;
+    return ok;
+}
+
+bool importJsonlToDatabase(int db_id, const std::string& path, TaskIoStats* stats) {
+    GTD_TRACE_SCOPE("importJsonlToDatabase");
+    if (db_id < 0 || db_id >= static_cast<int>(allDatabases.size())) {
+        LOG_ERROR("Import: no database with ID {}", db_id);
+        return false;
+    }
+
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        LOG_ERROR("Import: cannot read {}", path);
+        return false;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    const DatabaseConnection& db = allDatabases[db_id];
+    TaskIoStats result;
+    bool ok;
+
+    if (db.type == DatabaseType::MYSQL) {
+        MySQLImporter importer(std::get<MYSQL*>(db.connection));
+        ok = importLines(importer, in, result);
+    }
+    else {
+        sqlite3* conn = std::get<sqlite3*>(db.connection);
+
+        // Into an empty Tasks table, building the secondary indexes once at the
+        // end is far cheaper than updating them for every random-uuid row
+        bool deferIndexes = sqliteTableIsEmpty(conn, "Tasks") && dropSecondaryIndexes(conn, "Tasks");
+        {
+            SQLiteImporter importer(conn);
+            ok = importLines(importer, in, result);
+        }
+        if (deferIndexes && !createSecondaryIndexes(conn, "Tasks")) {
+            LOG_WARN("Import: Tasks indexes could not be rebuilt; they are recreated on next start.");
+        }
+    }
+
+    result.seconds = secondsSince(start);
+    LOG_INFO("Imported {} rows into DB ID {} from {} in {} s ({} skipped)",
+        result.rows, db_id, path, result.seconds, result.skipped);
+    if (stats) *stats = result;
+    return ok;
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// Bulk export/import of Tasks and the lookup tables as JSON Lines.
+// Each line is one row: {"table":"Tasks","row":{"uuid":"...","title":"...",...}}
+// Export streams rows straight from the query cursor; import parses one line at
+// a time straight into per-column slots and upserts in batched transactions, so
+// memory use does not grow with the file.
+
+struct TaskIoStats {
+    uint64_t rows = 0;
+    uint64_t skipped = 0;   // malformed lines or rows the database rejected
+    double seconds = 0.0;
+};
+
+// Every exportable table mapped to db_id (Tasks always), in import order
+bool exportDatabaseToJsonl(int db_id, const std::string& path, TaskIoStats* stats = nullptr);
+
+// Rows are upserted by primary key into db_id; tables missing there are skipped.
+// Only the columns a line names are written, so a partial row leaves the rest
+// of an existing row alone; a line without the key column is skipped.
+bool importJsonlToDatabase(int db_id, const std::string& path, TaskIoStats* stats = nullptr);
@@ -0,0 +1,136 @@
+#include "core/task_query.h"
+
+#include <algorithm>
+
+namespace {
+
+// The flag columns are NOT NULL (migration 1), so a plain comparison is never
+// NULL and can use idx_tasks_is_done / idx_tasks_done_completed
+void appendFlag(const char* column, const std::optional<bool>& value, std::vector<std::string>& terms, TaskQuery& query) {
+    if (!value) return;
+    terms.push_back(std::string(column) + " = ?");
+    query.params.emplace_back(*value ? 1 : 0);
+}
+
+// Every term is TRUE or FALSE, never NULL, so a clause can be negated safely
+template <typename Set>
+void appendSet(const char* column, bool allowAll, const Set& allowed, std::vector<std::string>& terms, TaskQuery& query) {
+    if (allowAll) return;
+    if (allowed.empty()) {
+        terms.push_back("0 = 1");
+        return;
+    }
+
+    std::string term = std::string("(") + column + " IS NOT NULL AND " + column + " IN (";
+    for (size_t i = 0; i < allowed.size(); ++i) {
+        term += i == 0 ? "?" : ", ?";
+    }
+    term += "))";
+    terms.push_back(std::move(term));
+    for (const auto& value : allowed) {
+        query.params.emplace_back(value);
+    }
+}
+
+std::vector<std::string> compileTerms(const TaskFilterCriteria& c, TaskQuery& query) {
+    std::vector<std::string> terms;
+    appendFlag("is_done", c.is_done, terms, query);
+    appendFlag("in_focus", c.in_focus, terms, query);
+    appendSet("category_id", c.allowAllCategories, c.allowed_category_ids, terms, query);
+    appendSet("context_id", c.allowAllContexts, c.allowed_context_ids, terms, query);
+    appendSet("topic_id", c.allowAllTopics, c.allowed_topic_ids, terms, query);
+    appendSet("delegated_to", c.allowAllDelegates, c.allowed_delegate_ids, terms, query);
+    appendSet("project_uuid", c.allowAllProjects, c.allowed_project_uuids, terms, query);
+    return terms;
+}
+
+std::string joinTerms(const std::vector<std::string>& terms) {
+    std::string clause;
+    for (const std::string& term : terms) {
+        if (!clause.empty()) clause += " AND ";
+        clause += term;
+    }
+    return clause;
+}
+
+// Appends the parameters and returns the clause; empty when nothing is restricted
+std::string compileClause(const TaskFilterCriteria& c, TaskQuery& query) {
+    return joinTerms(compileTerms(c, query));
+}
+
+// Rows `previous` did not select. A filter on one flag alone (the open-tasks
+// startup load) is inverted instead of negated: flags are stored as 0 or 1, and
+// NOT (is_done = ?) cannot use an index where is_done = ? can.
+std::string compileExclusion(const TaskFilterCriteria& previous, TaskQuery& query) {
+    TaskQuery own;
+    std::vector<std::string> terms = compileTerms(previous, own);
+    if (terms.size() == 1 && previous.is_done.has_value() != previous.in_focus.has_value()) {
+        std::vector<std::string> inverted;
+        if (previous.is_done) appendFlag("is_done", !*previous.is_done, inverted, query);
+        else appendFlag("in_focus", !*previous.in_focus, inverted, query);
+        return inverted.front();
+    }
+
+    query.params.insert(query.params.end(), own.params.begin(), own.params.end());
+    return terms.empty() ? std::string("0 = 1") : "NOT (" + joinTerms(terms) + ")";
+}
+
+bool flagCovers(const std::optional<bool>& loaded, const std::optional<bool>& wanted) {
+    return !loaded || loaded == wanted;
+}
+
+template <typename Set>
+bool setCovers(bool loadedAll, const Set& loaded, bool wantedAll, const Set& wanted) {
+    if (loadedAll) return true;
+    if (wantedAll) return false;
+    return std::includes(loaded.begin(), loaded.end(), wanted.begin(), wanted.end(), loaded.key_comp());
+}
+
+bool inSet(bool allowAll, const std::set<int>& allowed, const std::optional<int>& id) {
+    return allowAll || (id && allowed.count(*id) > 0);
+}
+
+} // namespace
+
+TaskQuery compileTaskFilter(const TaskFilterCriteria& criteria) {
+    TaskQuery query;
+    query.where = compileClause(criteria, query);
+    return query;
+}
+
+TaskQuery compileTaskFilter(const TaskFilterCriteria& wanted, const std::vector<TaskFilterCriteria>& loaded) {
+    TaskQuery query = compileTaskFilter(wanted);
+    if (loaded.empty()) return query;
+
+    std::vector<std::string> terms;
+    if (!query.where.empty()) terms.push_back("(" + query.where + ")");
+    for (const TaskFilterCriteria& previous : loaded) {
+        terms.push_back(compileExclusion(previous, query));
+    }
+    query.where = joinTerms(terms);
+    return query;
+}
+
+bool taskMatchesCriteria(const Task& t, const TaskFilterCriteria& c) {
+    if (c.is_done && t.is_done != *c.is_done)    return false;
+    if (c.in_focus && t.in_focus != *c.in_focus) return false;
+    if (!inSet(c.allowAllCategories, c.allowed_category_ids, t.category_id)) return false;
+    if (!inSet(c.allowAllContexts, c.allowed_context_ids, t.context_id))     return false;
+    if (!inSet(c.allowAllTopics, c.allowed_topic_ids, t.topic_id))           return false;
+    if (!inSet(c.allowAllDelegates, c.allowed_delegate_ids, t.delegated_to)) return false;
+    if (!c.allowAllProjects &&
+        !(t.project_uuid && c.allowed_project_uuids.count(std::string_view(*t.project_uuid)) > 0)) {
+        return false;
+    }
+    return true;
+}
+
+bool criteriaCovers(const TaskFilterCriteria& loaded, const TaskFilterCriteria& wanted) {
+    return flagCovers(loaded.is_done, wanted.is_done) &&
+        flagCovers(loaded.in_focus, wanted.in_focus) &&
+        setCovers(loaded.allowAllCategories, loaded.allowed_category_ids, wanted.allowAllCategories, wanted.allowed_category_ids) &&
+        setCovers(loaded.allowAllContexts, loaded.allowed_context_ids, wanted.allowAllContexts, wanted.allowed_context_ids) &&
+        setCovers(loaded.allowAllTopics, loaded.allowed_topic_ids, wanted.allowAllTopics, wanted.allowed_topic_ids) &&
+        setCovers(loaded.allowAllDelegates, loaded.allowed_delegate_ids, wanted.allowAllDelegates, wanted.allowed_delegate_ids) &&
+        setCovers(loaded.allowAllProjects, loaded.allowed_project_uuids, wanted.allowAllProjects, wanted.allowed_project_uuids);
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "core/task.h"
+#include "core/task_filter_criteria.h"
+
+#include <string>
+#include <variant>
+#include <vector>
+
+// === Filter pushdown ===
+// TaskFilterCriteria compiled to a WHERE clause with positional `?` parameters.
+// The text is the same for SQLite and MySQL; each backend binds the values
+// through its own prepared-statement API. Only the row-selecting fields are
+// compiled (done, focus and the id sets); show_deferred and next_actions_only
+// depend on the clock and the loaded graph, and stay client-side.
+using TaskQueryParam = std::variant<int, std::string>;
+
+struct TaskQuery {
+    std::string where;                   // empty selects every row
+    std::vector<TaskQueryParam> params;  // in placeholder order
+    bool archive = false;                // read TasksArchive instead of Tasks
+};
+
+// Rows matching `criteria`
+TaskQuery compileTaskFilter(const TaskFilterCriteria& criteria);
+
+// Rows matching `wanted` that none of the `loaded` filters matched, so
+// widening a filter fetches only the rows the working set is missing
+TaskQuery compileTaskFilter(const TaskFilterCriteria& wanted, const std::vector<TaskFilterCriteria>& loaded);
+
+// Client-side twin of the compiled clause: a task with no category (context,
+// ...) fails a restricted category filter, as it does in SQL
+bool taskMatchesCriteria(const Task& t, const TaskFilterCriteria& criteria);
+
+// True if every row `wanted` selects is also selected by `loaded`
+bool criteriaCovers(const TaskFilterCriteria& loaded, const TaskFilterCriteria& wanted);
@@ -0,0 +1,645 @@
+#include "core/task_reconcile.h"
+#include "core/database.h"
+#include "core/database_registry.h"
+#include "core/date_time.h"
+#include "core/task_archive.h"
+#include "core/task_schema.h"
+#include "core/trace.h"
+#include "core/logger.h"
+
+#include <mysql.h>
+#include <sqlite3.h>
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <future>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+namespace {
+
+// Rows fetched in full per query
+constexpr size_t kFetchBatchRows = 500;
+
+// A prefix this long is a whole UUID; the descent always stops here
+constexpr size_t kMaxDepth = 36;
+
+// Row hash input: column values joined by the unit separator, NULL as the
+// record separator, so NULL and '' hash differently
+constexpr char kFieldSeparator = '\x1f';
+constexpr char kNullMarker = '\x1e';
+
+// --- MD5 (RFC 1321), first 64 bits of the digest ---
+
+constexpr uint32_t kMd5Sines[64] = {
+    0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee,
+    0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+    0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be,
+    0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+    0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa,
+    0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+    0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed,
+    0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+    0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c,
+    0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+    0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05,
+    0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+    0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039,
+    0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+    0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1,
+    0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391,
+};
+
+constexpr int kMd5Shifts[16] = { 7, 12, 17, 22, 5, 9, 14, 20, 4, 11, 16, 23, 6, 10, 15, 21 };
+
+void md5Block(uint32_t state[4], const unsigned char* block) {
+    uint32_t m[16];
+    for (int i = 0; i < 16; ++i) {
+        m[i] = uint32_t(block[i * 4]) | uint32_t(block[i * 4 + 1]) << 8 |
+            uint32_t(block[i * 4 + 2]) << 16 | uint32_t(block[i * 4 + 3]) << 24;
+    }
+
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+    for (int i = 0; i < 64; ++i) {
+        uint32_t f;
+        int g;
+        if (i < 16)      { f = (b & c) | (~b & d); g = i; }
+        else if (i < 32) { f = (d & b) | (~d & c); g = (5 * i + 1) % 16; }
+        else if (i < 48) { f = b ^ c ^ d;          g = (3 * i + 5) % 16; }
+        else             { f = c ^ (b | ~d);       g = (7 * i) % 16; }
+
+        f += a + kMd5Sines[i] + m[g];
+        const int shift = kMd5Shifts[(i / 16) * 4 + i % 4];
+        a = d;
+        d = c;
+        c = b;
+        b += (f << shift) | (f >> (32 - shift));
+    }
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+}
+
+// Big-endian value of the first 8 digest bytes, which is what MySQL's
+// CONV(LEFT(MD5(x), 16), 16, 10) returns
+uint64_t md5Prefix64(std::string_view data) {
+    uint32_t state[4] = { 0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476 };
+    const auto* bytes = reinterpret_cast<const unsigned char*>(data.data());
+    const size_t fullBlocks = data.size() / 64;
+    for (size_t i = 0; i < fullBlocks; ++i) md5Block(state, bytes + i * 64);
+
+    unsigned char tail[128] = {};
+    const size_t rest = data.size() % 64;
+    std::memcpy(tail, bytes + fullBlocks * 64, rest);
+    tail[rest] = 0x80;
+    const size_t tailSize = rest < 56 ? 64 : 128;
+    const uint64_t bits = static_cast<uint64_t>(data.size()) * 8;
+    for (int i = 0; i < 8; ++i) tail[tailSize - 8 + i] = static_cast<unsigned char>(bits >> (8 * i));
+    md5Block(state, tail);
+    if (tailSize == 128) md5Block(state, tail + 64);
+
+    uint64_t prefix = 0;
+    for (int word = 0; word < 2; ++word) {
+        for (int byte = 0; byte < 4; ++byte) prefix = prefix << 8 | ((state[word] >> (8 * byte)) & 0xff);
+    }
+    return prefix;
+}
+
+// --- SQLite functions: gtd_row_hash(col, ...) and the gtd_xor(h) aggregate ---
+
+void sqliteRowHash(sqlite3_context* ctx, int argc, sqlite3_value** argv) {
+    thread_local std::string text;
+    text.clear();
+    for (int i = 0; i < argc; ++i) {
+        if (i > 0) text += kFieldSeparator;
+        if (sqlite3_value_type(argv[i]) == SQLITE_NULL) {
+            text += kNullMarker;
+            continue;
+        }
+        const unsigned char* value = sqlite3_value_text(argv[i]);
+        text.append(reinterpret_cast<const char*>(value), static_cast<size_t>(sqlite3_value_bytes(argv[i])));
+    }
+    sqlite3_result_int64(ctx, static_cast<sqlite3_int64>(md5Prefix64(text)));
+}
+
+void sqliteXorStep(sqlite3_context* ctx, int, sqlite3_value** argv) {
+    auto* acc = static_cast<uint64_t*>(sqlite3_aggregate_context(ctx, sizeof(uint64_t)));
+    if (acc) *acc ^= static_cast<uint64_t>(sqlite3_value_int64(argv[0]));
+}
+
+void sqliteXorFinal(sqlite3_context* ctx) {
+    auto* acc = static_cast<uint64_t*>(sqlite3_aggregate_context(ctx, 0));
+    sqlite3_result_int64(ctx, acc ? static_cast<sqlite3_int64>(*acc) : 0);
+}
+
+bool registerSQLiteFunctions(sqlite3* conn) {
+    const int flags = SQLITE_UTF8 | SQLITE_DETERMINISTIC;
+    if (sqlite3_create_function_v2(conn, "gtd_row_hash", -1, flags, nullptr, sqliteRowHash, nullptr, nullptr, nullptr) != SQLITE_OK ||
+        sqlite3_create_function_v2(conn, "gtd_xor", 1, flags, nullptr, nullptr, sqliteXorStep, sqliteXorFinal, nullptr) != SQLITE_OK) {
+        LOG_ERROR("Could not register reconciliation functions: {}", sqlite3_errmsg(conn));
+        return false;
+    }
+    return true;
+}
+
+// --- One side of the reconciliation ---
+
+struct Store {
+    int db_id;
+    const DatabaseConnection& db;
+
+    bool mysql() const { return db.type == DatabaseType::MYSQL; }
+    MYSQL* mysqlConn() const { return std::get<MYSQL*>(db.connection); }
+    sqlite3* sqliteConn() const { return sqliteReadConnection(db); }
+
+    // A string value in SQL: `?` plus a bound parameter on SQLite, an escaped
+    // literal on MySQL
+    std::string value(std::string_view text, std::vector<std::string>& params) const {
+        if (!mysql()) {
+            params.emplace_back(text);
+            return "?";
+        }
+        std::string escaped(text.size() * 2 + 1, '\0');
+        escaped.resize(mysql_real_escape_string(mysqlConn(), &escaped[0], text.data(), static_cast<unsigned long>(text.size())));
+        return "'" + escaped + "'";
+    }
+};
+
+std::string dateTimeExpr(const Store& store, const char* column) {
+    return store.mysql()
+        ? std::string("DATE_FORMAT(") + column + ", '%Y-%m-%d %H:%i:%s')"
+        : std::string("datetime(") + column + ")";
+}
+
+// Same bytes on both backends: dates normalised, numbers as decimal text,
+// the tier appended as a last field
+std::string rowHashExpr(const Store& store, int tier) {
+    std::string fields;
+    forEachTaskColumn([&](const auto& column, size_t index) {
+        if (index > 0) fields += ", ";
+        std::string value = column.is(kColumnDateTime) ? dateTimeExpr(store, column.name) : std::string(column.name);
+        fields += store.mysql() ? "COALESCE(CAST(" + value + " AS CHAR), CHAR(30 USING utf8mb4))" : value;
+    });
+    const std::string tierText = std::to_string(tier);
+    if (!store.mysql()) return "gtd_row_hash(" + fields + ", " + tierText + ")";
+    return "CAST(CONV(LEFT(MD5(CONCAT_WS(CHAR(31 USING utf8mb4), " + fields + ", '" + tierText + "')), 16), 16, 10) AS UNSIGNED)";
+}
+
+// --- UUID ranges ---
+
+// The prefix after `prefix` among prefixes of the same length over lowercase
+// hex ("a9" -> "aa", "af" -> "b0"); empty past "ff...". nullopt when the
+// prefix holds other characters. Digits sort before letters under binary and
+// MySQL collations alike, so [prefix, next) holds exactly the keys that start
+// with prefix.
+std::optional<std::string> nextHexPrefix(std::string prefix) {
+    for (size_t i = prefix.size(); i-- > 0;) {
+        char& c = prefix[i];
+        if (!((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f'))) return std::nullopt;
+    }
+    for (size_t i = prefix.size(); i-- > 0;) {
+        char& c = prefix[i];
+        if (c == 'f') {
+            c = '0';
+            continue;
+        }
+        c = c == '9' ? 'a' : static_cast<char>(c + 1);
+        return prefix;
+    }
+    return std::string();
+}
+
+// Keys from low up to (not including) high; an empty high is unbounded. Exact
+// ranges match SUBSTR(uuid) = low, for prefixes that are not plain hex.
+struct KeyRange {
+    std::string low;
+    std::string high;
+    bool exact = false;
+};
+
+// Sorted prefixes of one length as index-friendly ranges, neighbours merged,
+// so a level whose ranges all differ becomes a single scan
+std::vector<KeyRange> prefixRanges(const std::vector<std::string>& prefixes) {
+    std::vector<KeyRange> ranges;
+    for (const std::string& prefix : prefixes) {
+        std::optional<std::string> next = nextHexPrefix(prefix);
+        if (!next) {
+            ranges.push_back({ prefix, std::string(), true });
+            continue;
+        }
+        if (!ranges.empty() && !ranges.back().exact && ranges.back().high == prefix) {
+            ranges.back().high = std::move(*next);
+            continue;
+        }
+        ranges.push_back({ prefix, std::move(*next), false });
+    }
+    return ranges;
+}
+
+// (uuid, h, tier[, updated]) over both tiers, limited to `ranges`; no ranges
+// selects every row
+std::string rowsSql(const Store& store, const KeyRange* ranges, size_t rangeCount, bool withUpdated,
+                    std::vector<std::string>& params) {
+    std::string sql;
+    for (int tier = 0; tier < 2; ++tier) {
+        if (tier > 0) sql += " UNION ALL ";
+        sql += "SELECT uuid, " + rowHashExpr(store, tier) + " AS h, " + std::to_string(tier) + " AS tier";
+        if (withUpdated) sql += ", " + dateTimeExpr(store, "updated_at") + " AS updated";
+        sql += tier == 0 ? " FROM Tasks" : " FROM TasksArchive";
+        if (rangeCount == 0) continue;
+
+        sql += " WHERE ";
+        for (size_t i = 0; i < rangeCount; ++i) {
+            const KeyRange& range = ranges[i];
+            if (i > 0) sql += " OR ";
+            if (range.exact) {
+                sql += "SUBSTR(uuid, 1, " + std::to_string(range.low.size()) + ") = " + store.value(range.low, params);
+            }
+            else if (range.high.empty()) {
+                sql += "uuid >= " + store.value(range.low, params);
+            }
+            else {
+                // Two statements: the parameters have to be added in placeholder order
+                const std::string low = store.value(range.low, params);
+                sql += "(uuid >= " + low + " AND uuid < " + store.value(range.high, params) + ")";
+            }
+        }
+    }
+    return sql;
+}
+
+// Runs sql and hands each row to onRow; NULL values arrive as empty views.
+// Counts both directions in stats.
+bool runQuery(const Store& store, const std::string& sql, const std::vector<std::string>& params,
+              ReconcileStats& stats, const std::function<void(const std::string_view*)>& onRow) {
+    ++stats.queries;
+    stats.bytesSent += sql.size();
+    for (const std::string& param : params) stats.bytesSent += param.size();
+
+    std::string_view values[4];
+    if (store.mysql()) {
+        MYSQL* conn = store.mysqlConn();
+        if (mysql_real_query(conn, sql.data(), static_cast<unsigned long>(sql.size())) != 0) {
+            LOG_ERROR("Reconciliation query failed on DB ID {}: {}", store.db_id, mysql_error(conn));
+            return false;
+        }
+        MYSQL_RES* res = mysql_use_result(conn);
+        if (!res) {
+            LOG_ERROR("Reconciliation result failed on DB ID {}: {}", store.db_id, mysql_error(conn));
+            return false;
+        }
+        const unsigned int columns = std::min(mysql_num_fields(res), 4u);
+        while (MYSQL_ROW row = mysql_fetch_row(res)) {
+            unsigned long* lengths = mysql_fetch_lengths(res);
+            for (unsigned int c = 0; c < columns; ++c) {
+                values[c] = row[c] ? std::string_view(row[c], lengths[c]) : std::string_view();
+                stats.bytesReceived += values[c].size();
+            }
+            onRow(values);
+        }
+        const bool ok = mysql_errno(conn) == 0;
+        if (!ok) LOG_ERROR("Reconciliation fetch failed on DB ID {}: {}", store.db_id, mysql_error(conn));
+        mysql_free_result(res);
+        return ok;
+    }
+
+    sqlite3* conn = store.sqliteConn();
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(conn, sql.c_str(), static_cast<int>(sql.size()), &stmt, nullptr) != SQLITE_OK) {
+        LOG_ERROR("Reconciliation prepare failed on DB ID {}: {}", store.db_id, sqlite3_errmsg(conn));
+        return false;
+    }
+    for (size_t i = 0; i < params.size(); ++i) {
+        sqlite3_bind_text(stmt, static_cast<int>(i + 1), params[i].data(), static_cast<int>(params[i].size()), SQLITE_STATIC);
+    }
+
+    const int columns = std::min(sqlite3_column_count(stmt), 4);
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        for (int c = 0; c < columns; ++c) {
+            const unsigned char* text = sqlite3_column_text(stmt, c);
+            values[c] = text ? std::string_view(reinterpret_cast<const char*>(text), static_cast<size_t>(sqlite3_column_bytes(stmt, c)))
+                             : std::string_view();
+            stats.bytesReceived += values[c].size();
+        }
+        onRow(values);
+    }
+    if (rc != SQLITE_DONE) LOG_ERROR("Reconciliation query failed on DB ID {}: {}", store.db_id, sqlite3_errmsg(conn));
+    sqlite3_finalize(stmt);
+    return rc == SQLITE_DONE;
+}
+
+// MySQL returns the hash unsigned, SQLite as a signed 64-bit integer
+uint64_t parseHash(std::string_view text) {
+    if (!text.empty() && text[0] == '-') {
+        int64_t value = 0;
+        std::from_chars(text.data(), text.data() + text.size(), value);
+        return static_cast<uint64_t>(value);
+    }
+    uint64_t value = 0;
+    std::from_chars(text.data(), text.data() + text.size(), value);
+    return value;
+}
+
+uint64_t parseCount(std::string_view text) {
+    uint64_t value = 0;
+    std::from_chars(text.data(), text.data() + text.size(), value);
+    return value;
+}
+
+// --- Tree levels ---
+
+struct RangeSummary {
+    uint64_t count = 0;
+    uint64_t hash = 0;
+};
+
+using Summaries = std::map<std::string, RangeSummary, std::less<>>;
+
+// Ranges of `depth` characters under `parents` (every row when empty)
+bool summarize(const Store& store, size_t depth, const std::vector<KeyRange>& parents,
+               const ReconcileOptions& options, ReconcileStats& stats, Summaries& out) {
+    const std::string bucket = "SUBSTR(uuid, 1, " + std::to_string(depth) + ")";
+    const char* xorFn = store.mysql() ? "BIT_XOR" : "gtd_xor";
+    auto onRow = [&](const std::string_view* row) {
+        out[std::string(row[0])] = { parseCount(row[1]), parseHash(row[2]) };
+    };
+
+    const size_t perQuery = std::max<size_t>(options.rangesPerQuery, 1);
+    size_t first = 0;
+    do {
+        const size_t count = std::min(parents.size() - first, perQuery);
+        std::vector<std::string> params;
+        const std::string sql = "SELECT " + bucket + ", COUNT(*), " + xorFn + "(h) FROM (" +
+            rowsSql(store, parents.data() + first, count, false, params) + ") AS r GROUP BY " + bucket;
+        if (!runQuery(store, sql, params, stats, onRow)) return false;
+        first += count;
+    } while (first < parents.size());
+    return true;
+}
+
+struct RowEntry {
+    uint64_t hash = 0;
+    int tier = 0;
+    std::optional<int64_t> updated;
+};
+
+using Listing = std::map<std::string, RowEntry, std::less<>>;
+
+// Every row in `leaves`
+bool listRows(const Store& store, const std::vector<KeyRange>& leaves,
+              const ReconcileOptions& options, ReconcileStats& stats, Listing& out) {
+    auto onRow = [&](const std::string_view* row) {
+        out[std::string(row[0])] = { parseHash(row[1]), row[2] == "1" ? 1 : 0, parseDateTime(row[3]) };
+        ++stats.rowsListed;
+    };
+
+    const size_t perQuery = std::max<size_t>(options.rangesPerQuery, 1);
+    for (size_t first = 0; first < leaves.size(); first += perQuery) {
+        const size_t count = std::min(leaves.size() - first, perQuery);
+        std::vector<std::string> params;
+        if (!runQuery(store, rowsSql(store, leaves.data() + first, count, true, params), params, stats, onRow)) return false;
+    }
+    return true;
+}
+
+// f(0) on a worker and f(1) here; each store has its own connection. Like the
+// notes and lookup workers, the thread registers with the MySQL client library
+// before it uses store 0's connection.
+template <typename F>
+bool onBothSides(const Store& first, F&& f) {
+    std::future<bool> worker = std::async(std::launch::async, [&f, mysql = first.mysql()] {
+        if (mysql) mysql_thread_init();
+        const bool ok = f(0);
+        if (mysql) mysql_thread_end();
+        return ok;
+    });
+    const bool second = f(1);
+    return worker.get() && second;
+}
+
+// --- Merge ---
+
+struct Transfer {
+    std::string uuid;
+    int loserTier = -1;     // -1 while the losing side does not have the task
+};
+
+template <typename Value>
+uint64_t valueBytes(const Value& value) {
+    if constexpr (std::is_same_v<Value, TaskString>) return value.size();
+    else if constexpr (std::is_same_v<Value, std::optional<TaskString>>) return value ? value->size() : 0;
+    else if constexpr (std::is_same_v<Value, std::optional<int>>) return value ? std::to_string(*value).size() : 0;
+    else return 1;
+}
+
+uint64_t rowBytes(const Task& task) {
+    uint64_t bytes = 0;
+    forEachTaskColumn([&](const auto& column, size_t) { bytes += valueBytes(column.get(task)); });
+    return bytes;
+}
+
+// Notes of the rows a lazy-notes fetch left out, in one query per batch
+bool fetchNotes(const Store& store, int tier, const std::vector<Task*>& rows, ReconcileStats& stats) {
+    if (rows.empty()) return true;
+    std::vector<std::string> params;
+    std::string sql = tier == 0 ? "SELECT uuid, notes FROM Tasks" : "SELECT uuid, notes FROM TasksArchive";
+    std::unordered_map<std::string_view, Task*> byUuid;
+    for (size_t i = 0; i < rows.size(); ++i) {
+        sql += (i == 0 ? " WHERE uuid IN (" : ", ") + store.value(rows[i]->uuid, params);
+        byUuid[rows[i]->uuid] = rows[i];
+    }
+    sql += ")";
+
+    return runQuery(store, sql, params, stats, [&](const std::string_view* values) {
+        auto row = byUuid.find(values[0]);
+        if (row == byUuid.end()) return;
+        row->second->notes.assign(values[1].data(), values[1].size());
+        row->second->notes_loaded = true;
+    });
+}
+
+// The loser ends up with the winner's row in the winner's tier
+bool writeToLoser(Task& task, int winnerTier, const Store& loser, int loserTier) {
+    if (loserTier == 1 && !restoreArchivedTask(loser.db_id, task.uuid)) return false;
+    task.db_id = loser.db_id;
+    task.archived = false;
+    if (!writeTaskRow(task)) return false;
+    return winnerTier == 0 || archiveTask(loser.db_id, task.uuid);
+}
+
+// Fetch the winning rows in batches and write them to the other side
+void applyTransfers(const Store& winner, int winnerTier, const std::vector<Transfer>& transfers,
+                    const Store& loser, ReconcileStats& stats, uint64_t& copied) {
+    for (size_t first = 0; first < transfers.size(); first += kFetchBatchRows) {
+        const size_t last = std::min(transfers.size(), first + kFetchBatchRows);
+
+        TaskQuery query;
+        query.archive = winnerTier == 1;
+        query.where = "uuid IN (";
+        std::unordered_map<std::string_view, int> loserTiers;
+        for (size_t i = first; i < last; ++i) {
+            query.where += i == first ? "?" : ", ?";
+            query.params.emplace_back(transfers[i].uuid);
+            loserTiers[transfers[i].uuid] = transfers[i].loserTier;
+            stats.bytesSent += transfers[i].uuid.size();
+        }
+        query.where += ")";
+        stats.bytesSent += query.where.size();
+        ++stats.queries;
+
+        bool fetched = false;
+        std::vector<Task> rows = winner.mysql()
+            ? fetchTasksFromMySQL(winner.mysqlConn(), winner.db_id, std::pmr::get_default_resource(), query, &fetched)
+            : fetchTasksFromSQLite(winner.sqliteConn(), winner.db_id, std::pmr::get_default_resource(), query, &fetched);
+        // Rows a failed fetch did not return are failures, not rows that vanished
+        if (!fetched) stats.failed += (last - first) - std::min(rows.size(), last - first);
+
+        std::vector<Task*> lazy;
+        for (Task& task : rows) {
+            if (!task.notes_loaded) lazy.push_back(&task);
+        }
+        fetchNotes(winner, winnerTier, lazy, stats);
+        // runQuery counted the notes as received; rowBytes counts them again below
+        for (const Task* task : lazy) stats.bytesReceived -= task->notes.size();
+
+        for (Task& task : rows) {
+            // Notes missing after the batch mean the row went away or the query failed
+            if (!task.notes_loaded) {
+                ++stats.failed;
+                continue;
+            }
+            const uint64_t bytes = rowBytes(task);
+            stats.bytesReceived += bytes;
+
+            // A row that vanished between the listing and this fetch is left for the next run
+            auto loserTier = loserTiers.find(std::string_view(task.uuid));
+            if (loserTier == loserTiers.end()) continue;
+            if (!writeToLoser(task, winnerTier, loser, loserTier->second)) {
+                LOG_ERROR("Could not copy task {} from DB ID {} to DB ID {}", task.uuid, winner.db_id, loser.db_id);
+                ++stats.failed;
+                continue;
+            }
+            stats.bytesSent += bytes;
+            ++copied;
+        }
+    }
+}
+
+} // namespace
+
+bool reconcileTaskStores(int db_a, int db_b, const ReconcileOptions& options, ReconcileStats* stats) {
+    GTD_TRACE_SCOPE("reconcileTaskStores");
+    const int databaseCount = static_cast<int>(allDatabases.size());
+    if (db_a == db_b || db_a < 0 || db_b < 0 || db_a >= databaseCount || db_b >= databaseCount) {
+        LOG_ERROR("Cannot reconcile DB ID {} with DB ID {}", db_a, db_b);
+        return false;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    ReconcileStats result;
+    const Store stores[2] = { { db_a, allDatabases[db_a] }, { db_b, allDatabases[db_b] } };
+    for (const Store& store : stores) {
+        if (!store.mysql() && !registerSQLiteFunctions(store.sqliteConn())) return false;
+    }
+
+    // transfers[winner][tier of the winning row]
+    std::vector<Transfer> transfers[2][2];
+    ReconcileStats traffic[2];      // per side, so the two queries can run at once
+    std::vector<std::string> parents;
+    bool ok = true;
+
+    // Depth d compares the ranges of UUIDs sharing their first d characters,
+    // 16 per parent range; depth 1 covers the whole table
+    for (size_t depth = 1; ok && (depth == 1 || !parents.empty()); ++depth) {
+        ++result.levels;
+        const std::vector<KeyRange> parentRanges = prefixRanges(parents);
+        Summaries sides[2];
+        ok = onBothSides(stores[0], [&](int side) {
+            return summarize(stores[side], depth, parentRanges, options, traffic[side], sides[side]);
+        });
+        if (!ok) break;
+
+        std::vector<std::string> next;
+        std::vector<std::string> leaves;
+        auto visit = [&](const std::string& key) {
+            auto a = sides[0].find(key);
+            auto b = sides[1].find(key);
+            const RangeSummary none;
+            const RangeSummary& left = a != sides[0].end() ? a->second : none;
+            const RangeSummary& right = b != sides[1].end() ? b->second : none;
+            ++result.rangesCompared;
+            if (left.count == right.count && left.hash == right.hash) return;
+
+            ++result.rangesDiffering;
+            const bool small = std::max(left.count, right.count) <= std::max<size_t>(options.leafRows, 1);
+            (small || depth >= kMaxDepth ? leaves : next).push_back(key);
+        };
+        for (const auto& [key, summary] : sides[0]) visit(key);
+        for (const auto& [key, summary] : sides[1]) {
+            if (sides[0].find(key) == sides[0].end()) visit(key);
+        }
+        std::sort(next.begin(), next.end());
+        std::sort(leaves.begin(), leaves.end());
+
+        if (!leaves.empty()) {
+            const std::vector<KeyRange> leafRanges = prefixRanges(leaves);
+            Listing rows[2];
+            ok = onBothSides(stores[0], [&](int side) {
+                return listRows(stores[side], leafRanges, options, traffic[side], rows[side]);
+            });
+            if (!ok) break;
+
+            auto diff = [&](const std::string& uuid, const RowEntry* a, const RowEntry* b) {
+                if (a && b && a->hash == b->hash) return;
+                ++result.rowsDiffering;
+                // Later updated_at wins; a tie goes to db_a
+                const bool bWins = !a || (b && b->updated && (!a->updated || *b->updated > *a->updated));
+                const RowEntry& winner = bWins ? *b : *a;
+                const RowEntry* loser = bWins ? a : b;
+                transfers[bWins ? 1 : 0][winner.tier].push_back({ uuid, loser ? loser->tier : -1 });
+            };
+            for (const auto& [uuid, entry] : rows[0]) {
+                auto other = rows[1].find(uuid);
+                diff(uuid, &entry, other != rows[1].end() ? &other->second : nullptr);
+            }
+            for (const auto& [uuid, entry] : rows[1]) {
+                if (rows[0].find(uuid) == rows[0].end()) diff(uuid, nullptr, &entry);
+            }
+        }
+        parents = std::move(next);
+    }
+
+    for (const ReconcileStats& side : traffic) {
+        result.bytesSent += side.bytesSent;
+        result.bytesReceived += side.bytesReceived;
+        result.queries += side.queries;
+        result.rowsListed += side.rowsListed;
+    }
+
+    if (ok) {
+        for (int winner = 0; winner < 2; ++winner) {
+            for (int tier = 0; tier < 2; ++tier) {
+                applyTransfers(stores[winner], tier, transfers[winner][tier], stores[1 - winner], result,
+                    winner == 0 ? result.copiedToB : result.copiedToA);
+            }
+        }
+    }
+
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    LOG_INFO("Reconciled DB ID {} with DB ID {}: {} differing tasks, {} copied to {}, {} copied to {}, "
+        "{} bytes sent, {} received in {} queries, {} s",
+        db_a, db_b, result.rowsDiffering, result.copiedToA, db_a, result.copiedToB, db_b,
+        result.bytesSent, result.bytesReceived, result.queries, result.seconds);
+    if (stats) *stats = result;
+    return ok && result.failed == 0;
+}
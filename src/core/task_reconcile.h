@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// === Merkle-range reconciliation ===
+// Brings the tasks of two databases (both tiers, Tasks and TasksArchive) into
+// agreement without reading every row over the wire. Each side hashes its rows
+// where they live and returns only per-range summaries: count and the XOR of
+// the row hashes for every UUID prefix. The ranges are the nodes of a Merkle
+// tree with 16 children per node (one more hex digit of the UUID), compared
+// top-down, so matching subtrees are never opened; both sides are queried at
+// the same time. A differing range small enough to list returns (uuid, row
+// hash, tier, updated_at) per row, and full rows are fetched only for the
+// tasks that differ, from the side that wins.
+//
+// Merge rule: a task present on one side only is copied to the other; a task
+// present on both with different contents takes the version with the later
+// updated_at, and on a tie (or neither set) the version in db_a. The row keeps
+// its tier on the winning side. There are no tombstones, so a task deleted on
+// one side comes back from the other.
+//
+// The row hash is the first 64 bits of MD5 over the columns in schema order,
+// dates in "YYYY-MM-DD HH:MM:SS" form, so a MySQL and a SQLite copy of the
+// same task hash alike. SQLite computes it through functions registered on the
+// connection, MySQL through MD5() and BIT_XOR().
+
+struct ReconcileOptions {
+    size_t leafRows = 16;           // list a differing range once neither side has more rows
+    size_t rangesPerQuery = 256;    // UUID ranges named in one summary or listing query
+};
+
+struct ReconcileStats {
+    uint64_t bytesSent = 0;         // SQL text, parameters and rows written, both sides
+    uint64_t bytesReceived = 0;     // result values, both sides, full rows included
+    uint64_t queries = 0;
+    uint64_t levels = 0;            // tree levels visited
+    uint64_t rangesCompared = 0;
+    uint64_t rangesDiffering = 0;
+    uint64_t rowsListed = 0;        // (uuid, hash) entries read from differing leaves
+    uint64_t rowsDiffering = 0;
+    uint64_t copiedToA = 0;
+    uint64_t copiedToB = 0;
+    uint64_t failed = 0;            // rows that could not be fetched or written
+    double seconds = 0.0;
+};
+
+// Both ids must be valid and different. Returns false if a query failed or a
+// row could not be merged; what was merged stays merged, and a second run
+// picks up the rest.
+bool reconcileTaskStores(int db_a, int db_b, const ReconcileOptions& options = {}, ReconcileStats* stats = nullptr);
@@ -0,0 +1,78 @@
+#include "core/task_scheduler.h"
+#include "core/date_time.h"
+#include "core/trace.h"
+
+namespace {
+
+// Timer payload: task index in the high bits, event in the lowest bit
+uint64_t packPayload(size_t taskIndex, ScheduleEvent event) {
+    return (static_cast<uint64_t>(taskIndex) << 1) | static_cast<uint64_t>(event);
+}
+
+ScheduledFire unpackPayload(uint64_t payload) {
+    return { static_cast<size_t>(payload >> 1), static_cast<ScheduleEvent>(payload & 1) };
+}
+
+} // namespace
+
+void TaskScheduler::reset(const std::vector<Task>& tasks, int64_t now) {
+    GTD_TRACE_SCOPE("TaskScheduler::reset");
+    wheel_.reset(now);
+    timers_.assign(tasks.size(), TaskTimers{});
+    for (size_t i = 0; i < tasks.size(); ++i) {
+        arm(tasks[i], i, now);
+    }
+}
+
+void TaskScheduler::reschedule(const Task& task, size_t taskIndex, int64_t now) {
+    if (taskIndex >= timers_.size()) return;
+
+    TaskTimers& timers = timers_[taskIndex];
+    wheel_.cancel(timers.defer);
+    wheel_.cancel(timers.due);
+    timers = TaskTimers{};
+    arm(task, taskIndex, now);
+}
+
+void TaskScheduler::arm(const Task& task, size_t taskIndex, int64_t now) {
+    TaskTimers& timers = timers_[taskIndex];
+
+    if (task.defer_date) {
+        auto when = parseDateTime(*task.defer_date);
+        if (when && *when > now) {
+            timers.deferred = true;
+            timers.defer = wheel_.schedule(*when, packPayload(taskIndex, ScheduleEvent::DeferEnded));
+        }
+    }
+
+    if (task.due_date && !task.is_done) {
+        auto when = parseDateTime(*task.due_date);
+        if (when && *when > now) {
+            timers.due = wheel_.schedule(*when, packPayload(taskIndex, ScheduleEvent::Due));
+        }
+        else if (when) {
+            timers.overdue = true;
+        }
+    }
+}
+
+const std::vector<ScheduledFire>& TaskScheduler::advance(int64_t now) {
+    expired_.clear();
+    fired_.clear();
+    wheel_.advance(now, expired_);
+
+    for (uint64_t payload : expired_) {
+        ScheduledFire fire = unpackPayload(payload);
+        TaskTimers& timers = timers_[fire.taskIndex];
+        if (fire.event == ScheduleEvent::DeferEnded) {
+            timers.defer = TimerWheel::kNoTimer;
+            timers.deferred = false;
+        }
+        else {
+            timers.due = TimerWheel::kNoTimer;
+            timers.overdue = true;
+        }
+        fired_.push_back(fire);
+    }
+    return fired_;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "core/task.h"
+#include "core/timer_wheel.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+enum class ScheduleEvent : uint8_t {
+    DeferEnded,     // the defer date passed: the task becomes visible
+    Due,            // the due date passed on an open task: it is overdue
+};
+
+struct ScheduledFire {
+    size_t taskIndex;
+    ScheduleEvent event;
+};
+
+// Defer and due dates of a task list, driven by a TimerWheel so that time
+// passing never rescans the list. Task indexes are positions in the vector
+// given to reset().
+class TaskScheduler {
+public:
+    // Arms a timer for every future defer date and every future due date of an
+    // open task. Tasks already past due start out overdue without firing.
+    void reset(const std::vector<Task>& tasks, int64_t now);
+
+    // Re-arm one task after it was edited (dates changed, marked done...)
+    void reschedule(const Task& task, size_t taskIndex, int64_t now);
+
+    // Fire everything due up to now. The result is valid until the next call.
+    const std::vector<ScheduledFire>& advance(int64_t now);
+
+    bool deferred(size_t taskIndex) const { return taskIndex < timers_.size() && timers_[taskIndex].deferred; }
+    bool overdue(size_t taskIndex) const { return taskIndex < timers_.size() && timers_[taskIndex].overdue; }
+    size_t pending() const { return wheel_.size(); }
+
+private:
+    struct TaskTimers {
+        TimerWheel::TimerId defer = TimerWheel::kNoTimer;
+        TimerWheel::TimerId due = TimerWheel::kNoTimer;
+        bool deferred = false;
+        bool overdue = false;
+    };
+
+    void arm(const Task& task, size_t taskIndex, int64_t now);
+
+    TimerWheel wheel_;
+    std::vector<TaskTimers> timers_;
+    std::vector<uint64_t> expired_;
+    std::vector<ScheduledFire> fired_;
+};
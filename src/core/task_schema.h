@@ -0,0 +1,169 @@
+#pragma once
+
+#include "core/task.h"
+
+#include <array>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+
+// === Tasks table schema ===
+// One entry per column: its name and the Task member it maps to. The fetch
+// and upsert SQL are generated from this list at compile time, and the
+// backends bind and decode each column by the member's type, so adding a
+// column means adding one line here.
+
+enum TaskColumnFlags : unsigned {
+    kColumnKey      = 1u << 0,  // primary key; never part of an upsert's update list
+    kColumnLazy     = 1u << 1,  // left out of fetches on lazy_notes databases
+    kColumnDateTime = 1u << 2,  // "YYYY-MM-DD HH:MM:SS" text here, DATETIME on MySQL
+};
+
+template <auto Member>
+struct TaskColumn {
+    using Value = std::remove_cv_t<std::remove_reference_t<decltype(std::declval<Task&>().*Member)>>;
+
+    const char* name;
+    unsigned flags = 0;
+
+    static Value& get(Task& task) { return task.*Member; }
+    static const Value& get(const Task& task) { return task.*Member; }
+    constexpr bool is(unsigned flag) const { return (flags & flag) != 0; }
+};
+
+inline constexpr auto kTaskSchema = std::make_tuple(
+    TaskColumn<&Task::uuid>{ "uuid", kColumnKey },
+    TaskColumn<&Task::title>{ "title" },
+    TaskColumn<&Task::notes>{ "notes", kColumnLazy },
+    TaskColumn<&Task::category_id>{ "category_id" },
+    TaskColumn<&Task::context_id>{ "context_id" },
+    TaskColumn<&Task::project_uuid>{ "project_uuid" },
+    TaskColumn<&Task::topic_id>{ "topic_id" },
+    TaskColumn<&Task::delegated_to>{ "delegated_to" },
+    TaskColumn<&Task::time_required_minutes>{ "time_required_minutes" },
+    TaskColumn<&Task::in_focus>{ "in_focus" },
+    TaskColumn<&Task::due_date>{ "due_date", kColumnDateTime },
+    TaskColumn<&Task::defer_date>{ "defer_date", kColumnDateTime },
+    TaskColumn<&Task::created_at>{ "created_at", kColumnDateTime },
+    TaskColumn<&Task::updated_at>{ "updated_at", kColumnDateTime },
+    TaskColumn<&Task::is_done>{ "is_done" },
+    TaskColumn<&Task::completed_at>{ "completed_at", kColumnDateTime },
+    TaskColumn<&Task::link_from>{ "link_from" },
+    TaskColumn<&Task::link_to>{ "link_to" },
+    TaskColumn<&Task::is_locked>{ "is_locked" }
+);
+
+inline constexpr size_t kTaskColumnCount = std::tuple_size_v<decltype(kTaskSchema)>;
+
+// Column names in schema order
+inline constexpr std::array<const char*, kTaskColumnCount> kTaskColumns = std::apply(
+    [](const auto&... column) { return std::array<const char*, kTaskColumnCount>{ column.name... }; },
+    kTaskSchema);
+
+// f(column, index) for every column, unrolled at compile time
+template <typename F>
+void forEachTaskColumn(F&& f) {
+    std::apply([&](const auto&... column) {
+        size_t index = 0;
+        (f(column, index++), ...);
+    }, kTaskSchema);
+}
+
+// --- Generated SQL ---
+
+enum class TaskSql {
+    Select,             // every column, schema order, no WHERE clause
+    SelectLazy,         // same, with NULL in place of lazy columns
+    SelectArchive,      // Select / SelectLazy over TasksArchive
+    SelectArchiveLazy,
+    UpsertSQLite,       // one ? per column
+    UpsertSQLiteLazy,   // lazy columns left out so a save cannot blank them
+    UpsertMySQL,
+    UpsertMySQLLazy,
+};
+
+namespace task_sql_detail {
+
+struct Length {
+    size_t size = 0;
+    constexpr void append(const char* s) { while (*s++) ++size; }
+};
+
+template <size_t N>
+struct Text {
+    char text[N + 1] {};
+    size_t size = 0;
+    constexpr void append(const char* s) { while (*s) text[size++] = *s++; }
+};
+
+template <typename Out>
+constexpr void write(Out& out, TaskSql which) {
+    const bool lazy = which == TaskSql::SelectLazy || which == TaskSql::SelectArchiveLazy ||
+        which == TaskSql::UpsertSQLiteLazy || which == TaskSql::UpsertMySQLLazy;
+    const bool mysql = which == TaskSql::UpsertMySQL || which == TaskSql::UpsertMySQLLazy;
+    const bool archive = which == TaskSql::SelectArchive || which == TaskSql::SelectArchiveLazy;
+
+    if (which == TaskSql::Select || which == TaskSql::SelectLazy || archive) {
+        out.append("SELECT ");
+        std::apply([&](const auto&... column) {
+            bool first = true;
+            ((out.append(first ? "" : ", "), out.append(lazy && column.is(kColumnLazy) ? "NULL" : column.name), first = false), ...);
+        }, kTaskSchema);
+        out.append(archive ? " FROM TasksArchive" : " FROM Tasks");
+        return;
+    }
+
+    out.append("INSERT INTO Tasks (");
+    std::apply([&](const auto&... column) {
+        bool first = true;
+        ((lazy && column.is(kColumnLazy) ? void() : (out.append(first ? "" : ", "), out.append(column.name), void(first = false))), ...);
+    }, kTaskSchema);
+    out.append(") VALUES (");
+    std::apply([&](const auto&... column) {
+        bool first = true;
+        ((lazy && column.is(kColumnLazy) ? void() : (out.append(first ? "?" : ", ?"), void(first = false))), ...);
+    }, kTaskSchema);
+
+    // "title = excluded.title, ..." for SQLite; MySQL names the new row through
+    // an alias, "title = new.title, ...", since VALUES(col) is deprecated there
+    if (mysql) {
+        out.append(") AS new ON DUPLICATE KEY UPDATE ");
+    }
+    else {
+        out.append(") ON CONFLICT(");
+        std::apply([&](const auto&... column) { ((column.is(kColumnKey) ? out.append(column.name) : void()), ...); }, kTaskSchema);
+        out.append(") DO UPDATE SET ");
+    }
+    std::apply([&](const auto&... column) {
+        bool first = true;
+        ((column.is(kColumnKey) || (lazy && column.is(kColumnLazy)) ? void()
+            : (out.append(first ? "" : ", "), out.append(column.name),
+               out.append(mysql ? " = new." : " = excluded."), out.append(column.name),
+               void(first = false))), ...);
+    }, kTaskSchema);
+}
+
+constexpr size_t length(TaskSql which) {
+    Length out;
+    write(out, which);
+    return out.size;
+}
+
+template <TaskSql Which>
+constexpr Text<length(Which)> generate() {
+    Text<length(Which)> out;
+    write(out, Which);
+    return out;
+}
+
+template <TaskSql Which>
+inline constexpr auto kText = generate<Which>();
+
+} // namespace task_sql_detail
+
+// NUL-terminated SQL text, built at compile time
+template <TaskSql Which>
+constexpr const char* taskSql() { return task_sql_detail::kText<Which>.text; }
+
+template <TaskSql Which>
+constexpr size_t taskSqlLength() { return task_sql_detail::kText<Which>.size; }
@@ -0,0 +1,126 @@
+#include "core/timer_wheel.h"
+
+#include <algorithm>
+
+void TimerWheel::reset(int64_t now) {
+    nodes_.clear();
+    free_.clear();
+    std::fill(std::begin(heads_), std::end(heads_), kNone);
+    current_ = now;
+    count_ = 0;
+    initialized_ = true;
+}
+
+TimerWheel::TimerId TimerWheel::schedule(int64_t when, uint64_t payload) {
+    if (!initialized_) reset(when);
+
+    uint32_t id;
+    if (!free_.empty()) {
+        id = free_.back();
+        free_.pop_back();
+    }
+    else {
+        id = static_cast<uint32_t>(nodes_.size());
+        nodes_.emplace_back();
+    }
+
+    Node& node = nodes_[id];
+    node.when = when;
+    node.payload = payload;
+    node.live = true;
+    link(id);
+    ++count_;
+    return id;
+}
+
+void TimerWheel::cancel(TimerId id) {
+    if (id >= nodes_.size() || !nodes_[id].live) return;
+    unlink(id);
+    nodes_[id].live = false;
+    free_.push_back(id);
+    --count_;
+}
+
+void TimerWheel::advance(int64_t now, std::vector<uint64_t>& fired) {
+    while (current_ <= now) {
+        // Nothing pending: skip the idle seconds outright
+        if (count_ == 0) {
+            current_ = now + 1;
+            break;
+        }
+        tick(fired);
+    }
+}
+
+// File a timer by distance from the current time: level L holds timers due
+// within 64^(L+1) seconds, in the slot picked by the L-th group of 6 bits
+void TimerWheel::link(uint32_t id) {
+    Node& node = nodes_[id];
+    int64_t when = std::max(node.when, current_);
+    uint64_t delta = static_cast<uint64_t>(when - current_);
+
+    int level = 0;
+    while (level < kLevels - 1 && delta >= (uint64_t(1) << (kSlotBits * (level + 1)))) ++level;
+
+    // Beyond the top level: park at its far edge and re-file on the way down
+    const uint64_t span = uint64_t(1) << (kSlotBits * kLevels);
+    if (delta >= span) when = current_ + static_cast<int64_t>(span - 1);
+
+    uint16_t slot = static_cast<uint16_t>(level * kSlots + ((when >> (kSlotBits * level)) & (kSlots - 1)));
+    node.slot = slot;
+    node.prev = kNone;
+    node.next = heads_[slot];
+    if (node.next != kNone) nodes_[node.next].prev = id;
+    heads_[slot] = id;
+}
+
+void TimerWheel::unlink(uint32_t id) {
+    Node& node = nodes_[id];
+    if (node.prev != kNone) nodes_[node.prev].next = node.next;
+    else heads_[node.slot] = node.next;
+    if (node.next != kNone) nodes_[node.next].prev = node.prev;
+    node.prev = node.next = kNone;
+}
+
+void TimerWheel::tick(std::vector<uint64_t>& fired) {
+    // At each 64-second boundary pull the next slot of the level above down,
+    // continuing upwards while that level wraps too
+    if ((current_ & (kSlots - 1)) == 0) {
+        for (int level = 1; level < kLevels; ++level) {
+            int index = static_cast<int>((current_ >> (kSlotBits * level)) & (kSlots - 1));
+            uint32_t id = heads_[level * kSlots + index];
+            heads_[level * kSlots + index] = kNone;
+            while (id != kNone) {
+                uint32_t next = nodes_[id].next;
+                link(id);
+                id = next;
+            }
+            if (index != 0) break;
+        }
+    }
+
+    int slot = static_cast<int>(current_ & (kSlots - 1));
+    uint32_t id = heads_[slot];
+    heads_[slot] = kNone;
+
+    // The list is newest-first; collect it so timers fire in scheduling order
+    size_t firstFired = fired.size();
+    while (id != kNone) {
+        Node& node = nodes_[id];
+        uint32_t next = node.next;
+        if (node.when > current_) {
+            link(id);   // was parked beyond the top level
+        }
+        else {
+            fired.push_back(node.payload);
+            node.live = false;
+            node.prev = node.next = kNone;
+            free_.push_back(id);
+            --count_;
+        }
+        id = next;
+    }
+    std::reverse(fired.begin() + firstFired, fired.end());
+
+    ++current_;
+}
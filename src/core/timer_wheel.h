@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Hierarchical timing wheel with one-second resolution.
+// Five levels of 64 slots cover 64^5 seconds (about 34 years); later timers are
+// parked in the top level and re-filed as time approaches. Scheduling and
+// cancelling are O(1); advancing costs O(1) per elapsed second plus O(1) per
+// timer that fires or cascades down a level, independent of how many timers
+// are pending.
+class TimerWheel {
+public:
+    using TimerId = uint32_t;
+    static constexpr TimerId kNoTimer = UINT32_MAX;
+
+    // Drop every timer and restart the clock at now
+    void reset(int64_t now);
+
+    // Timers due at or before the current time fire on the next advance().
+    // Ids are reused once a timer fires or is cancelled.
+    TimerId schedule(int64_t when, uint64_t payload);
+    void cancel(TimerId id);
+
+    // Process every second up to and including now, appending the payloads of
+    // expired timers to fired in expiry order
+    void advance(int64_t now, std::vector<uint64_t>& fired);
+
+    size_t size() const { return count_; }
+
+private:
+    static constexpr int kLevels = 5;
+    static constexpr int kSlotBits = 6;
+    static constexpr int kSlots = 1 << kSlotBits;
+    static constexpr uint32_t kNone = UINT32_MAX;
+
+    struct Node {
+        int64_t when = 0;
+        uint64_t payload = 0;
+        uint32_t prev = kNone;
+        uint32_t next = kNone;
+        uint16_t slot = 0;
+        bool live = false;
+    };
+
+    void link(uint32_t id);
+    void unlink(uint32_t id);
+    void tick(std::vector<uint64_t>& fired);
+
+    std::vector<Node> nodes_;
+    std::vector<uint32_t> free_;
+    uint32_t heads_[kLevels * kSlots] = {};
+    int64_t current_ = 0;   // next second to process
+    size_t count_ = 0;
+    bool initialized_ = false;
+};
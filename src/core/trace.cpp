@@ -0,0 +1,102 @@
+#include "core/trace.h"
+#include "core/logger.h"
+
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+using json = nlohmann::json;
+
+namespace {
+
+struct SpanRecord {
+    const char* name;
+    uint64_t startNs;
+    uint64_t durationNs;
+};
+
+// Single-writer ring: only the owning thread writes, the dumper reads
+struct ThreadBuffer {
+    uint32_t threadId = 0;
+    std::atomic<uint64_t> written{ 0 };
+    std::unique_ptr<SpanRecord[]> spans{ new SpanRecord[Trace::kRingCapacity] };
+};
+
+// Buffers are owned here so spans survive their thread; the mutex is only
+// taken once per thread (registration) and when dumping.
+std::mutex g_registryMutex;
+std::vector<std::unique_ptr<ThreadBuffer>> g_buffers;
+
+ThreadBuffer& localBuffer() {
+    thread_local ThreadBuffer* buffer = nullptr;
+    if (!buffer) {
+        auto owned = std::make_unique<ThreadBuffer>();
+        std::lock_guard<std::mutex> lock(g_registryMutex);
+        owned->threadId = static_cast<uint32_t>(g_buffers.size() + 1);
+        buffer = owned.get();
+        g_buffers.push_back(std::move(owned));
+    }
+    return *buffer;
+}
+
+const uint64_t g_epochNs = Trace::nowNs();
+
+}
+
+namespace Trace {
+
+uint64_t nowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void record(const char* name, uint64_t startNs, uint64_t endNs) {
+    ThreadBuffer& buffer = localBuffer();
+    uint64_t index = buffer.written.load(std::memory_order_relaxed);
+
+    buffer.spans[index % kRingCapacity] = { name, startNs, endNs - startNs };
+    buffer.written.store(index + 1, std::memory_order_release);
+}
+
+bool writeChromeTrace(const std::string& path) {
+    json events = json::array();
+
+    {
+        std::lock_guard<std::mutex> lock(g_registryMutex);
+        for (const auto& buffer : g_buffers) {
+            uint64_t written = buffer->written.load(std::memory_order_acquire);
+            uint64_t count = std::min<uint64_t>(written, kRingCapacity);
+
+            for (uint64_t i = written - count; i < written; ++i) {
+                const SpanRecord& span = buffer->spans[i % kRingCapacity];
+                uint64_t start = span.startNs > g_epochNs ? span.startNs - g_epochNs : 0;
+
+                events.push_back({
+                    { "name", span.name },
+                    { "ph", "X" },
+                    { "ts", start / 1000.0 },
+                    { "dur", span.durationNs / 1000.0 },
+                    { "pid", 1 },
+                    { "tid", buffer->threadId },
+                });
+            }
+        }
+    }
+
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        LOG_ERROR("Failed to open trace output file: {}", path);
+        return false;
+    }
+
+    json trace = { { "traceEvents", std::move(events) }, { "displayTimeUnit", "ms" } };
+    file << trace.dump();
+    return file.good();
+}
+
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// === Tracing ===
+// RAII spans recorded into per-thread ring buffers and dumped as Chrome
+// trace_event JSON (open in Perfetto or chrome://tracing).
+// GTD_TRACE_SCOPE compiles to nothing unless GTD_ENABLE_TRACING is defined.
+
+namespace Trace {
+
+#ifdef GTD_ENABLE_TRACING
+    constexpr bool kEnabled = true;
+#else
+    constexpr bool kEnabled = false;
+#endif
+
+    // Spans kept per thread; older ones are overwritten
+    constexpr size_t kRingCapacity = 1 << 16;
+
+    // Monotonic clock in nanoseconds
+    uint64_t nowNs();
+
+    // Record a completed span. `name` must outlive the trace (use string literals).
+    void record(const char* name, uint64_t startNs, uint64_t endNs);
+
+    // Write every buffered span to `path`. Call from a quiet point (e.g. shutdown);
+    // spans recorded while dumping may be missed.
+    bool writeChromeTrace(const std::string& path);
+
+    class ScopedSpan {
+    public:
+        explicit ScopedSpan(const char* name) : name_(name), startNs_(nowNs()) {}
+        ~ScopedSpan() { record(name_, startNs_, nowNs()); }
+
+        ScopedSpan(const ScopedSpan&) = delete;
+        ScopedSpan& operator=(const ScopedSpan&) = delete;
+
+    private:
+        const char* name_;
+        uint64_t startNs_;
+    };
+}
+
+#define GTD_TRACE_CONCAT_INNER(a, b) a##b
+#define GTD_TRACE_CONCAT(a, b) GTD_TRACE_CONCAT_INNER(a, b)
+
+#ifdef GTD_ENABLE_TRACING
+#define GTD_TRACE_SCOPE(name) ::Trace::ScopedSpan GTD_TRACE_CONCAT(gtdTraceSpan_, __LINE__)(name)
+#else
+#define GTD_TRACE_SCOPE(name) ((void)0)
+#endif
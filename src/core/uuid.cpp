@@ -0,0 +1,74 @@
+#include "core/uuid.h"
+
+namespace {
+
+int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// FNV-1a over the text, with a different offset for each half
+uint64_t hashText(std::string_view text, uint64_t basis) {
+    uint64_t h = basis;
+    for (char c : text) {
+        h ^= static_cast<uint8_t>(c);
+        h *= 0x100000001B3ull;
+    }
+    return h;
+}
+
+} // namespace
+
+bool Uuid::parse(std::string_view text, Uuid& out) {
+    const bool hyphenated = text.size() == 36;
+    if (!hyphenated && text.size() != 32) return false;
+
+    uint64_t halves[2] = { 0, 0 };
+    int digits = 0;
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (hyphenated && (i == 8 || i == 13 || i == 18 || i == 23)) {
+            if (text[i] != '-') return false;
+            continue;
+        }
+        int value = hexValue(text[i]);
+        if (value < 0) return false;
+        uint64_t& half = halves[digits / 16];
+        half = (half << 4) | static_cast<uint64_t>(value);
+        ++digits;
+    }
+
+    out.hi = halves[0];
+    out.lo = halves[1];
+    return true;
+}
+
+Uuid Uuid::fromText(std::string_view text) {
+    Uuid id;
+    if (!parse(text, id)) {
+        id.hi = hashText(text, 0xCBF29CE484222325ull);
+        id.lo = hashText(text, 0x84222325CBF29CE4ull);
+    }
+    return id;
+}
+
+void Uuid::format(char* out) const {
+    static const char kHex[] = "0123456789abcdef";
+    int digit = 0;
+    for (int i = 0; i < 36; ++i) {
+        if (i == 8 || i == 13 || i == 18 || i == 23) {
+            out[i] = '-';
+            continue;
+        }
+        uint64_t half = digit < 16 ? hi : lo;
+        out[i] = kHex[(half >> (60 - 4 * (digit % 16))) & 0xF];
+        ++digit;
+    }
+}
+
+std::string Uuid::toString() const {
+    std::string text(36, '\0');
+    format(&text[0]);
+    return text;
+}
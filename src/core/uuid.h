@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+
+// 128-bit UUID held as two integers, so comparing and hashing a key costs a
+// couple of instructions instead of a 36-character string compare.
+// hi holds the first 8 bytes in big-endian order, so integer order matches the
+// order of the canonical lowercase text.
+struct Uuid {
+    uint64_t hi = 0;
+    uint64_t lo = 0;
+
+    // Canonical 8-4-4-4-12 form or 32 bare hex digits, either case
+    static bool parse(std::string_view text, Uuid& out);
+
+    // parse(), or for keys that are not UUIDs a 128-bit hash of the text, so
+    // every key still gets a stable id. Only parsed ids round-trip toString().
+    static Uuid fromText(std::string_view text);
+
+    bool isNil() const { return hi == 0 && lo == 0; }
+
+    // Lowercase canonical form; format() writes exactly 36 chars, no terminator
+    void format(char* out) const;
+    std::string toString() const;
+
+    uint64_t hash() const {
+        // UUIDv4 bits are already random; the mix covers time-ordered and hashed ids
+        uint64_t h = hi ^ (lo * 0x9E3779B97F4A7C15ull);
+        h ^= h >> 32;
+        h *= 0xD6E8FEB86659FD93ull;
+        return h ^ (h >> 32);
+    }
+
+    friend bool operator==(const Uuid& a, const Uuid& b) { return a.hi == b.hi && a.lo == b.lo; }
+    friend bool operator!=(const Uuid& a, const Uuid& b) { return !(a == b); }
+    friend bool operator<(const Uuid& a, const Uuid& b) { return a.hi != b.hi ? a.hi < b.hi : a.lo < b.lo; }
+};
+
+template <>
+struct std::hash<Uuid> {
+    size_t operator()(const Uuid& id) const noexcept { return static_cast<size_t>(id.hash()); }
+};
@@ -0,0 +1,70 @@
+#include "core/uuid_index.h"
+
+#include <utility>
+
+void UuidIndex::clear() {
+    slots_.clear();
+    mask_ = 0;
+    size_ = 0;
+}
+
+void UuidIndex::reserve(size_t count) {
+    size_t capacity = 16;
+    while (capacity < count * 2) capacity *= 2;
+    if (capacity > slots_.size()) rehash(capacity);
+}
+
+void UuidIndex::rehash(size_t capacity) {
+    std::vector<Slot> old = std::exchange(slots_, std::vector<Slot>(capacity));
+    mask_ = capacity - 1;
+    size_ = 0;
+    for (const Slot& slot : old) {
+        if (slot.handle != kNotFound) insert(slot.id, slot.handle);
+    }
+}
+
+bool UuidIndex::insert(const Uuid& id, uint32_t handle) {
+    if ((size_ + 1) * 2 > slots_.size()) rehash(slots_.empty() ? 16 : slots_.size() * 2);
+
+    for (size_t i = home(id);; i = (i + 1) & mask_) {
+        Slot& slot = slots_[i];
+        if (slot.handle == kNotFound) {
+            slot.id = id;
+            slot.handle = handle;
+            ++size_;
+            return true;
+        }
+        if (slot.id == id) return false;
+    }
+}
+
+uint32_t UuidIndex::find(const Uuid& id) const {
+    if (size_ == 0) return kNotFound;
+    for (size_t i = home(id);; i = (i + 1) & mask_) {
+        const Slot& slot = slots_[i];
+        if (slot.handle == kNotFound) return kNotFound;
+        if (slot.id == id) return slot.handle;
+    }
+}
+
+bool UuidIndex::erase(const Uuid& id) {
+    if (size_ == 0) return false;
+
+    size_t hole = home(id);
+    while (slots_[hole].handle != kNotFound && slots_[hole].id != id) hole = (hole + 1) & mask_;
+    if (slots_[hole].handle == kNotFound) return false;
+
+    // Pull back any later entry of the run whose home is not between the hole
+    // and its own position, so every entry stays reachable from its home
+    for (size_t i = (hole + 1) & mask_; slots_[i].handle != kNotFound; i = (i + 1) & mask_) {
+        size_t want = home(slots_[i].id);
+        bool reachable = hole <= i ? (hole < want && want <= i) : (hole < want || want <= i);
+        if (!reachable) {
+            slots_[hole] = slots_[i];
+            hole = i;
+        }
+    }
+    slots_[hole] = Slot{};
+    --size_;
+    return true;
+}
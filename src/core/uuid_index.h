@@ -0,0 +1,40 @@
+#pragma once
+
+#include "core/uuid.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Open-addressing hash map from Uuid to a task handle (its index in the task
+// list). Linear probing over a power-of-two table kept at most half full, so a
+// lookup is usually one or two probes into one flat array; erase shifts the
+// following entries back instead of leaving tombstones.
+class UuidIndex {
+public:
+    static constexpr uint32_t kNotFound = UINT32_MAX;
+
+    void clear();
+    void reserve(size_t count);
+
+    // False (and the existing handle is kept) if id is already present
+    bool insert(const Uuid& id, uint32_t handle);
+    bool erase(const Uuid& id);
+
+    uint32_t find(const Uuid& id) const;
+    bool contains(const Uuid& id) const { return find(id) != kNotFound; }
+    size_t size() const { return size_; }
+
+private:
+    struct Slot {
+        Uuid id;
+        uint32_t handle = kNotFound;    // kNotFound marks an empty slot
+    };
+
+    size_t home(const Uuid& id) const { return static_cast<size_t>(id.hash()) & mask_; }
+    void rehash(size_t capacity);
+
+    std::vector<Slot> slots_;
+    size_t mask_ = 0;
+    size_t size_ = 0;
+};
@@ -1,68 +1,188 @@
-﻿#include "core/database.h"
-#include "core/config.h"
-#include "platform/windows/gui_win32.h"
-#include "core/lookup_maps.h"  // moved from ui/
-#include "core/database_registry.h"
-
-#include <mysql.h>
-#include <sqlite3.h>
-#include <iostream>
-#include <vector>
-#include <exception>
-
-int main() {
-    try {
-        std::cout << "[START] main()\n";
-
-        // === Load database connections ===
-        std::cout << "Loading database configs from: " << AppConfig::kDatabaseConfigPath << "\n";
-        if (!loadDatabaseConfigs(AppConfig::kDatabaseConfigPath)) {
-            std::cerr << " Failed to load database configs.\n";
-            return 1;
-        }
-
-        // === Load table mappings ===
-        std::cout << "Loading table mappings from: " << AppConfig::kTableMappingPath << "\n";
-        if (!loadTableMappings(AppConfig::kTableMappingPath)) {
-            std::cerr << " Failed to load table mappings.\n";
-            return 1;
-        }
-
-        std::cout << "[OK] Database configs and table mappings loaded.\n";
-
-        // === Populate lookup maps (automatically selects correct DB) ===
-        std::cout << "Calling populateLookupMaps()...\n";
-        populateLookupMaps();
-        std::cout << "[OK] Lookup tables populated.\n";
-
-        // === Load tasks from all databases ===
-        std::cout << "Fetching tasks from all databases...\n";
-        std::vector<Task> tasks = fetchTasksFromDatabase();
-        std::cout << "[OK] Fetched " << tasks.size() << " tasks.\n";
-
-        // === Launch GUI ===
-        std::cout << "Launching GUI...\n";
-        launch_gui(tasks);
-        std::cout << "[OK] GUI closed.\n";
-
-        // === Cleanup ===
-        std::cout << "Cleaning up...\n";
-        for (auto& db : allDatabases) {
-            if (db.type == DatabaseType::MYSQL) {
-                mysql_close(std::get<MYSQL*>(db.connection));
-            }
-            else if (db.type == DatabaseType::SQLITE) {
-                sqlite3_close(std::get<sqlite3*>(db.connection));
-            }
-        }
-        std::cout << "[END] main() finished cleanly.\n";
-    }
-    catch (const std::exception& e) {
-        std::cerr << "Unhandled exception : " << e.what() << std::endl;
-    }
-    catch (...) {
-        std::cerr << "Unhandled unknown exception.\n";
-    }
-
-    return 0;
+﻿#include "core/database.h"
+#include "core/config.h"
+#include "platform/windows/gui_win32.h"
+#include "core/lookup_maps.h"  // moved from ui/
+#include "core/database_registry.h"
+#include "core/schema_migrations.h"
+#include "core/trace.h"
+#include "core/logger.h"
+#include "core/notes_loader.h"
+#include "core/task_io.h"
+#include "core/task_generation.h"
+#include "core/task_query.h"
+#include "core/task_archive.h"
+#include "core/task_reconcile.h"
+
+#include <mysql.h>
+#include <sqlite3.h>
+#include <vector>
+#include <exception>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+
+// --export <file> / --import <file> [--db <id>]: bulk JSON Lines transfer without the GUI
+// --reconcile <id> [--db <id>]: merge the tasks of two databases (see task_reconcile.h)
+struct BulkCommand {
+    enum class Kind { None, Export, Import, Reconcile };
+    Kind kind = Kind::None;
+    std::string path;
+    int db_id = 0;
+    int peer_db_id = 0;
+};
+
+static bool parseCommandLine(int argc, char** argv, BulkCommand& command) {
+    for (int i = 1; i < argc; ++i) {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--export") == 0 && hasValue) {
+            command.kind = BulkCommand::Kind::Export;
+            command.path = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--import") == 0 && hasValue) {
+            command.kind = BulkCommand::Kind::Import;
+            command.path = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--reconcile") == 0 && hasValue) {
+            command.kind = BulkCommand::Kind::Reconcile;
+            command.peer_db_id = std::atoi(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--db") == 0 && hasValue) {
+            command.db_id = std::atoi(argv[++i]);
+        }
+        else {
+            LOG_ERROR("Unknown argument: {}", argv[i]);
+            LOG_ERROR("Usage: GTDApp [--export <file> | --import <file> | --reconcile <id>] [--db <id>]");
+            return false;
+        }
+    }
+    return true;
+}
+
+static void closeAllDatabases() {
+    for (auto& db : allDatabases) {
+        if (db.type == DatabaseType::MYSQL) {
+            mysql_close(std::get<MYSQL*>(db.connection));
+        }
+        else if (db.type == DatabaseType::SQLITE) {
+            sqlite3_close(db.sqliteReader);
+            sqlite3_close(std::get<sqlite3*>(db.connection));
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    Log::setLevel(AppConfig::kLogLevel);
+    Log::start(AppConfig::kLogFilePath);
+
+    BulkCommand command;
+    if (!parseCommandLine(argc, argv, command)) {
+        Log::stop();
+        return 1;
+    }
+
+    try {
+        LOG_INFO("[START] main()");
+
+        // === Load database connections ===
+        LOG_INFO("Loading database configs from: {}", AppConfig::kDatabaseConfigPath);
+        if (!loadDatabaseConfigs(AppConfig::kDatabaseConfigPath)) {
+            LOG_ERROR("Failed to load database configs.");
+            Log::stop();
+            return 1;
+        }
+
+        // === Load table mappings ===
+        LOG_INFO("Loading table mappings from: {}", AppConfig::kTableMappingPath);
+        if (!loadTableMappings(AppConfig::kTableMappingPath)) {
+            LOG_ERROR("Failed to load table mappings.");
+            Log::stop();
+            return 1;
+        }
+
+        LOG_INFO("[OK] Database configs and table mappings loaded.");
+
+        // === Bring schemas and indexes up to date ===
+        LOG_INFO("Checking database schemas...");
+        if (!migrateAllDatabases()) {
+            LOG_WARN("Schema check reported errors; continuing with existing schema.");
+        }
+        else {
+            LOG_INFO("[OK] Schemas at version {}.", kLatestSchemaVersion);
+        }
+
+        // === Bulk export / import / reconcile, then exit ===
+        if (command.kind != BulkCommand::Kind::None) {
+            bool ok = false;
+            switch (command.kind) {
+            case BulkCommand::Kind::Export:    ok = exportDatabaseToJsonl(command.db_id, command.path); break;
+            case BulkCommand::Kind::Import:    ok = importJsonlToDatabase(command.db_id, command.path); break;
+            case BulkCommand::Kind::Reconcile: ok = reconcileTaskStores(command.db_id, command.peer_db_id); break;
+            case BulkCommand::Kind::None:      break;
+            }
+            closeAllDatabases();
+            Log::stop();
+            return ok ? 0 : 1;
+        }
+
+        // === Move long-finished tasks to the archive tier ===
+        size_t archived = archiveAllDatabases(AppConfig::kArchiveAfterDays, AppConfig::kArchiveBatchSize);
+        if (archived > 0) {
+            LOG_INFO("[OK] Archived {} tasks done more than {} days ago.", archived, AppConfig::kArchiveAfterDays);
+        }
+
+        // === Populate lookup maps (automatically selects correct DB) ===
+        LOG_INFO("Calling populateLookupMaps()...");
+        populateLookupMaps();
+        LOG_INFO("[OK] Lookup tables populated.");
+        startLookupRefresh(AppConfig::kLookupRefreshInterval);
+
+        // === Load tasks from all databases ===
+        LOG_INFO("Fetching tasks from all databases...");
+        auto generation = std::make_unique<TaskGeneration>();
+        TaskFilterCriteria startFilter;
+        if (AppConfig::kStartWithOpenTasks) startFilter.is_done = false;
+        generation->tasks() = fetchTasksFromDatabase(generation->resource(), compileTaskFilter(startFilter));
+        generation->setLoadedFilter(startFilter);
+        LOG_INFO("[OK] Fetched {} tasks.", generation->tasks().size());
+        LOG_INFO("Task arena: {} allocations, {} bytes in {} heap blocks.",
+            generation->arenaStats().allocations, generation->arenaStats().bytesAllocated,
+            generation->heapStats().allocations);
+
+        // === Notes for lazy_notes databases are fetched when a card is flipped ===
+        bool anyLazyNotes = std::any_of(allDatabases.begin(), allDatabases.end(),
+            [](const DatabaseConnection& db) { return db.lazyNotes; });
+        if (anyLazyNotes) {
+            startNotesLoader(AppConfig::kNotesCacheBytes);
+        }
+
+        // === Launch GUI ===
+        LOG_INFO("Launching GUI...");
+        launch_gui(std::move(generation));
+        LOG_INFO("[OK] GUI closed.");
+
+        stopNotesLoader();
+        stopLookupRefresh();
+
+        // === Cleanup ===
+        LOG_INFO("Cleaning up...");
+        closeAllDatabases();
+
+        // === Dump trace (GTD_ENABLE_TRACING builds only) ===
+        if (Trace::kEnabled) {
+            LOG_INFO("Writing trace to: {}", AppConfig::kTraceOutputPath);
+            Trace::writeChromeTrace(AppConfig::kTraceOutputPath);
+        }
+        LOG_INFO("[END] main() finished cleanly.");
+    }
+    catch (const std::exception& e) {
+        LOG_ERROR("Unhandled exception : {}", e.what());
+    }
+    catch (...) {
+        LOG_ERROR("Unhandled unknown exception.");
+    }
+
+    Log::stop();
+    return 0;
 }
\ No newline at end of file
@@ -1,4 +1,4 @@
-#pragma once
-#include "core/task.h"
-#include <vector>
-void launch_gui(std::vector<Task>& tasks);
\ No newline at end of file
+#pragma once
+#include "core/task_generation.h"
+#include <memory>
+void launch_gui(std::unique_ptr<TaskGeneration> tasks);
\ No newline at end of file
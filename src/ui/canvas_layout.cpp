@@ -0,0 +1,219 @@
+#include "canvas_layout.h"
+#include "core/trace.h"
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
+namespace {
+
+const float kBaseCardWidth = 300.0f;
+const float kBaseCardHeight = 200.0f;
+const float kBaseSpacing = 20.0f;
+
+} // namespace
+
+bool CanvasLayout::update(const TaskOrdering& ordering, LayoutMode mode, float zoom, float availableWidth,
+                          const FreePositions& freePositions) {
+    const float lineHeight = ImGui::GetTextLineHeightWithSpacing();
+
+    if (built_ && orderGeneration_ == ordering.generation() && mode_ == mode) {
+        if (mode == LayoutMode::Free) {
+            if (zoom_ == zoom) return false;
+            zoom_ = zoom;
+            scaleFree();
+            ++generation_;
+            return true;
+        }
+        if (zoom_ == zoom && availableWidth_ == availableWidth &&
+            headerHeight_ == lineHeight + kBaseSpacing * zoom) {
+            return false;
+        }
+    }
+
+    GTD_TRACE_SCOPE("CanvasLayout::update");
+    built_ = true;
+    orderGeneration_ = ordering.generation();
+    mode_ = mode;
+    zoom_ = zoom;
+    availableWidth_ = availableWidth;
+
+    cardSize_ = ImVec2(kBaseCardWidth * zoom, kBaseCardHeight * zoom);
+    spacing_ = kBaseSpacing * zoom;
+    headerHeight_ = lineHeight + spacing_;
+
+    positions_.resize(ordering.order().size());
+    headers_.clear();
+    columns_.clear();
+
+    if (mode == LayoutMode::Free) {
+        layoutFree(ordering, availableWidth, freePositions);
+    }
+    else if (mode == LayoutMode::Lanes && ordering.groupField() != GroupField::None) {
+        layoutLanes(ordering);
+    }
+    else {
+        layoutGrid(ordering, availableWidth);
+    }
+
+    ++generation_;
+    return true;
+}
+
+void CanvasLayout::layoutGrid(const TaskOrdering& ordering, float availableWidth) {
+    const bool grouped = ordering.groupField() != GroupField::None;
+    const float stepX = cardSize_.x + spacing_;
+    const float stepY = cardSize_.y + spacing_;
+    const int cardsPerRow = std::max(1, int((availableWidth + spacing_) / stepX));
+
+    // One band per group: a header line, then the group's cards in rows.
+    // Rows only move down, so the whole grid is a single y-sorted column.
+    float bandTop = 0.0f;
+    const std::vector<TaskGroup>& groups = ordering.groups();
+    for (size_t g = 0; g < groups.size(); ++g) {
+        const TaskGroup& group = groups[g];
+        if (grouped) {
+            headers_.push_back({ ImVec2(0.0f, bandTop), cardsPerRow * stepX - spacing_, g });
+            bandTop += headerHeight_;
+        }
+
+        for (size_t k = group.begin; k < group.end; ++k) {
+            size_t i = k - group.begin;
+            positions_[k] = ImVec2((i % cardsPerRow) * stepX, bandTop + (i / cardsPerRow) * stepY);
+        }
+
+        size_t rows = (group.end - group.begin + cardsPerRow - 1) / cardsPerRow;
+        bandTop += rows * stepY;
+    }
+
+    size_t widest = std::min<size_t>(ordering.order().size(), cardsPerRow);
+    columns_.push_back({ 0, positions_.size(), 0.0f, widest * stepX });
+    contentSize_ = ImVec2(widest * stepX, bandTop);
+}
+
+void CanvasLayout::layoutLanes(const TaskOrdering& ordering) {
+    const float laneStep = cardSize_.x + spacing_ * 2.0f;
+    const float stepY = cardSize_.y + spacing_;
+    float tallest = 0.0f;
+
+    const std::vector<TaskGroup>& groups = ordering.groups();
+    for (size_t g = 0; g < groups.size(); ++g) {
+        const TaskGroup& group = groups[g];
+        const float x = g * laneStep;
+        headers_.push_back({ ImVec2(x, 0.0f), cardSize_.x, g });
+
+        for (size_t k = group.begin; k < group.end; ++k) {
+            positions_[k] = ImVec2(x, headerHeight_ + (k - group.begin) * stepY);
+        }
+
+        columns_.push_back({ group.begin, group.end, x, x + cardSize_.x });
+        tallest = std::max(tallest, headerHeight_ + (group.end - group.begin) * stepY);
+    }
+
+    contentSize_ = ImVec2(groups.size() * laneStep, tallest);
+}
+
+void CanvasLayout::layoutFree(const TaskOrdering& ordering, float availableWidth, const FreePositions& freePositions) {
+    const std::vector<size_t>& order = ordering.order();
+    const float stepX = kBaseCardWidth + kBaseSpacing;
+    const float stepY = kBaseCardHeight + kBaseSpacing;
+    const int cardsPerRow = std::max(1, int((availableWidth / zoom_ + kBaseSpacing) / stepX));
+
+    // Cards never exceed one cell, so each is indexed in at most four
+    index_.clear(2.0f * std::max(kBaseCardWidth, kBaseCardHeight));
+    index_.reserve(order.size());
+    basePositions_.resize(order.size());
+
+    size_t unplaced = 0;
+    for (size_t k = 0; k < order.size(); ++k) {
+        size_t taskIndex = order[k];
+        if (taskIndex < freePositions.size() && freePositions[taskIndex]) {
+            basePositions_[k] = *freePositions[taskIndex];
+        }
+        else {
+            basePositions_[k] = ImVec2((unplaced % cardsPerRow) * stepX, (unplaced / cardsPerRow) * stepY);
+            ++unplaced;
+        }
+        const ImVec2& p = basePositions_[k];
+        index_.insert(static_cast<uint32_t>(k), p, ImVec2(p.x + kBaseCardWidth, p.y + kBaseCardHeight));
+    }
+
+    scaleFree();
+}
+
+void CanvasLayout::scaleFree() {
+    cardSize_ = ImVec2(kBaseCardWidth * zoom_, kBaseCardHeight * zoom_);
+    spacing_ = kBaseSpacing * zoom_;
+
+    ImVec2 extent(0, 0);
+    positions_.resize(basePositions_.size());
+    for (size_t k = 0; k < basePositions_.size(); ++k) {
+        positions_[k] = ImVec2(basePositions_[k].x * zoom_, basePositions_[k].y * zoom_);
+        extent.x = std::max(extent.x, positions_[k].x + cardSize_.x);
+        extent.y = std::max(extent.y, positions_[k].y + cardSize_.y);
+    }
+    contentSize_ = extent;
+}
+
+ImVec2 CanvasLayout::moveCard(size_t k, const ImVec2& screenDelta) {
+    ImVec2& base = basePositions_[k];
+    base.x += screenDelta.x / zoom_;
+    base.y += screenDelta.y / zoom_;
+    index_.move(static_cast<uint32_t>(k), base, ImVec2(base.x + kBaseCardWidth, base.y + kBaseCardHeight));
+
+    positions_[k] = ImVec2(base.x * zoom_, base.y * zoom_);
+    contentSize_.x = std::max(contentSize_.x, positions_[k].x + cardSize_.x);
+    contentSize_.y = std::max(contentSize_.y, positions_[k].y + cardSize_.y);
+    return base;
+}
+
+void CanvasLayout::query(const ImVec2& min, const ImVec2& max, std::vector<size_t>& out) const {
+    out.clear();
+    if (mode_ == LayoutMode::Free) {
+        index_.query(ImVec2(min.x / zoom_, min.y / zoom_), ImVec2(max.x / zoom_, max.y / zoom_), out);
+        std::sort(out.begin(), out.end());   // stable draw order for overlapping cards
+        return;
+    }
+    for (const Column& column : columns_) {
+        if (column.maxX <= min.x || column.minX >= max.x) continue;
+
+        // y is non-decreasing within a column and all cards are equally tall
+        auto first = std::partition_point(positions_.begin() + column.begin, positions_.begin() + column.end,
+            [&](const ImVec2& p) { return p.y + cardSize_.y <= min.y; });
+
+        for (auto it = first; it != positions_.begin() + column.end && it->y < max.y; ++it) {
+            if (it->x < max.x && it->x + cardSize_.x > min.x) {
+                out.push_back(static_cast<size_t>(it - positions_.begin()));
+            }
+        }
+    }
+}
+
+const std::vector<DensityTile>& CanvasLayout::densityTiles(const TaskOrdering& ordering, float tileSize) {
+    if (tilesGeneration_ == generation_ && tileSize_ == tileSize) return tiles_;
+
+    GTD_TRACE_SCOPE("CanvasLayout::densityTiles");
+    tilesGeneration_ = generation_;
+    tileSize_ = tileSize;
+    tiles_.clear();
+    maxTileCount_ = 0;
+
+    const std::vector<TaskGroup>& groups = ordering.groups();
+    std::unordered_map<uint64_t, uint32_t> tileIndex;
+    for (size_t g = 0; g < groups.size(); ++g) {
+        tileIndex.clear();
+        for (size_t k = groups[g].begin; k < groups[g].end && k < positions_.size(); ++k) {
+            const int32_t tx = static_cast<int32_t>(std::floor(positions_[k].x / tileSize));
+            const int32_t ty = static_cast<int32_t>(std::floor(positions_[k].y / tileSize));
+            const uint64_t key = (static_cast<uint64_t>(static_cast<uint32_t>(tx)) << 32) | static_cast<uint32_t>(ty);
+
+            auto [it, inserted] = tileIndex.emplace(key, static_cast<uint32_t>(tiles_.size()));
+            if (inserted) {
+                tiles_.push_back({ ImVec2(tx * tileSize, ty * tileSize), 0, static_cast<uint32_t>(g) });
+            }
+            DensityTile& tile = tiles_[it->second];
+            maxTileCount_ = std::max(maxTileCount_, ++tile.count);
+        }
+    }
+    return tiles_;
+}
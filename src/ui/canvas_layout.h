@@ -0,0 +1,97 @@
+#pragma once
+
+#include "task_order.h"
+#include "spatial_grid.h"
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+#include <imgui.h>
+
+enum class LayoutMode {
+    Grid,    // cards in rows; one band per group when grouped
+    Lanes,   // one column per group (kanban); a plain grid when ungrouped
+    Free,    // saved per-card positions; unplaced cards start on a grid
+};
+
+// Saved free-form positions in canvas units at zoom 1, indexed by task index
+using FreePositions = std::vector<std::optional<ImVec2>>;
+
+// Number of cards of one group whose top-left corner falls in a square tile
+struct DensityTile {
+    ImVec2   min;         // canvas space
+    uint32_t count = 0;
+    uint32_t group = 0;   // index into TaskOrdering::groups()
+};
+
+// Header drawn above a band or lane
+struct LayoutHeader {
+    ImVec2 pos;           // canvas space
+    float  width = 0.0f;
+    size_t group = 0;     // index into TaskOrdering::groups()
+};
+
+// Card positions for the current ordering, computed only when the ordering,
+// mode, zoom or available width change. Positions are in canvas space (before
+// panning) and parallel to TaskOrdering::order(); all cards share one size.
+class CanvasLayout {
+public:
+    // Recomputes if anything the layout depends on changed; returns true if it did.
+    // In Free mode a zoom change only rescales, and width changes are ignored.
+    bool update(const TaskOrdering& ordering, LayoutMode mode, float zoom, float availableWidth,
+                const FreePositions& freePositions);
+
+    // Free mode: move the card at order position k by a screen-space delta.
+    // Returns its new position in canvas units at zoom 1.
+    ImVec2 moveCard(size_t k, const ImVec2& screenDelta);
+
+    const std::vector<ImVec2>& positions() const { return positions_; }
+    const std::vector<LayoutHeader>& headers() const { return headers_; }
+    ImVec2 cardSize() const { return cardSize_; }
+    ImVec2 contentSize() const { return contentSize_; }
+    uint64_t generation() const { return generation_; }
+
+    // Order positions of cards intersecting [min, max) in canvas space
+    void query(const ImVec2& min, const ImVec2& max, std::vector<size_t>& out) const;
+
+    // Per-group card counts in tiles of tileSize (canvas space), for drawing the
+    // board zoomed far out. Rebuilt only when the layout or tile size changed.
+    const std::vector<DensityTile>& densityTiles(const TaskOrdering& ordering, float tileSize);
+    uint32_t maxTileCount() const { return maxTileCount_; }
+
+private:
+    // A run of positions whose y never decreases: the whole grid, or one lane
+    struct Column {
+        size_t begin = 0;
+        size_t end = 0;
+        float  minX = 0.0f;
+        float  maxX = 0.0f;
+    };
+
+    void layoutGrid(const TaskOrdering& ordering, float availableWidth);
+    void layoutLanes(const TaskOrdering& ordering);
+    void layoutFree(const TaskOrdering& ordering, float availableWidth, const FreePositions& freePositions);
+    void scaleFree();
+
+    std::vector<ImVec2>       positions_;
+    std::vector<LayoutHeader> headers_;
+    std::vector<Column>       columns_;
+    std::vector<ImVec2>       basePositions_;   // Free mode, zoom 1
+    SpatialGrid               index_;           // Free mode, over basePositions_
+    std::vector<DensityTile>  tiles_;
+    uint64_t                  tilesGeneration_ = 0;
+    float                     tileSize_ = 0.0f;
+    uint32_t                  maxTileCount_ = 0;
+    ImVec2 cardSize_ = ImVec2(0, 0);
+    ImVec2 contentSize_ = ImVec2(0, 0);
+    float  spacing_ = 0.0f;
+    float  headerHeight_ = 0.0f;
+
+    // Inputs of the last build
+    bool       built_ = false;
+    uint64_t   orderGeneration_ = 0;
+    LayoutMode mode_ = LayoutMode::Grid;
+    float      zoom_ = 0.0f;
+    float      availableWidth_ = 0.0f;
+    uint64_t   generation_ = 0;
+};
@@ -1,132 +1,750 @@
-#include "canvas_view.h"
-#include <imgui.h>
-#include <algorithm> // std::clamp, std::max
-
-CanvasView::CanvasView()
-    : panOffset_(0, 0)
-    , lastMousePos_(0, 0)
-    , zoom_(1.0f)
-    , scaleText_(false)
-{
-    // Default: no constraints (show all)
-    filter_.in_focus.reset();
-    filter_.is_done.reset();
-}
-
-void CanvasView::setTasks(std::vector<Task>& tasks) {
-    // Keep our own storage so CardView(Task&) stays valid
-    allTasks_ = tasks;
-    applyFilter();
-}
-
-void CanvasView::setFilterCriteria(const TaskFilterCriteria& criteria) {
-    filter_ = criteria;
-    applyFilter();
-}
-
-bool CanvasView::taskMatchesFilter(const Task& t) const {
-    if (filter_.is_done.has_value() && t.is_done != filter_.is_done.value())   return false;
-    if (filter_.in_focus.has_value() && t.in_focus != filter_.in_focus.value())  return false;
-    // (extend with category/context/topic/delegate/project later)
-    return true;
-}
-
-void CanvasView::applyFilter() {
-    cards_.clear();
-    cards_.reserve(allTasks_.size());
-    for (Task& t : allTasks_) {
-        if (taskMatchesFilter(t)) {
-            cards_.emplace_back(t); // CardView(Task&)
-        }
-    }
-}
-
-void CanvasView::render() {
-    ImGuiIO& io = ImGui::GetIO();
-
-    // Apply current zoom/font for this frame (affects card layout)
-    zoom_ = std::clamp(zoom_, 0.5f, 3.0f);
-    io.FontGlobalScale = scaleText_ ? zoom_ : 1.0f;
-
-    // === Canvas content (pannable area) ===
-    ImGui::BeginChild("CanvasRegion", ImVec2(0, 0), false,
-        ImGuiWindowFlags_NoScrollWithMouse | ImGuiWindowFlags_NoScrollbar);
-
-    ImVec2 origin = ImGui::GetCursorScreenPos();
-
-    // Right-button drag to pan the board
-    if (ImGui::IsMouseDragging(ImGuiMouseButton_Right)) {
-        ImVec2 delta = io.MouseDelta;
-        panOffset_.x += delta.x;
-        panOffset_.y += delta.y;
-    }
-
-    // Layout
-    const float baseCardWidth = 300.0f;
-    const float baseCardHeight = 200.0f;
-    const float spacing = 20.0f * zoom_;
-    const float cardWidth = baseCardWidth * zoom_;
-    const float cardHeight = baseCardHeight * zoom_;
-
-    int cardsPerRow = std::max(1, int((ImGui::GetContentRegionAvail().x + spacing) / (cardWidth + spacing)));
-
-    for (size_t i = 0; i < cards_.size(); ++i) {
-        int row = int(i / cardsPerRow);
-        int col = int(i % cardsPerRow);
-
-        ImVec2 pos(
-            origin.x + panOffset_.x + col * (cardWidth + spacing),
-            origin.y + panOffset_.y + row * (cardHeight + spacing)
-        );
-
-        ImGui::SetCursorScreenPos(pos);
-        cards_[i].draw(zoom_);
-    }
-
-    ImGui::EndChild();
-
-    // === Floating Controls Overlay (always on top; not panned) ===
-    ImGui::SetNextWindowPos(ImVec2(10, 10), ImGuiCond_Always);    // relative to parent window
-    ImGui::SetNextWindowBgAlpha(0.9f);
-
-    ImGuiWindowFlags ctrlFlags =
-        ImGuiWindowFlags_NoTitleBar |
-        ImGuiWindowFlags_AlwaysAutoResize |
-        ImGuiWindowFlags_NoSavedSettings |
-        ImGuiWindowFlags_NoFocusOnAppearing |
-        ImGuiWindowFlags_NoNav;
-
-    bool uiChanged = false;
-    if (ImGui::Begin("Canvas Controls", nullptr, ctrlFlags)) {
-        uiChanged |= ImGui::SliderFloat("Zoom", &zoom_, 0.5f, 3.0f, "%.1fx");
-        uiChanged |= ImGui::Checkbox("Scale Text", &scaleText_);
-
-        ImGui::Separator();
-        ImGui::Text("Filter");
-
-        // Done tri-state: 0=Any, 1=Done, 2=Not done
-        int doneState = 0;
-        if (filter_.is_done.has_value()) doneState = filter_.is_done.value() ? 1 : 2;
-        const char* doneItems[] = { "Any", "Done", "Not done" };
-        if (ImGui::Combo("Done", &doneState, doneItems, 3)) {
-            if (doneState == 0) filter_.is_done.reset();
-            else                filter_.is_done = (doneState == 1);
-            uiChanged = true;
-        }
-
-        // Focus tri-state: 0=Any, 1=In Focus, 2=Not in Focus
-        int focusState = 0;
-        if (filter_.in_focus.has_value()) focusState = filter_.in_focus.value() ? 1 : 2;
-        const char* focusItems[] = { "Any", "In Focus", "Not in Focus" };
-        if (ImGui::Combo("Focus", &focusState, focusItems, 3)) {
-            if (focusState == 0) filter_.in_focus.reset();
-            else                 filter_.in_focus = (focusState == 1);
-            uiChanged = true;
-        }
-    }
-    ImGui::End();
-
-    if (uiChanged) {
-        applyFilter(); // reflect changes next frame
-    }
+#include "canvas_view.h"
+#include "core/trace.h"
+#include "core/database_registry.h"
+#include "core/card_positions.h"
+#include "core/database.h"
+#include "core/date_time.h"
+#include "core/notes_loader.h"
+#include "core/lookup_maps.h"
+#include "core/logger.h"
+#include "core/task_query.h"
+#include <imgui.h>
+#include <algorithm> // std::clamp, std::max
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+// Rows of one tier (Tasks or TasksArchive) that `filter` selects and no filter
+// in `loaded` did. The filter is recorded as loaded only if every database
+// answered, and then `widened` is set; otherwise the rows that did arrive are
+// returned and the next application of the filter asks again.
+std::vector<Task> fetchMissingTasks(const TaskFilterCriteria& filter, std::vector<TaskFilterCriteria>& loaded,
+                                    bool archive, std::pmr::memory_resource* resource, bool& widened) {
+    for (const TaskFilterCriteria& previous : loaded) {
+        if (criteriaCovers(previous, filter)) return {};
+    }
+
+    GTD_TRACE_SCOPE("fetchMissingTasks");
+    TaskQuery query = compileTaskFilter(filter, loaded);
+    query.archive = archive;
+    bool ok = false;
+    std::vector<Task> fetched = fetchTasksFromDatabase(resource, query, &ok);
+    if (!ok) {
+        LOG_WARN("Not every database answered the {} fetch; it is retried when the filter is next applied.",
+            archive ? "archive" : "task");
+        return fetched;
+    }
+
+    // Loaded filters the new one subsumes no longer need excluding
+    loaded.erase(std::remove_if(loaded.begin(), loaded.end(),
+        [&filter](const TaskFilterCriteria& previous) { return criteriaCovers(filter, previous); }), loaded.end());
+    loaded.push_back(filter);
+    widened = true;
+    return fetched;
+}
+
+// Level of detail: full cards at or above kCardDetailZoom, flat rectangles down
+// to kDensityZoom, and per-group density tiles below that.
+const float kMinZoom = 0.02f;
+const float kMaxZoom = 3.0f;
+const float kCardDetailZoom = 0.45f;
+const float kDensityZoom = 0.08f;
+const float kDensityTilePixels = 12.0f;
+
+ImU32 groupColor(size_t group, float alpha) {
+    float hue = std::fmod(group * 0.618034f, 1.0f);
+    return ImColor::HSV(hue, 0.55f, 0.85f, alpha);
+}
+
+ImU32 statusColor(const Task& t, bool overdue) {
+    if (t.is_done)  return IM_COL32(80, 150, 90, 255);
+    if (overdue)    return IM_COL32(190, 60, 50, 255);
+    if (t.in_focus) return IM_COL32(200, 160, 40, 255);
+    return IM_COL32(70, 90, 120, 255);
+}
+
+} // namespace
+
+CanvasView::CanvasView()
+    : panOffset_(0, 0)
+    , lastMousePos_(0, 0)
+    , zoom_(1.0f)
+    , scaleText_(false)
+    , layoutMode_(LayoutMode::Grid)
+    , dragOrderPos_(SIZE_MAX)
+    , focusTask_(SIZE_MAX)
+    , showLinks_(true)
+    , orderPositionsGeneration_(0)
+    , showPerformance_(false)
+    , visibleCards_(0)
+    , sortField_(SortField::Manual)
+    , groupField_(GroupField::None)
+    , sortDescending_(false)
+{
+    // Default: no constraints (show all)
+    filter_.in_focus.reset();
+    filter_.is_done.reset();
+}
+
+void CanvasView::setTasks(std::unique_ptr<TaskGeneration> generation) {
+    // Drop everything that points into the old generation before freeing it
+    textCache_.clear();   // keyed by Task address
+    cards_.clear();
+    allTasks_.clear();
+    // Keep our own vector so CardView(Task&) stays valid; the strings stay in the arena
+    allTasks_.swap(generation->tasks());
+    generation_ = std::move(generation);
+
+    taskIndex_.clear();
+    taskIndex_.reserve(allTasks_.size());
+    for (size_t i = 0; i < allTasks_.size(); ++i) {
+        if (!taskIndex_.insert(allTasks_[i].id, static_cast<uint32_t>(i))) {
+            LOG_WARN("Task {} is loaded from more than one database; links resolve to the first copy.", allTasks_[i].uuid);
+        }
+    }
+    freePositions_.clear();
+
+    // Start on the filter the tasks were fetched with
+    filter_ = generation_->loadedFilter();
+    loadedFilters_.assign(1, filter_);
+    loadedArchiveFilters_.clear();
+
+    indexTasks();
+    countUnloadedDone();
+    applyFilter();
+}
+
+// Per-task state after a load, or after a fetch appended tasks to allTasks_.
+// Cards and free positions are only added for tasks that have none yet; the
+// graph, timers, totals and search index are rebuilt. The caller keeps taskIndex_.
+void CanvasView::indexTasks() {
+    cards_.reserve(allTasks_.size());
+    for (size_t i = cards_.size(); i < allTasks_.size(); ++i) {
+        cards_.emplace_back(allTasks_[i], &textCache_);
+    }
+
+    {
+        GTD_TRACE_SCOPE("TaskGraph::rebuild");
+        graph_.rebuild(allTasks_, taskIndex_);
+    }
+    if (graph_.cyclicEdgeCount() > 0) {
+        LOG_WARN("{} task links form cycles; the tasks involved stay blocked until a link is removed.",
+            graph_.cyclicEdgeCount());
+    }
+    orderPositions_.clear();
+
+    size_t firstNew = freePositions_.size();
+    freePositions_.resize(allTasks_.size());
+    for (const auto& [id, position] : loadCardPositions()) {
+        size_t i = findTask(id);
+        if (i != SIZE_MAX && i >= firstNew) freePositions_[i] = ImVec2(position.x, position.y);
+    }
+
+    int64_t now = localNowSeconds();
+    scheduler_.reset(allTasks_, now);
+    for (size_t i = 0; i < allTasks_.size(); ++i) {
+        cards_[i].setOverdue(scheduler_.overdue(i));
+        cards_[i].setBlocked(graph_.blocked(i));
+    }
+    aggregates_.reset(allTasks_, scheduler_, now);
+    quickFind_.rebuild(allTasks_);
+}
+
+// A filter no earlier fetch covers pulls in just the rows it adds:
+// `new AND NOT (old1 OR old2 ...)`. Narrowing never drops rows. The archive
+// holds only long-done tasks and is read unless the filter excludes done ones.
+// These rows go on the heap: the arena only holds the load it was made for.
+void CanvasView::loadMissingTasks() {
+    if (!generation_) return;
+    std::pmr::memory_resource* heap = std::pmr::get_default_resource();
+    bool widened = false;
+    std::vector<Task> fetched = fetchMissingTasks(filter_, loadedFilters_, false, heap, widened);
+    if (filter_.is_done != false) {
+        std::vector<Task> archived = fetchMissingTasks(filter_, loadedArchiveFilters_, true, heap, widened);
+        fetched.insert(fetched.end(), std::make_move_iterator(archived.begin()), std::make_move_iterator(archived.end()));
+    }
+    // The fetched rows all match a loaded filter, so they need no correction
+    if (widened) countUnloadedDone();
+    if (fetched.empty()) return;
+
+    // A row can match both filters if it changed since the earlier fetch (a
+    // task marked done here); the copy in memory wins
+    const Task* before = allTasks_.data();
+    size_t added = 0;
+    for (Task& t : fetched) {
+        if (!taskIndex_.insert(t.id, static_cast<uint32_t>(allTasks_.size()))) continue;
+        allTasks_.push_back(std::move(t));
+        ++added;
+    }
+    LOG_INFO("Filter fetched {} more tasks ({} already loaded).", added, fetched.size() - added);
+    if (added == 0) return;
+
+    // CardView and the title cache hold Task addresses. Cards are re-pointed
+    // rather than rebuilt, so a flipped card keeps its side and unsaved notes.
+    if (allTasks_.data() != before) {
+        textCache_.clear();
+        for (size_t i = 0; i < cards_.size(); ++i) cards_[i].rebind(allTasks_[i]);
+    }
+    indexTasks();
+}
+
+// Done tasks outside allTasks_ (not fetched by the loaded filters, or archived)
+// are counted in the databases so the dashboard's done totals cover every task.
+// A task in memory that is done but matches no loaded filter of its tier was
+// marked done after it was fetched; the count sees its row too, so take it back.
+void CanvasView::countUnloadedDone() {
+    GTD_TRACE_SCOPE("CanvasView::countUnloadedDone");
+    TaskFilterCriteria done;
+    done.is_done = true;
+    const int64_t weekStart = aggregates_.weekStart();
+    const std::string since = formatDateTime(weekStart);
+
+    bool ok = false;
+    bool archiveOk = false;
+    std::vector<DoneTaskGroup> groups = countDoneTasks(compileTaskFilter(done, loadedFilters_), since, &ok);
+    TaskQuery archiveQuery = compileTaskFilter(done, loadedArchiveFilters_);
+    archiveQuery.archive = true;
+    std::vector<DoneTaskGroup> archived = countDoneTasks(archiveQuery, since, &archiveOk);
+    if (!ok || !archiveOk) {
+        LOG_WARN("Not every database answered the done count; the dashboard keeps its previous done totals.");
+        return;
+    }
+    groups.insert(groups.end(), archived.begin(), archived.end());
+
+    for (const Task& t : allTasks_) {
+        if (!t.is_done) continue;
+        const std::vector<TaskFilterCriteria>& loaded = t.archived ? loadedArchiveFilters_ : loadedFilters_;
+        if (std::any_of(loaded.begin(), loaded.end(),
+                [&t](const TaskFilterCriteria& filter) { return taskMatchesCriteria(t, filter); })) continue;
+
+        DoneTaskGroup group;
+        group.category_id = t.category_id;
+        group.context_id = t.context_id;
+        if (t.project_uuid) group.project_uuid.emplace(*t.project_uuid);
+        group.topic_id = t.topic_id;
+        group.delegated_to = t.delegated_to;
+        group.db_id = t.db_id;
+        group.count = -1;
+        std::optional<int64_t> completed = t.completed_at ? parseDateTime(*t.completed_at) : std::nullopt;
+        group.doneThisWeek = completed && *completed >= weekStart ? -1 : 0;
+        group.minutes = -t.time_required_minutes.value_or(0);
+        groups.push_back(std::move(group));
+    }
+    aggregates_.setUnloadedDone(groups);
+}
+
+size_t CanvasView::findTask(const Uuid& id) const {
+    uint32_t handle = taskIndex_.find(id);
+    return handle != UuidIndex::kNotFound ? handle : SIZE_MAX;
+}
+
+void CanvasView::setFilterCriteria(const TaskFilterCriteria& criteria) {
+    filter_ = criteria;
+    applyFilter();
+}
+
+bool CanvasView::taskMatchesFilter(size_t taskIndex) const {
+    if (!filter_.show_deferred && scheduler_.deferred(taskIndex))             return false;
+    if (filter_.next_actions_only && !graph_.isNextAction(taskIndex))          return false;
+    return taskMatchesCriteria(allTasks_[taskIndex], filter_);
+}
+
+void CanvasView::applyFilter() {
+    GTD_TRACE_SCOPE("CanvasView::applyFilter");
+    loadMissingTasks();
+
+    std::vector<size_t> matching;
+    matching.reserve(allTasks_.size());
+    for (size_t i = 0; i < allTasks_.size(); ++i) {
+        if (taskMatchesFilter(i)) {
+            matching.push_back(i);
+        }
+    }
+
+    ordering_.configure(sortField_, groupField_, sortDescending_);
+    ordering_.rebuild(allTasks_, matching);
+}
+
+void CanvasView::refreshLookupLabels() {
+    GTD_TRACE_SCOPE("CanvasView::refreshLookupLabels");
+    {
+        LookupReadGuard lookups;
+        for (Task& t : allTasks_) applyLookupLabels(t, *lookups);
+    }
+    quickFind_.rebuild(allTasks_);
+    applyFilter();
+}
+
+void CanvasView::onTaskChanged(size_t taskIndex) {
+    bool wasDeferred = scheduler_.deferred(taskIndex);
+    scheduler_.reschedule(allTasks_[taskIndex], taskIndex, localNowSeconds());
+    cards_[taskIndex].setOverdue(scheduler_.overdue(taskIndex));
+    aggregates_.update(taskIndex, allTasks_[taskIndex], scheduler_.overdue(taskIndex));
+    quickFind_.updateTask(taskIndex, allTasks_[taskIndex]);
+
+    // Completing or relinking a task can unblock (or block) its successors.
+    // They move in or out of a next-actions view now; the edited task itself
+    // follows the same rule as any other edit below.
+    for (size_t changed : graph_.updateTask(allTasks_, taskIndex_, taskIndex)) {
+        cards_[changed].setBlocked(graph_.blocked(changed));
+        if (!filter_.next_actions_only || changed == taskIndex) continue;
+        if (!graph_.isNextAction(changed)) ordering_.remove(changed);
+        else if (taskMatchesFilter(changed)) ordering_.insert(allTasks_, changed);
+    }
+
+    // A new defer date hides the card (or an earlier one reveals it) right away;
+    // otherwise it stays visible until the filter is reapplied, even if it no longer matches
+    if (!filter_.show_deferred && scheduler_.deferred(taskIndex) != wasDeferred) {
+        if (scheduler_.deferred(taskIndex)) ordering_.remove(taskIndex);
+        else if (taskMatchesFilter(taskIndex)) ordering_.insert(allTasks_, taskIndex);
+        return;
+    }
+    ordering_.update(allTasks_, taskIndex);
+}
+
+// Only the tasks whose timers expired are touched; nothing rescans the list
+void CanvasView::processScheduledEvents() {
+    int64_t now = localNowSeconds();
+    aggregates_.advanceClock(now);
+    for (const ScheduledFire& fire : scheduler_.advance(now)) {
+        Task& task = allTasks_[fire.taskIndex];
+        if (fire.event == ScheduleEvent::DeferEnded) {
+            if (!filter_.show_deferred && taskMatchesFilter(fire.taskIndex)) {
+                ordering_.insert(allTasks_, fire.taskIndex);
+            }
+            continue;
+        }
+
+        // Due: pull the task into focus once and persist that
+        cards_[fire.taskIndex].setOverdue(true);
+        if (!task.is_done && !task.in_focus) {
+            task.in_focus = true;
+            saveTaskToDatabase(task);
+            onTaskChanged(fire.taskIndex);
+        }
+        else {
+            aggregates_.update(fire.taskIndex, task, true);
+        }
+    }
+}
+
+void CanvasView::focusTask(size_t taskIndex) {
+    if (taskIndex >= allTasks_.size()) return;
+    ordering_.insert(allTasks_, taskIndex);     // no-op when already shown
+    zoom_ = std::max(zoom_, kCardDetailZoom);
+    focusTask_ = taskIndex;
+}
+
+void CanvasView::onCardDropped(size_t taskIndex) {
+    const ImVec2& pos = *freePositions_[taskIndex];
+    saveCardPosition(allTasks_[taskIndex].uuid, CardPosition{ pos.x, pos.y });
+}
+
+void CanvasView::render() {
+    GTD_TRACE_SCOPE("CanvasView::render");
+    ImGuiIO& io = ImGui::GetIO();
+
+    // Apply current zoom/font for this frame (affects card layout).
+    // The font scale moves in zoom buckets so cached title layouts stay valid.
+    zoom_ = std::clamp(zoom_, kMinZoom, kMaxZoom);
+    float fontScale = scaleText_ ? std::max(TextLayoutCache::quantizeZoom(zoom_), 0.5f) : 1.0f;
+    if (io.FontGlobalScale != fontScale) {
+        io.FontGlobalScale = fontScale;
+    }
+
+    if (io.DeltaTime > 0.0f) {
+        frameTimes_.recordNs(static_cast<uint64_t>(io.DeltaTime * 1e9f));
+    }
+
+    // The background refresh published new lookup data: relabel and regroup
+    if (ordering_.lookupVersion() != lookupVersion()) {
+        refreshLookupLabels();
+    }
+
+    processScheduledEvents();
+
+    if (ImGui::Shortcut(ImGuiMod_Ctrl | ImGuiKey_P, ImGuiInputFlags_RouteGlobal)) {
+        quickFind_.open();
+    }
+    size_t found = quickFind_.render(allTasks_);
+    if (found != SIZE_MAX) {
+        focusTask(found);
+    }
+
+    // === Canvas content (pannable area) ===
+    ImGui::BeginChild("CanvasRegion", ImVec2(0, 0), false,
+        ImGuiWindowFlags_NoScrollWithMouse | ImGuiWindowFlags_NoScrollbar);
+
+    ImVec2 origin = ImGui::GetCursorScreenPos();
+    ImVec2 canvasMin = ImGui::GetWindowPos();
+    ImVec2 canvasMax(canvasMin.x + ImGui::GetWindowWidth(), canvasMin.y + ImGui::GetWindowHeight());
+
+    // Right-button drag to pan the board
+    if (ImGui::IsMouseDragging(ImGuiMouseButton_Right)) {
+        ImVec2 delta = io.MouseDelta;
+        panOffset_.x += delta.x;
+        panOffset_.y += delta.y;
+    }
+
+    // Layout (recomputed only when the ordering, mode, zoom or width changed)
+    layout_.update(ordering_, layoutMode_, zoom_, ImGui::GetContentRegionAvail().x, freePositions_);
+
+    // Centre the card picked in quick-find now that it has a position
+    if (focusTask_ != SIZE_MAX) {
+        const std::vector<size_t>& order = ordering_.order();
+        auto it = std::find(order.begin(), order.end(), focusTask_);
+        if (it != order.end()) {
+            const ImVec2& pos = layout_.positions()[it - order.begin()];
+            const ImVec2 size = layout_.cardSize();
+            panOffset_.x = (canvasMin.x + canvasMax.x) * 0.5f - origin.x - (pos.x + size.x * 0.5f);
+            panOffset_.y = (canvasMin.y + canvasMax.y) * 0.5f - origin.y - (pos.y + size.y * 0.5f);
+        }
+        focusTask_ = SIZE_MAX;
+    }
+
+    const ImVec2 base(origin.x + panOffset_.x, origin.y + panOffset_.y);
+    const ImVec2 viewMin(canvasMin.x - base.x, canvasMin.y - base.y);
+    const ImVec2 viewMax(canvasMax.x - base.x, canvasMax.y - base.y);
+    const float lineHeight = ImGui::GetTextLineHeight();
+
+    for (const LayoutHeader& header : layout_.headers()) {
+        if (header.width < lineHeight * 4.0f) continue;   // lanes too narrow for a label
+        if (header.pos.x > viewMax.x || header.pos.x + header.width < viewMin.x ||
+            header.pos.y > viewMax.y || header.pos.y + lineHeight < viewMin.y) {
+            continue;
+        }
+        const TaskGroup& group = ordering_.groups()[header.group];
+        ImGui::SetCursorScreenPos(ImVec2(base.x + header.pos.x, base.y + header.pos.y));
+        ImGui::Text("%s (%zu)", group.label.c_str(), group.end - group.begin);
+    }
+
+    if (zoom_ < kDensityZoom) {
+        drawDensityTiles(base, viewMin, viewMax);
+    }
+    else if (zoom_ < kCardDetailZoom) {
+        drawCardRects(base, viewMin, viewMax);
+    }
+    else {
+        drawCards(base, viewMin, viewMax);
+    }
+    if (showLinks_ && zoom_ >= kDensityZoom && graph_.edgeCount() > 0) {
+        drawLinks(base, viewMin, viewMax);
+    }
+
+    ImGui::EndChild();
+
+    renderControls();
+}
+
+void CanvasView::drawCards(const ImVec2& base, const ImVec2& viewMin, const ImVec2& viewMax) {
+    const ImGuiIO& io = ImGui::GetIO();
+
+    // Only cards intersecting the canvas are submitted
+    const std::vector<size_t>& order = ordering_.order();
+    const std::vector<ImVec2>& positions = layout_.positions();
+    const bool freeLayout = layoutMode_ == LayoutMode::Free;
+    std::vector<size_t> editedTasks;
+
+    layout_.query(viewMin, viewMax, visible_);
+    visibleCards_ = visible_.size();
+
+    // The dragged card is drawn last (on top), and even off-screen so ImGui keeps it active
+    if (dragOrderPos_ != SIZE_MAX) {
+        if (!freeLayout || dragOrderPos_ >= order.size()) {
+            dragOrderPos_ = SIZE_MAX;
+        }
+        else {
+            visible_.erase(std::remove(visible_.begin(), visible_.end(), dragOrderPos_), visible_.end());
+            visible_.push_back(dragOrderPos_);
+        }
+    }
+
+    size_t dragged = SIZE_MAX;
+    size_t dropped = SIZE_MAX;
+    for (size_t k : visible_) {
+        CardView& card = cards_[order[k]];
+        ImGui::SetCursorScreenPos(ImVec2(base.x + positions[k].x, base.y + positions[k].y));
+        if (card.draw(zoom_, freeLayout)) {
+            editedTasks.push_back(order[k]);
+        }
+        if (card.dragActive()) dragged = k;
+        if (card.dropped()) dropped = k;
+    }
+
+    // Reorder after drawing so order() is not modified mid-iteration
+    for (size_t taskIndex : editedTasks) {
+        onTaskChanged(taskIndex);
+    }
+
+    // Drag moves are O(1) updates of the layout's spatial index
+    dragOrderPos_ = dragged;
+    if (dragged != SIZE_MAX && (io.MouseDelta.x != 0.0f || io.MouseDelta.y != 0.0f)) {
+        freePositions_[order[dragged]] = layout_.moveCard(dragged, io.MouseDelta);
+    }
+    if (dropped != SIZE_MAX && freePositions_[order[dropped]]) {
+        onCardDropped(order[dropped]);
+    }
+}
+
+void CanvasView::drawCardRects(const ImVec2& base, const ImVec2& viewMin, const ImVec2& viewMax) {
+    // Draw-list only: no child windows, no widgets, no text wrapping
+    ImDrawList* drawList = ImGui::GetWindowDrawList();
+    const std::vector<size_t>& order = ordering_.order();
+    const std::vector<ImVec2>& positions = layout_.positions();
+    const ImVec2 size = layout_.cardSize();
+    const float rounding = 4.0f * zoom_;
+
+    ImFont* font = ImGui::GetFont();
+    const float fontSize = ImGui::GetFontSize();
+    const bool titles = size.y >= fontSize + 4.0f;
+
+    layout_.query(viewMin, viewMax, visible_);
+    visibleCards_ = visible_.size();
+    for (size_t k : visible_) {
+        const Task& task = allTasks_[order[k]];
+        ImVec2 min(base.x + positions[k].x, base.y + positions[k].y);
+        ImVec2 max(min.x + size.x, min.y + size.y);
+
+        drawList->AddRectFilled(min, max, statusColor(task, scheduler_.overdue(order[k])), rounding);
+        if (!titles) continue;
+
+        // First line of the title, clipped to the card
+        const char* begin = task.title.c_str();
+        const char* end = begin + task.title.size();
+        const char* newline = static_cast<const char*>(std::memchr(begin, '\n', task.title.size()));
+        if (newline) end = newline;
+
+        ImVec4 clip(min.x + 3.0f, min.y, max.x - 3.0f, max.y);
+        drawList->AddText(font, fontSize, ImVec2(min.x + 3.0f, min.y + 2.0f), IM_COL32_WHITE, begin, end, 0.0f, &clip);
+    }
+}
+
+// Connectors run from the right edge of a predecessor to the left edge of its
+// successor. Edges into visible cards are drawn from the card's side; edges out
+// of a visible card only when the successor is off-screen, so none is drawn twice.
+// The lines go on the canvas draw list, so full cards (child windows) cover them.
+void CanvasView::drawLinks(const ImVec2& base, const ImVec2& viewMin, const ImVec2& viewMax) {
+    const std::vector<size_t>& order = ordering_.order();
+    const std::vector<ImVec2>& positions = layout_.positions();
+    if (positions.size() != order.size()) return;  // an edit this frame changed the order; laid out next frame
+    if (orderPositionsGeneration_ != ordering_.generation() || orderPositions_.size() != allTasks_.size()) {
+        orderPositions_.assign(allTasks_.size(), UINT32_MAX);
+        for (size_t k = 0; k < order.size(); ++k) {
+            orderPositions_[order[k]] = static_cast<uint32_t>(k);
+        }
+        orderPositionsGeneration_ = ordering_.generation();
+    }
+
+    ImDrawList* drawList = ImGui::GetWindowDrawList();
+    const ImVec2 size = layout_.cardSize();
+    const float thickness = std::max(1.5f * zoom_, 1.0f);
+    const float arrow = std::max(6.0f * zoom_, 3.0f);
+
+    auto onScreen = [&](uint32_t k) {
+        const ImVec2& pos = positions[k];
+        return pos.x <= viewMax.x && pos.x + size.x >= viewMin.x && pos.y <= viewMax.y && pos.y + size.y >= viewMin.y;
+    };
+    auto connect = [&](size_t from, size_t to) {
+        uint32_t fromPos = orderPositions_[from];
+        uint32_t toPos = orderPositions_[to];
+        if (fromPos == UINT32_MAX || toPos == UINT32_MAX) return;
+
+        ImU32 color = graph_.isCyclic(static_cast<uint32_t>(from), static_cast<uint32_t>(to)) ? IM_COL32(220, 60, 50, 220)
+            : allTasks_[from].is_done ? IM_COL32(140, 140, 140, 160)
+            : IM_COL32(240, 170, 50, 220);
+        ImVec2 p0(base.x + positions[fromPos].x + size.x, base.y + positions[fromPos].y + size.y * 0.5f);
+        ImVec2 p1(base.x + positions[toPos].x, base.y + positions[toPos].y + size.y * 0.5f);
+        float bend = std::max(std::fabs(p1.x - p0.x) * 0.5f, 40.0f * zoom_);
+        drawList->AddBezierCubic(p0, ImVec2(p0.x + bend, p0.y), ImVec2(p1.x - bend, p1.y), p1, color, thickness);
+        drawList->AddTriangleFilled(p1, ImVec2(p1.x - arrow, p1.y - arrow * 0.6f), ImVec2(p1.x - arrow, p1.y + arrow * 0.6f), color);
+    };
+
+    for (size_t k : visible_) {
+        if (k >= order.size()) continue;
+        size_t taskIndex = order[k];
+        for (uint32_t from : graph_.predecessors(taskIndex)) {
+            connect(from, taskIndex);
+        }
+        for (uint32_t to : graph_.successors(taskIndex)) {
+            uint32_t toPos = orderPositions_[to];
+            if (toPos != UINT32_MAX && !onScreen(toPos)) connect(taskIndex, to);
+        }
+    }
+}
+
+void CanvasView::drawDensityTiles(const ImVec2& base, const ImVec2& viewMin, const ImVec2& viewMax) {
+    ImDrawList* drawList = ImGui::GetWindowDrawList();
+    const std::vector<DensityTile>& tiles = layout_.densityTiles(ordering_, kDensityTilePixels);
+    const float maxCount = static_cast<float>(std::max(layout_.maxTileCount(), 1u));
+    const ImVec2 mouse = ImGui::GetIO().MousePos;
+    const bool hovered = ImGui::IsWindowHovered();
+
+    visibleCards_ = 0;
+    const DensityTile* hoveredTile = nullptr;
+    for (const DensityTile& tile : tiles) {
+        if (tile.min.x > viewMax.x || tile.min.x + kDensityTilePixels < viewMin.x ||
+            tile.min.y > viewMax.y || tile.min.y + kDensityTilePixels < viewMin.y) {
+            continue;
+        }
+        visibleCards_ += tile.count;
+
+        ImVec2 min(base.x + tile.min.x, base.y + tile.min.y);
+        ImVec2 max(min.x + kDensityTilePixels, min.y + kDensityTilePixels);
+        float alpha = 0.25f + 0.75f * (tile.count / maxCount);
+        drawList->AddRectFilled(min, max, groupColor(tile.group, alpha));
+
+        if (hovered && mouse.x >= min.x && mouse.x < max.x && mouse.y >= min.y && mouse.y < max.y) {
+            hoveredTile = &tile;
+        }
+    }
+
+    if (hoveredTile) {
+        const TaskGroup& group = ordering_.groups()[hoveredTile->group];
+        ImGui::SetTooltip("%s%s%u tasks", group.label.c_str(), group.label.empty() ? "" : ": ", hoveredTile->count);
+    }
+}
+
+void CanvasView::renderControls() {
+    // === Floating Controls Overlay (always on top; not panned) ===
+    ImGui::SetNextWindowPos(ImVec2(10, 10), ImGuiCond_Always);    // relative to parent window
+    ImGui::SetNextWindowBgAlpha(0.9f);
+
+    ImGuiWindowFlags ctrlFlags =
+        ImGuiWindowFlags_NoTitleBar |
+        ImGuiWindowFlags_AlwaysAutoResize |
+        ImGuiWindowFlags_NoSavedSettings |
+        ImGuiWindowFlags_NoFocusOnAppearing |
+        ImGuiWindowFlags_NoNav;
+
+    bool uiChanged = false;
+    if (ImGui::Begin("Canvas Controls", nullptr, ctrlFlags)) {
+        ImGui::SliderFloat("Zoom", &zoom_, kMinZoom, kMaxZoom, "%.2fx", ImGuiSliderFlags_Logarithmic);
+        ImGui::Checkbox("Scale Text", &scaleText_);
+
+        ImGui::Separator();
+        ImGui::Text("Filter");
+
+        // Done tri-state: 0=Any, 1=Done, 2=Not done
+        int doneState = 0;
+        if (filter_.is_done.has_value()) doneState = filter_.is_done.value() ? 1 : 2;
+        const char* doneItems[] = { "Any", "Done", "Not done" };
+        if (ImGui::Combo("Done", &doneState, doneItems, 3)) {
+            if (doneState == 0) filter_.is_done.reset();
+            else                filter_.is_done = (doneState == 1);
+            uiChanged = true;
+        }
+
+        // Focus tri-state: 0=Any, 1=In Focus, 2=Not in Focus
+        int focusState = 0;
+        if (filter_.in_focus.has_value()) focusState = filter_.in_focus.value() ? 1 : 2;
+        const char* focusItems[] = { "Any", "In Focus", "Not in Focus" };
+        if (ImGui::Combo("Focus", &focusState, focusItems, 3)) {
+            if (focusState == 0) filter_.in_focus.reset();
+            else                 filter_.in_focus = (focusState == 1);
+            uiChanged = true;
+        }
+        uiChanged |= ImGui::Checkbox("Show deferred", &filter_.show_deferred);
+        uiChanged |= ImGui::Checkbox("Next actions only", &filter_.next_actions_only);
+
+        ImGui::Separator();
+        ImGui::Text("Order");
+
+        const char* sortItems[] = { "Load order", "Due date", "Defer date", "Created", "Title", "Project", "Context" };
+        int sortIndex = static_cast<int>(sortField_);
+        if (ImGui::Combo("Sort", &sortIndex, sortItems, IM_ARRAYSIZE(sortItems))) {
+            sortField_ = static_cast<SortField>(sortIndex);
+            uiChanged = true;
+        }
+        uiChanged |= ImGui::Checkbox("Descending", &sortDescending_);
+
+        const char* groupItems[] = { "None", "Project", "Context", "Category", "Status" };
+        int groupIndex = static_cast<int>(groupField_);
+        if (ImGui::Combo("Group", &groupIndex, groupItems, IM_ARRAYSIZE(groupItems))) {
+            groupField_ = static_cast<GroupField>(groupIndex);
+            uiChanged = true;
+        }
+
+        // Lanes put each group in its own column; Free uses dragged positions
+        int layoutIndex = static_cast<int>(layoutMode_);
+        const char* layoutItems[] = { "Grid", "Lanes", "Free" };
+        if (ImGui::Combo("Layout", &layoutIndex, layoutItems, IM_ARRAYSIZE(layoutItems))) {
+            layoutMode_ = static_cast<LayoutMode>(layoutIndex);
+        }
+        ImGui::Checkbox("Show links", &showLinks_);
+
+        ImGui::Separator();
+        ImGui::Checkbox("Performance", &showPerformance_);
+        if (showPerformance_) {
+            renderPerformancePanel();
+        }
+    }
+    ImGui::End();
+
+    if (uiChanged) {
+        applyFilter(); // reflect changes next frame
+    }
+}
+
+void CanvasView::renderPerformancePanel() {
+    const ImGuiIO& io = ImGui::GetIO();
+    auto ms = [](uint64_t ns) { return ns / 1e6; };
+
+    ImGui::Text("Frame  p50 %.2f  p90 %.2f  p99 %.2f  max %.2f ms",
+        ms(frameTimes_.percentileNs(50)), ms(frameTimes_.percentileNs(90)),
+        ms(frameTimes_.percentileNs(99)), ms(frameTimes_.maxNs()));
+    ImGui::Text("Cards  %zu visible / %zu shown / %zu total", visibleCards_, ordering_.order().size(), allTasks_.size());
+    ImGui::Text("Detail %s", zoom_ < kDensityZoom ? "density tiles" : zoom_ < kCardDetailZoom ? "rectangles" : "full cards");
+    ImGui::Text("ImGui  %d vertices, %d indices", io.MetricsRenderVertices, io.MetricsRenderIndices);
+    ImGui::Text("Text   %zu cached titles, %llu hits / %llu misses", textCache_.size(),
+        static_cast<unsigned long long>(textCache_.hits()), static_cast<unsigned long long>(textCache_.misses()));
+
+    NotesCacheStats notes = notesCacheStats();
+    if (notes.capacityBytes > 0) {
+        ImGui::Text("Notes  %zu cached, %.1f / %.1f MB, %zu loading, %llu hits / %llu misses",
+            notes.entries, notes.bytes / 1048576.0, notes.capacityBytes / 1048576.0, notes.pending,
+            static_cast<unsigned long long>(notes.hits), static_cast<unsigned long long>(notes.misses));
+    }
+    ImGui::Text("Timers %zu pending defer/due dates", scheduler_.pending());
+    ImGui::Text("Graph  %zu links, %zu in cycles", graph_.edgeCount(), graph_.cyclicEdgeCount());
+    if (generation_) {
+        const AllocatorStats& arena = generation_->arenaStats();
+        ImGui::Text("Arena  %llu allocations, %.1f MB used / %.1f MB in %llu blocks",
+            static_cast<unsigned long long>(arena.allocations), arena.bytesAllocated / 1048576.0,
+            generation_->heapStats().bytesAllocated / 1048576.0,
+            static_cast<unsigned long long>(generation_->heapStats().allocations));
+    }
+    if (ImGui::SmallButton("Reset frame stats")) {
+        frameTimes_.reset();
+    }
+
+    // One bar per power of two in microseconds (1us, 2us, 4us, ...)
+    const int kBars = 32;
+    float bars[kBars];
+
+    for (size_t db_id = 0; db_id < databaseNames.size(); ++db_id) {
+        const DatabaseMetrics& metrics = databaseMetrics(static_cast<int>(db_id));
+
+        ImGui::PushID(static_cast<int>(db_id));
+        ImGui::SeparatorText(databaseNames[db_id].c_str());
+        ImGui::Text("Failed writes: %llu",
+            static_cast<unsigned long long>(metrics.failedWrites.load(std::memory_order_relaxed)));
+
+        const std::pair<const char*, const LatencyHistogram*> series[] = {
+            { "Fetch", &metrics.fetchLatency },
+            { "Save", &metrics.saveLatency },
+        };
+        for (const auto& [label, histogram] : series) {
+            char overlay[96];
+            std::snprintf(overlay, sizeof(overlay), "n=%llu p50 %.2f p99 %.2f ms",
+                static_cast<unsigned long long>(histogram->count()),
+                ms(histogram->percentileNs(50)), ms(histogram->percentileNs(99)));
+
+            int used = histogram->powerOfTwoCounts(bars, kBars);
+            ImGui::PlotHistogram(label, bars, std::max(used, 1), 0, overlay, 0.0f, FLT_MAX, ImVec2(260, 40));
+        }
+        ImGui::PopID();
+    }
 }
\ No newline at end of file
@@ -1,35 +1,102 @@
-#pragma once
-
-#include "core/task.h"
-#include "card_view.h"
-#include "task_filter_criteria.h"
-
-#include <vector>
-#include <imgui.h>
-
-class CanvasView {
-public:
-    CanvasView();
-
-    void setTasks(std::vector<Task>& tasks);
-    void render();
-    void setFilterCriteria(const TaskFilterCriteria& criteria);
-
-private:
-    // Data
-    std::vector<Task>    allTasks_;   // master list
-    std::vector<CardView> cards_;     // filtered views
-
-    // View state
-    ImVec2 panOffset_;                // panning offset
-    ImVec2 lastMousePos_;             // (reserved for future use)
-    float  zoom_;                     // zoom factor
-    bool   scaleText_;                // whether to scale fonts with zoom
-
-    // Filters
-    TaskFilterCriteria filter_;
-
-    // Helpers
-    void applyFilter();
-    bool taskMatchesFilter(const Task& t) const;
+#pragma once
+
+#include "core/task.h"
+#include "card_view.h"
+#include "core/task_filter_criteria.h"
+#include "task_order.h"
+#include "canvas_layout.h"
+#include "quick_find_view.h"
+#include "core/metrics.h"
+#include "core/task_aggregates.h"
+#include "core/task_scheduler.h"
+#include "core/task_generation.h"
+#include "core/uuid_index.h"
+#include "core/task_graph.h"
+
+#include <memory>
+#include <vector>
+#include <imgui.h>
+
+class CanvasView {
+public:
+    CanvasView();
+
+    // Takes over a loaded generation; the previous one is freed in one go
+    void setTasks(std::unique_ptr<TaskGeneration> generation);
+    void render();
+    void setFilterCriteria(const TaskFilterCriteria& criteria);
+
+    // Called after a card edits its task; repositions it without a full re-sort
+    void onTaskChanged(size_t taskIndex);
+
+    // Called when a card is released after dragging in Free layout
+    void onCardDropped(size_t taskIndex);
+
+    // Pan (and zoom in if needed) so the task's card is centred. A task hidden
+    // by the filter is shown until the filter is reapplied.
+    void focusTask(size_t taskIndex);
+
+    // Index into the task list of the task with this id, or SIZE_MAX
+    size_t findTask(const Uuid& id) const;
+
+    // Dashboard totals, kept current with every task edit
+    const TaskAggregates& aggregates() const { return aggregates_; }
+
+private:
+    // Data
+    std::unique_ptr<TaskGeneration> generation_;  // arena behind allTasks_' strings; outlives it
+    std::vector<Task>    allTasks_;   // master list
+    UuidIndex             taskIndex_; // task id -> index into allTasks_
+    TaskGraph             graph_;     // link_from / link_to dependencies, indexed like allTasks_
+    std::vector<CardView> cards_;     // one view per task, parallel to allTasks_
+    TaskOrdering          ordering_;  // filtered subset in display order, grouped
+    CanvasLayout          layout_;    // cached card positions for ordering_
+    std::vector<size_t>   visible_;   // order positions on screen this frame
+    FreePositions         freePositions_;  // saved positions, parallel to allTasks_
+    TextLayoutCache       textCache_; // wrapped card titles
+    TaskScheduler         scheduler_; // defer/due timers, indexed like allTasks_
+    TaskAggregates        aggregates_; // dashboard counts over allTasks_, plus done tasks not loaded
+    QuickFindView         quickFind_; // Ctrl+P palette over allTasks_
+
+    // View state
+    ImVec2 panOffset_;                // panning offset
+    ImVec2 lastMousePos_;             // (reserved for future use)
+    float  zoom_;                     // zoom factor
+    bool   scaleText_;                // whether to scale fonts with zoom
+    LayoutMode layoutMode_;           // grid/bands, lanes or free
+    size_t dragOrderPos_;             // card being dragged (order position), or SIZE_MAX
+    size_t focusTask_;                // task to centre once laid out, or SIZE_MAX
+    bool   showLinks_;                // draw dependency connectors between cards
+
+    // Order position of each shown task (UINT32_MAX if hidden), for connectors
+    std::vector<uint32_t> orderPositions_;
+    uint64_t orderPositionsGeneration_;
+
+    // Performance panel
+    bool   showPerformance_;          // show the metrics section in Canvas Controls
+    size_t visibleCards_;             // cards intersecting the canvas last frame
+    LatencyHistogram frameTimes_;     // frame-to-frame time
+
+    // Filters and ordering
+    TaskFilterCriteria filter_;
+    std::vector<TaskFilterCriteria> loadedFilters_;         // fetches from Tasks that make up allTasks_
+    std::vector<TaskFilterCriteria> loadedArchiveFilters_;  // same for TasksArchive
+    SortField  sortField_;
+    GroupField groupField_;
+    bool       sortDescending_;
+
+    // Helpers
+    void indexTasks();
+    void loadMissingTasks();
+    void countUnloadedDone();
+    void applyFilter();
+    void refreshLookupLabels();
+    void processScheduledEvents();
+    bool taskMatchesFilter(size_t taskIndex) const;
+    void renderControls();
+    void renderPerformancePanel();
+    void drawCards(const ImVec2& base, const ImVec2& viewMin, const ImVec2& viewMax);
+    void drawCardRects(const ImVec2& base, const ImVec2& viewMin, const ImVec2& viewMax);
+    void drawLinks(const ImVec2& base, const ImVec2& viewMin, const ImVec2& viewMax);
+    void drawDensityTiles(const ImVec2& base, const ImVec2& viewMin, const ImVec2& viewMax);
 };
\ No newline at end of file
@@ -1,234 +1,353 @@
-#include "card_view.h"
-#include "imgui.h"
-#include <vector>
-#include <string>
-#include <algorithm>
-#include "task.h"  
-#include <map>
-#include "core/lookup_maps.h"
-#include "core/database_registry.h"
-#include "core/database.h"
-
-CardView::CardView(Task& task)
-    : task_(task)
-{
-}
-
-void CardView::draw(float zoom) {
-    const float baseWidth = 300.0f;
-    const float baseHeight = 200.0f;
-    const float width = baseWidth * zoom;
-    const float height = baseHeight * zoom;
-
-    ImGui::BeginChild(task_.uuid.c_str(), ImVec2(width, height), true, ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoScrollbar);
-
-    if (ImGui::Button("Flip")) {
-        is_flipped_ = !is_flipped_;
-    }
-
-    ImGui::Separator();
-
-    if (is_flipped_) {
-        drawBack(zoom);
-    }
-    else {
-        drawFront(zoom);
-    }
-
-    ImGui::EndChild();
-}
-
-void CardView::drawFront(float zoom) {
-    ImGui::TextWrapped("%s", task_.title.c_str());
-
-    if (task_.in_focus) {
-        ImGui::TextColored(ImVec4(1.0f, 0.8f, 0.0f, 1.0f), "FOCUS");
-    }
-    if (task_.is_done) {
-        ImGui::TextColored(ImVec4(0.5f, 1.0f, 0.5f, 1.0f), "DONE");
-    }
-}
-
-void CardView::drawBack(float zoom) {
-    static char buffer[1024];
-    strncpy(buffer, task_.notes.c_str(), sizeof(buffer));
-    buffer[sizeof(buffer) - 1] = '\0';
-
-    bool changed = false;
-    bool dbChanged = false;
-    int originalDbId = task_.db_id;
-    int oldDbId = task_.db_id;
-
-    if (ImGui::InputTextMultiline("Notes", buffer, sizeof(buffer))) {
-        task_.notes = std::string(buffer);
-        changed = true;
-    }
-
-    if (ImGui::Checkbox("Done", &task_.is_done)) changed = true;
-    if (ImGui::Checkbox("In Focus", &task_.in_focus)) changed = true;
-
-    // === Category dropdown ===
-    {
-        std::vector<int> ids;
-        std::vector<std::string> labels;
-        for (const auto& [id, label] : categoryLookup) {
-            ids.push_back(id);
-            labels.push_back(label);
-        }
-
-        int selectedIndex = 0;
-        if (task_.category_id) {
-            auto it = std::find(ids.begin(), ids.end(), *task_.category_id);
-            if (it != ids.end()) selectedIndex = static_cast<int>(it - ids.begin());
-        }
-
-        if (ImGui::Combo("Category", &selectedIndex,
-            [](void* data, int idx, const char** out_text) {
-                auto& v = *static_cast<std::vector<std::string>*>(data);
-                *out_text = v[idx].c_str(); return true;
-            }, static_cast<void*>(&labels), static_cast<int>(labels.size()))) {
-            task_.category_id = ids[selectedIndex];
-            changed = true;
-        }
-    }
-
-    // === Context dropdown ===
-    {
-        std::vector<int> ids;
-        std::vector<std::string> labels;
-        for (const auto& [id, label] : contextLookup) {
-            ids.push_back(id);
-            labels.push_back(label);
-        }
-
-        int selectedIndex = 0;
-        if (task_.context_id) {
-            auto it = std::find(ids.begin(), ids.end(), *task_.context_id);
-            if (it != ids.end()) selectedIndex = static_cast<int>(it - ids.begin());
-        }
-
-        if (ImGui::Combo("Context", &selectedIndex,
-            [](void* data, int idx, const char** out_text) {
-                auto& v = *static_cast<std::vector<std::string>*>(data);
-                *out_text = v[idx].c_str(); return true;
-            }, static_cast<void*>(&labels), static_cast<int>(labels.size()))) {
-            task_.context_id = ids[selectedIndex];
-            changed = true;
-        }
-    }
-
-    // === Project dropdown ===
-    {
-        std::vector<std::string> uuids;
-        std::vector<std::string> titles;
-        for (const auto& [uuid, title] : projectLookup) {
-            uuids.push_back(uuid);
-            titles.push_back(title);
-        }
-
-        int selectedIndex = 0;
-        if (task_.project_uuid) {
-            auto it = std::find(uuids.begin(), uuids.end(), *task_.project_uuid);
-            if (it != uuids.end()) selectedIndex = static_cast<int>(it - uuids.begin());
-        }
-
-        if (ImGui::Combo("Project", &selectedIndex,
-            [](void* data, int idx, const char** out_text) {
-                auto& v = *static_cast<std::vector<std::string>*>(data);
-                *out_text = v[idx].c_str(); return true;
-            }, static_cast<void*>(&titles), static_cast<int>(titles.size()))) {
-            task_.project_uuid = uuids[selectedIndex];
-            changed = true;
-        }
-    }
-
-    // === Topic dropdown ===
-    {
-        std::vector<int> ids;
-        std::vector<std::string> labels;
-        for (const auto& [id, label] : topicLookup) {
-            ids.push_back(id);
-            labels.push_back(label);
-        }
-
-        int selectedIndex = 0;
-        if (task_.topic_id) {
-            auto it = std::find(ids.begin(), ids.end(), *task_.topic_id);
-            if (it != ids.end()) selectedIndex = static_cast<int>(it - ids.begin());
-        }
-
-        if (ImGui::Combo("Topic", &selectedIndex,
-            [](void* data, int idx, const char** out_text) {
-                auto& v = *static_cast<std::vector<std::string>*>(data);
-                *out_text = v[idx].c_str(); return true;
-            }, static_cast<void*>(&labels), static_cast<int>(labels.size()))) {
-            task_.topic_id = ids[selectedIndex];
-            changed = true;
-        }
-    }
-
-    // === Delegate dropdown ===
-    {
-        std::vector<int> ids;
-        std::vector<std::string> names;
-        for (const auto& [id, name] : personLookup) {
-            ids.push_back(id);
-            names.push_back(name);
-        }
-
-        int selectedIndex = 0;
-        if (task_.delegated_to) {
-            auto it = std::find(ids.begin(), ids.end(), *task_.delegated_to);
-            if (it != ids.end()) selectedIndex = static_cast<int>(it - ids.begin());
-        }
-
-        if (ImGui::Combo("Delegate", &selectedIndex,
-            [](void* data, int idx, const char** out_text) {
-                auto& v = *static_cast<std::vector<std::string>*>(data);
-                *out_text = v[idx].c_str(); return true;
-            }, static_cast<void*>(&names), static_cast<int>(names.size()))) {
-            task_.delegated_to = ids[selectedIndex];
-            changed = true;
-        }
-    }
-
-    // === Database dropdown ===
-    {
-        int selectedDb = task_.db_id;
-        if (ImGui::Combo("Database", &selectedDb,
-            [](void* data, int idx, const char** out_text) {
-                auto& v = *static_cast<std::vector<std::string>*>(data);
-                *out_text = v[idx].c_str(); return true;
-            }, static_cast<void*>(&databaseNames), static_cast<int>(databaseNames.size()))) {
-            if (selectedDb != task_.db_id) {
-                task_.db_id = selectedDb;
-                dbChanged = true;
-            }
-        }
-    }
-
-    ImGui::Separator();
-    ImGui::TextDisabled("Locked: %s", task_.is_locked ? "Yes" : "No");
-    ImGui::TextDisabled("Created: %s", task_.created_at ? task_.created_at->c_str() : "");
-    ImGui::TextDisabled("Defer:   %s", task_.defer_date ? task_.defer_date->c_str() : "");
-    ImGui::TextDisabled("Due:     %s", task_.due_date ? task_.due_date->c_str() : "");
-    ImGui::TextDisabled("Done at: %s", task_.completed_at ? task_.completed_at->c_str() : "");
-
-    ImGui::Separator();
-    if (ImGui::Button("Process")) {
-        // TODO
-    }
-
-    if (!task_.is_locked && ImGui::Button("Delete")) {
-        // TODO
-    }
-
-    if (changed || dbChanged) {
-        if (dbChanged && task_.db_id != originalDbId) {
-            moveTaskToDatabase(task_, oldDbId);
-        }
-        else {
-            saveTaskToDatabase(task_);
-        }
-    }
+#include "card_view.h"
+#include "imgui.h"
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cmath>
+#include "task.h"  
+#include <map>
+#include "core/lookup_maps.h"
+#include "core/database_registry.h"
+#include "core/database.h"
+#include "core/notes_loader.h"
+#include "core/task_generation.h"
+
+namespace {
+
+// Lets InputText grow the string it edits instead of a fixed char buffer
+template <typename String>
+int resizeStringCallback(ImGuiInputTextCallbackData* data) {
+    if (data->EventFlag == ImGuiInputTextFlags_CallbackResize) {
+        auto* str = static_cast<String*>(data->UserData);
+        str->resize(data->BufTextLen);
+        data->Buf = str->data();
+    }
+    return 0;
+}
+
+} // namespace
+
+CardView::CardView(Task& task, TextLayoutCache* textCache)
+    : task_(&task)
+    , text_cache_(textCache)
+{
+}
+
+bool CardView::draw(float zoom, bool movable) {
+    const float baseWidth = 300.0f;
+    const float baseHeight = 200.0f;
+    const float width = baseWidth * zoom;
+    const float height = baseHeight * zoom;
+
+    ImGui::BeginChild(task_->uuid.c_str(), ImVec2(width, height), true, ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoScrollbar);
+
+    bool edited = false;
+    if (ImGui::Button("Flip")) {
+        is_flipped_ = !is_flipped_;
+        if (is_flipped_) {
+            loadLinkBuffers();
+        }
+        else {
+            std::string().swap(link_from_edit_);
+            std::string().swap(link_to_edit_);
+            // The notes editor was not submitted this frame, so save what it left behind
+            if (notes_dirty_) {
+                saveTaskToDatabase(*task_);
+                notes_dirty_ = false;
+                edited = true;
+            }
+            releaseNotes();
+        }
+    }
+
+    drag_active_ = false;
+    dropped_ = false;
+    if (movable) {
+        ImGui::SameLine();
+        ImGui::Button("Move");
+        drag_active_ = ImGui::IsItemActive();
+        dropped_ = ImGui::IsItemDeactivated();
+    }
+
+    ImGui::Separator();
+
+    if (is_flipped_) {
+        edited = drawBack(zoom);
+    }
+    else {
+        drawFront(zoom);
+    }
+
+    ImGui::EndChild();
+    return edited;
+}
+
+void CardView::drawFront(float zoom) {
+    if (text_cache_) {
+        // Quantize the wrap width so small zoom steps keep the cached line breaks
+        ImFont* font = ImGui::GetFont();
+        float fontSize = ImGui::GetFontSize();
+        float wrapWidth = std::max(std::floor(ImGui::GetContentRegionAvail().x / 4.0f) * 4.0f, fontSize);
+        TextLayoutCache::draw(task_->title, text_cache_->title(*task_, font, fontSize, wrapWidth), font, fontSize);
+    }
+    else {
+        ImGui::TextWrapped("%s", task_->title.c_str());
+    }
+
+    if (task_->in_focus) {
+        ImGui::TextColored(ImVec4(1.0f, 0.8f, 0.0f, 1.0f), "FOCUS");
+    }
+    if (task_->is_done) {
+        ImGui::TextColored(ImVec4(0.5f, 1.0f, 0.5f, 1.0f), "DONE");
+    }
+    else if (overdue_) {
+        ImGui::TextColored(ImVec4(1.0f, 0.35f, 0.3f, 1.0f), "OVERDUE");
+    }
+    if (!task_->is_done && blocked_) {
+        ImGui::TextColored(ImVec4(1.0f, 0.65f, 0.2f, 1.0f), "BLOCKED");
+    }
+}
+
+void CardView::loadLinkBuffers() {
+    link_from_edit_.assign(task_->link_from ? task_->link_from->c_str() : "");
+    link_to_edit_.assign(task_->link_to ? task_->link_to->c_str() : "");
+}
+
+// Lazily loaded notes go back to the bounded cache when the card is closed
+void CardView::releaseNotes() {
+    if (!task_->notes_loaded || task_->db_id < 0 || task_->db_id >= static_cast<int>(allDatabases.size()) ||
+        !allDatabases[task_->db_id].lazyNotes) {
+        return;
+    }
+    cacheNotes(task_->uuid, std::string(task_->notes));
+    task_->notes.clear();
+    task_->notes.shrink_to_fit();
+    task_->notes_loaded = false;
+}
+
+bool CardView::drawBack(float zoom) {
+    // Notes and edits would otherwise allocate from the load's arena, which
+    // never gives memory back before the next load
+    moveTaskToHeap(*task_);
+
+    bool changed = false;
+    bool dbChanged = false;
+    int originalDbId = task_->db_id;
+    int oldDbId = task_->db_id;
+
+    if (!task_->notes_loaded) {
+        std::string notes;
+        NotesStatus status = requestNotes(task_->uuid, task_->db_id, notes);
+        if (status == NotesStatus::Ready) {
+            task_->notes = std::move(notes);
+            task_->notes_loaded = true;
+        }
+        else {
+            ImGui::TextDisabled(status == NotesStatus::Loading ? "Loading notes..." : "Notes unavailable");
+        }
+    }
+
+    // Edits go straight into task_->notes; the task is saved once the editor
+    // loses focus rather than on every keystroke
+    if (task_->notes_loaded) {
+        if (ImGui::InputTextMultiline("Notes", task_->notes.data(), task_->notes.capacity() + 1, ImVec2(0, 0),
+                                      ImGuiInputTextFlags_CallbackResize, resizeStringCallback<TaskString>, &task_->notes)) {
+            notes_dirty_ = true;
+        }
+        if (notes_dirty_ && !ImGui::IsItemActive()) {
+            notes_dirty_ = false;
+            changed = true;
+        }
+    }
+
+    LookupReadGuard lookups;
+
+    if (ImGui::Checkbox("Done", &task_->is_done)) changed = true;
+    if (ImGui::Checkbox("In Focus", &task_->in_focus)) changed = true;
+
+    // === Category dropdown ===
+    {
+        std::vector<int> ids;
+        std::vector<std::string> labels;
+        for (const auto& [id, label] : lookups->categories) {
+            ids.push_back(id);
+            labels.push_back(label);
+        }
+
+        int selectedIndex = 0;
+        if (task_->category_id) {
+            auto it = std::find(ids.begin(), ids.end(), *task_->category_id);
+            if (it != ids.end()) selectedIndex = static_cast<int>(it - ids.begin());
+        }
+
+        if (ImGui::Combo("Category", &selectedIndex,
+            [](void* data, int idx, const char** out_text) {
+                auto& v = *static_cast<std::vector<std::string>*>(data);
+                *out_text = v[idx].c_str(); return true;
+            }, static_cast<void*>(&labels), static_cast<int>(labels.size()))) {
+            task_->category_id = ids[selectedIndex];
+            changed = true;
+        }
+    }
+
+    // === Context dropdown ===
+    {
+        std::vector<int> ids;
+        std::vector<std::string> labels;
+        for (const auto& [id, label] : lookups->contexts) {
+            ids.push_back(id);
+            labels.push_back(label);
+        }
+
+        int selectedIndex = 0;
+        if (task_->context_id) {
+            auto it = std::find(ids.begin(), ids.end(), *task_->context_id);
+            if (it != ids.end()) selectedIndex = static_cast<int>(it - ids.begin());
+        }
+
+        if (ImGui::Combo("Context", &selectedIndex,
+            [](void* data, int idx, const char** out_text) {
+                auto& v = *static_cast<std::vector<std::string>*>(data);
+                *out_text = v[idx].c_str(); return true;
+            }, static_cast<void*>(&labels), static_cast<int>(labels.size()))) {
+            task_->context_id = ids[selectedIndex];
+            changed = true;
+        }
+    }
+
+    // === Project dropdown ===
+    {
+        std::vector<const LookupProject*> projects;
+        std::vector<std::string> titles;
+        int selectedIndex = 0;
+        for (const auto& [id, project] : lookups->projects) {
+            if (task_->project_uuid && id == task_->project_id) selectedIndex = static_cast<int>(projects.size());
+            projects.push_back(&project);
+            titles.push_back(project.name);
+        }
+
+        if (ImGui::Combo("Project", &selectedIndex,
+            [](void* data, int idx, const char** out_text) {
+                auto& v = *static_cast<std::vector<std::string>*>(data);
+                *out_text = v[idx].c_str(); return true;
+            }, static_cast<void*>(&titles), static_cast<int>(titles.size()))) {
+            task_->project_uuid.emplace(projects[selectedIndex]->uuid, task_->get_allocator());
+            task_->project_id = Uuid::fromText(*task_->project_uuid);
+            changed = true;
+        }
+    }
+
+    // === Topic dropdown ===
+    {
+        std::vector<int> ids;
+        std::vector<std::string> labels;
+        for (const auto& [id, label] : lookups->topics) {
+            ids.push_back(id);
+            labels.push_back(label);
+        }
+
+        int selectedIndex = 0;
+        if (task_->topic_id) {
+            auto it = std::find(ids.begin(), ids.end(), *task_->topic_id);
+            if (it != ids.end()) selectedIndex = static_cast<int>(it - ids.begin());
+        }
+
+        if (ImGui::Combo("Topic", &selectedIndex,
+            [](void* data, int idx, const char** out_text) {
+                auto& v = *static_cast<std::vector<std::string>*>(data);
+                *out_text = v[idx].c_str(); return true;
+            }, static_cast<void*>(&labels), static_cast<int>(labels.size()))) {
+            task_->topic_id = ids[selectedIndex];
+            changed = true;
+        }
+    }
+
+    // === Delegate dropdown ===
+    {
+        std::vector<int> ids;
+        std::vector<std::string> names;
+        for (const auto& [id, name] : lookups->people) {
+            ids.push_back(id);
+            names.push_back(name);
+        }
+
+        int selectedIndex = 0;
+        if (task_->delegated_to) {
+            auto it = std::find(ids.begin(), ids.end(), *task_->delegated_to);
+            if (it != ids.end()) selectedIndex = static_cast<int>(it - ids.begin());
+        }
+
+        if (ImGui::Combo("Delegate", &selectedIndex,
+            [](void* data, int idx, const char** out_text) {
+                auto& v = *static_cast<std::vector<std::string>*>(data);
+                *out_text = v[idx].c_str(); return true;
+            }, static_cast<void*>(&names), static_cast<int>(names.size()))) {
+            task_->delegated_to = ids[selectedIndex];
+            changed = true;
+        }
+    }
+
+    // === Database dropdown ===
+    {
+        int selectedDb = task_->db_id;
+        if (ImGui::Combo("Database", &selectedDb,
+            [](void* data, int idx, const char** out_text) {
+                auto& v = *static_cast<std::vector<std::string>*>(data);
+                *out_text = v[idx].c_str(); return true;
+            }, static_cast<void*>(&databaseNames), static_cast<int>(databaseNames.size()))) {
+            if (selectedDb != task_->db_id) {
+                task_->db_id = selectedDb;
+                dbChanged = true;
+            }
+        }
+    }
+
+    // === Links (task UUIDs; empty clears) ===
+    // Committed when the field loses focus so a half-typed id is never saved
+    {
+        auto linkField = [this](const char* label, std::string& edit, std::optional<TaskString>& link) {
+            ImGui::InputText(label, edit.data(), edit.capacity() + 1, ImGuiInputTextFlags_CallbackResize,
+                             resizeStringCallback<std::string>, &edit);
+            if (!ImGui::IsItemDeactivatedAfterEdit()) return false;
+            if (!edit.empty()) link.emplace(edit, task_->get_allocator());
+            else               link.reset();
+            task_->parseIds();
+            return true;
+        };
+        if (linkField("Depends on", link_from_edit_, task_->link_from)) changed = true;
+        if (linkField("Leads to", link_to_edit_, task_->link_to)) changed = true;
+        if (ImGui::SmallButton("Copy ID")) {
+            ImGui::SetClipboardText(task_->uuid.c_str());
+        }
+    }
+
+    ImGui::Separator();
+    ImGui::TextDisabled("Locked: %s", task_->is_locked ? "Yes" : "No");
+    ImGui::TextDisabled("Created: %s", task_->created_at ? task_->created_at->c_str() : "");
+    ImGui::TextDisabled("Defer:   %s", task_->defer_date ? task_->defer_date->c_str() : "");
+    ImGui::TextDisabled("Due:     %s", task_->due_date ? task_->due_date->c_str() : "");
+    ImGui::TextDisabled("Done at: %s", task_->completed_at ? task_->completed_at->c_str() : "");
+    if (task_->archived) {
+        ImGui::TextDisabled("Archived; saving an edit restores it");
+    }
+
+    ImGui::Separator();
+    if (ImGui::Button("Process")) {
+        // TODO
+    }
+
+    if (!task_->is_locked && ImGui::Button("Delete")) {
+        // TODO
+    }
+
+    if (changed || dbChanged) {
+        applyLookupLabels(*task_, *lookups);
+        if (dbChanged && task_->db_id != originalDbId) {
+            moveTaskToDatabase(*task_, oldDbId);
+        }
+        else {
+            saveTaskToDatabase(*task_);
+        }
+    }
+    return changed || dbChanged;
 }
\ No newline at end of file
@@ -1,24 +1,51 @@
-// card_view.h
-
-#ifndef CARD_VIEW_H
-#define CARD_VIEW_H
-
-#include <string>
-#include "core/task.h"
-
-class CardView {
-public:
-    explicit CardView(Task& task);
-
-    // Draws the card, scaling size based on zoom factor
-    void draw(float zoom = 1.0f);
-
-private:
-    void drawFront(float zoom);
-    void drawBack(float zoom);
-
-    Task& task_;
-    bool is_flipped_ = false;
-};
-
+// card_view.h
+
+#ifndef CARD_VIEW_H
+#define CARD_VIEW_H
+
+#include <string>
+#include "core/task.h"
+#include "text_layout_cache.h"
+
+class CardView {
+public:
+    // textCache is optional; without it titles are wrapped by ImGui every frame
+    explicit CardView(Task& task, TextLayoutCache* textCache = nullptr);
+
+    // Draws the card, scaling size based on zoom factor. `movable` adds a drag
+    // handle. Returns true when the task was edited (and saved) this frame.
+    bool draw(float zoom = 1.0f, bool movable = false);
+
+    // Drag handle state from the last draw()
+    bool dragActive() const { return drag_active_; }
+    bool dropped() const { return dropped_; }
+
+    // Set by the canvas when the task's due date has passed
+    void setOverdue(bool overdue) { overdue_ = overdue; }
+
+    // Set by the canvas while a linked predecessor is still open
+    void setBlocked(bool blocked) { blocked_ = blocked; }
+
+    // Point the card at its task after the task list reallocated; the card
+    // keeps its side, link editors and unsaved notes
+    void rebind(Task& task) { task_ = &task; }
+
+private:
+    void drawFront(float zoom);
+    bool drawBack(float zoom);
+    void releaseNotes();
+    void loadLinkBuffers();
+
+    Task* task_;
+    TextLayoutCache* text_cache_;
+    bool is_flipped_ = false;
+    bool drag_active_ = false;
+    bool dropped_ = false;
+    bool notes_dirty_ = false;  // notes edited but not saved yet
+    bool overdue_ = false;
+    bool blocked_ = false;
+    std::string link_from_edit_;  // link editors on the back; empty unless flipped
+    std::string link_to_edit_;
+};
+
 #endif // CARD_VIEW_H
\ No newline at end of file
@@ -0,0 +1,115 @@
+#include "dashboard_view.h"
+#include "core/database_registry.h"
+#include "core/lookup_maps.h"
+#include "core/trace.h"
+#include <imgui.h>
+#include <algorithm>
+
+namespace {
+
+template <typename Map>
+std::string labelFromId(const Map& lookup, const std::string& key, const char* prefix) {
+    auto it = lookup.find(std::stoi(key));
+    return it != lookup.end() ? it->second : prefix + key;
+}
+
+std::string bucketLabel(AggregateDimension dimension, const std::string& key, const LookupSnapshot& lookups) {
+    if (key.empty()) return "(none)";
+
+    switch (dimension) {
+    case AggregateDimension::Category: return labelFromId(lookups.categories, key, "Category ");
+    case AggregateDimension::Context:  return labelFromId(lookups.contexts, key, "Context ");
+    case AggregateDimension::Topic:    return labelFromId(lookups.topics, key, "Topic ");
+    case AggregateDimension::Delegate: return labelFromId(lookups.people, key, "Person ");
+    case AggregateDimension::Project: {
+        auto it = lookups.projects.find(Uuid::fromText(key));
+        return it != lookups.projects.end() ? it->second.name : key;
+    }
+    case AggregateDimension::Database: {
+        size_t db_id = std::stoul(key);
+        return db_id < databaseNames.size() ? databaseNames[db_id] : "Database " + key;
+    }
+    }
+    return key;
+}
+
+} // namespace
+
+void DashboardView::rebuildRows(const TaskAggregates& aggregates) {
+    GTD_TRACE_SCOPE("DashboardView::rebuildRows");
+    LookupReadGuard lookups;
+
+    rows_.clear();
+    for (const AggregateBucket& bucket : aggregates.buckets(dimension_)) {
+        const AggregateTotals& t = bucket.totals;
+        if (!showEmpty_ && t.open == 0 && t.done == 0) continue;
+        rows_.push_back({ bucketLabel(dimension_, bucket.key, *lookups), t });
+    }
+
+    // Most open work first
+    std::sort(rows_.begin(), rows_.end(), [](const Row& a, const Row& b) {
+        if (a.totals.open != b.totals.open) return a.totals.open > b.totals.open;
+        return a.label < b.label;
+    });
+
+    builtGeneration_ = aggregates.generation();
+    builtLookupVersion_ = lookups->version;
+    builtDimension_ = dimension_;
+    builtShowEmpty_ = showEmpty_;
+}
+
+void DashboardView::render(const TaskAggregates& aggregates) {
+    const AggregateTotals& total = aggregates.total();
+    ImGui::Text("Open %lld   In focus %lld   Overdue %lld   Done %lld (%lld this week)",
+        static_cast<long long>(total.open), static_cast<long long>(total.inFocus),
+        static_cast<long long>(total.overdue), static_cast<long long>(total.done),
+        static_cast<long long>(total.doneThisWeek));
+    ImGui::Text("Estimated time left %.1f h", total.openMinutes / 60.0);
+
+    const char* dimensionItems[] = { "Category", "Context", "Project", "Topic", "Delegate", "Database" };
+    int dimensionIndex = static_cast<int>(dimension_);
+    if (ImGui::Combo("Group by", &dimensionIndex, dimensionItems, IM_ARRAYSIZE(dimensionItems))) {
+        dimension_ = static_cast<AggregateDimension>(dimensionIndex);
+    }
+    ImGui::SameLine();
+    ImGui::Checkbox("Show empty", &showEmpty_);
+
+    if (builtGeneration_ != aggregates.generation() || builtLookupVersion_ != lookupVersion() ||
+        builtDimension_ != dimension_ || builtShowEmpty_ != showEmpty_) {
+        rebuildRows(aggregates);
+    }
+
+    ImGuiTableFlags flags = ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV |
+        ImGuiTableFlags_ScrollY | ImGuiTableFlags_SizingStretchProp;
+    if (!ImGui::BeginTable("Aggregates", 7, flags)) return;
+
+    ImGui::TableSetupScrollFreeze(0, 1);
+    ImGui::TableSetupColumn(dimensionItems[dimensionIndex], ImGuiTableColumnFlags_WidthStretch, 3.0f);
+    for (const char* column : { "Open", "Focus", "Overdue", "Done", "This week", "Hours left" }) {
+        ImGui::TableSetupColumn(column);
+    }
+    ImGui::TableHeadersRow();
+
+    ImGuiListClipper clipper;
+    clipper.Begin(static_cast<int>(rows_.size()));
+    while (clipper.Step()) {
+        for (int r = clipper.DisplayStart; r < clipper.DisplayEnd; ++r) {
+            const Row& row = rows_[r];
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn(); ImGui::TextUnformatted(row.label.c_str());
+            ImGui::TableNextColumn(); ImGui::Text("%lld", static_cast<long long>(row.totals.open));
+            ImGui::TableNextColumn(); ImGui::Text("%lld", static_cast<long long>(row.totals.inFocus));
+            ImGui::TableNextColumn();
+            if (row.totals.overdue > 0) {
+                ImGui::TextColored(ImVec4(1.0f, 0.35f, 0.3f, 1.0f), "%lld", static_cast<long long>(row.totals.overdue));
+            }
+            else {
+                ImGui::TextDisabled("0");
+            }
+            ImGui::TableNextColumn(); ImGui::Text("%lld", static_cast<long long>(row.totals.done));
+            ImGui::TableNextColumn(); ImGui::Text("%lld", static_cast<long long>(row.totals.doneThisWeek));
+            ImGui::TableNextColumn(); ImGui::Text("%.1f", row.totals.openMinutes / 60.0);
+        }
+    }
+    ImGui::EndTable();
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "core/task_aggregates.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Totals per category, context, project, topic, delegate or database, read
+// from a TaskAggregates. Rows are labelled and sorted only when the aggregates
+// or the lookup data change; other frames just draw the cached rows.
+class DashboardView {
+public:
+    void render(const TaskAggregates& aggregates);
+
+private:
+    struct Row {
+        std::string label;
+        AggregateTotals totals;
+    };
+
+    void rebuildRows(const TaskAggregates& aggregates);
+
+    AggregateDimension dimension_ = AggregateDimension::Project;
+    bool showEmpty_ = false;
+    std::vector<Row> rows_;
+
+    // What rows_ was built from
+    uint64_t builtGeneration_ = UINT64_MAX;
+    uint64_t builtLookupVersion_ = UINT64_MAX;
+    AggregateDimension builtDimension_ = AggregateDimension::Project;
+    bool builtShowEmpty_ = false;
+};
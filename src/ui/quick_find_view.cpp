@@ -0,0 +1,71 @@
+#include "quick_find_view.h"
+#include "core/config.h"
+#include <imgui.h>
+#include <algorithm>
+#include <cfloat>
+
+void QuickFindView::open() {
+    open_ = true;
+    focusInput_ = true;
+    selected_ = 0;
+}
+
+size_t QuickFindView::render(const std::vector<Task>& tasks) {
+    if (!open_) return SIZE_MAX;
+
+    const ImGuiViewport* viewport = ImGui::GetMainViewport();
+    ImGui::SetNextWindowPos(ImVec2(viewport->WorkPos.x + viewport->WorkSize.x * 0.5f, viewport->WorkPos.y + 60.0f),
+        ImGuiCond_Always, ImVec2(0.5f, 0.0f));
+    ImGui::SetNextWindowSize(ImVec2(std::min(560.0f, viewport->WorkSize.x - 40.0f), 0.0f), ImGuiCond_Always);
+
+    ImGuiWindowFlags flags = ImGuiWindowFlags_NoTitleBar | ImGuiWindowFlags_NoSavedSettings |
+        ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoMove | ImGuiWindowFlags_AlwaysAutoResize;
+
+    size_t chosen = SIZE_MAX;
+    if (!ImGui::Begin("Quick Find", &open_, flags)) {
+        ImGui::End();
+        return SIZE_MAX;
+    }
+
+    if (focusInput_) {
+        ImGui::SetKeyboardFocusHere();
+        focusInput_ = false;
+    }
+    ImGui::SetNextItemWidth(-FLT_MIN);
+    if (ImGui::InputTextWithHint("##query", "Find task, project or context...", query_, sizeof(query_))) {
+        finder_.setQuery(query_);
+        selected_ = 0;
+    }
+    finder_.step(AppConfig::kQuickFindBudget);
+
+    const std::vector<QuickFindResult>& results = finder_.results();
+    const int count = static_cast<int>(results.size());
+    if (ImGui::IsKeyPressed(ImGuiKey_DownArrow)) selected_ = std::min(selected_ + 1, count - 1);
+    if (ImGui::IsKeyPressed(ImGuiKey_UpArrow))   selected_ = std::max(selected_ - 1, 0);
+    if (ImGui::IsKeyPressed(ImGuiKey_Escape))    open_ = false;
+    if (ImGui::IsKeyPressed(ImGuiKey_Enter) && selected_ < count) {
+        chosen = results[selected_].taskIndex;
+    }
+
+    for (int r = 0; r < count && chosen == SIZE_MAX; ++r) {
+        const Task& task = tasks[results[r].taskIndex];
+        ImGui::PushID(r);
+        if (ImGui::Selectable(task.title.c_str(), r == selected_)) {
+            chosen = results[r].taskIndex;
+        }
+        if (task.project_title || task.context_label) {
+            ImGui::SameLine();
+            ImGui::TextDisabled("%s%s%s", task.project_title.value_or("").c_str(),
+                task.project_title && task.context_label ? "  " : "", task.context_label.value_or("").c_str());
+        }
+        ImGui::PopID();
+    }
+
+    if (query_[0] != '\0') {
+        ImGui::TextDisabled("%zu matches%s", finder_.matchCount(), finder_.done() ? "" : " (searching...)");
+    }
+    ImGui::End();
+
+    if (chosen != SIZE_MAX) open_ = false;
+    return chosen;
+}
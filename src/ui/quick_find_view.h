@@ -0,0 +1,28 @@
+#pragma once
+
+#include "core/quick_find.h"
+#include "core/task.h"
+
+#include <cstddef>
+#include <vector>
+
+// Ctrl+P command palette over a QuickFind index. Each frame spends at most
+// AppConfig::kQuickFindBudget on the search and shows the best results so far.
+class QuickFindView {
+public:
+    void rebuild(const std::vector<Task>& tasks) { finder_.rebuild(tasks); }
+    void updateTask(size_t taskIndex, const Task& task) { finder_.updateTask(taskIndex, task); }
+
+    void open();
+    bool isOpen() const { return open_; }
+
+    // Returns the task index the user picked this frame, or SIZE_MAX
+    size_t render(const std::vector<Task>& tasks);
+
+private:
+    QuickFind finder_;
+    char query_[256] = {};
+    bool open_ = false;
+    bool focusInput_ = false;
+    int selected_ = 0;
+};
@@ -0,0 +1,132 @@
+#include "spatial_grid.h"
+
+#include <algorithm>
+#include <cmath>
+
+SpatialGrid::SpatialGrid(float cellSize) {
+    clear(cellSize);
+}
+
+void SpatialGrid::clear(float cellSize) {
+    cellSize_ = cellSize;
+    invCellSize_ = 1.0f / cellSize;
+    items_.clear();
+    cells_.clear();
+    count_ = 0;
+}
+
+void SpatialGrid::reserve(size_t items) {
+    items_.reserve(items);
+}
+
+int32_t SpatialGrid::cellCoord(float v) const {
+    return static_cast<int32_t>(std::floor(v * invCellSize_));
+}
+
+uint64_t SpatialGrid::cellKey(int32_t x, int32_t y) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+}
+
+void SpatialGrid::link(uint32_t id) {
+    Item& item = items_[id];
+    item.cellX = cellCoord(item.min.x);
+    item.cellY = cellCoord(item.min.y);
+    item.spanX = static_cast<uint8_t>(std::clamp(cellCoord(item.max.x) - item.cellX + 1, 1, 2));
+    item.spanY = static_cast<uint8_t>(std::clamp(cellCoord(item.max.y) - item.cellY + 1, 1, 2));
+
+    for (int dy = 0; dy < item.spanY; ++dy) {
+        for (int dx = 0; dx < item.spanX; ++dx) {
+            std::vector<uint32_t>& cell = cells_[cellKey(item.cellX + dx, item.cellY + dy)];
+            item.slots[dy * 2 + dx] = static_cast<uint32_t>(cell.size());
+            cell.push_back(id);
+        }
+    }
+}
+
+void SpatialGrid::unlink(uint32_t id) {
+    Item& item = items_[id];
+    for (int dy = 0; dy < item.spanY; ++dy) {
+        for (int dx = 0; dx < item.spanX; ++dx) {
+            const int32_t cx = item.cellX + dx;
+            const int32_t cy = item.cellY + dy;
+            auto it = cells_.find(cellKey(cx, cy));
+            std::vector<uint32_t>& cell = it->second;
+
+            // Swap-remove, then fix the slot of whichever item took our place
+            uint32_t slot = item.slots[dy * 2 + dx];
+            uint32_t moved = cell.back();
+            cell[slot] = moved;
+            cell.pop_back();
+            if (moved != id) {
+                Item& other = items_[moved];
+                other.slots[(cy - other.cellY) * 2 + (cx - other.cellX)] = slot;
+            }
+            if (cell.empty()) cells_.erase(it);
+        }
+    }
+    item.spanX = item.spanY = 0;
+}
+
+void SpatialGrid::insert(uint32_t id, const ImVec2& min, const ImVec2& max) {
+    if (id >= items_.size()) items_.resize(id + 1);
+    if (items_[id].spanX) {
+        move(id, min, max);
+        return;
+    }
+    items_[id].min = min;
+    items_[id].max = max;
+    link(id);
+    ++count_;
+}
+
+void SpatialGrid::move(uint32_t id, const ImVec2& min, const ImVec2& max) {
+    Item& item = items_[id];
+    const bool sameCells = cellCoord(min.x) == item.cellX && cellCoord(min.y) == item.cellY &&
+        cellCoord(max.x) == cellCoord(item.max.x) && cellCoord(max.y) == cellCoord(item.max.y);
+
+    if (!sameCells) unlink(id);
+    item.min = min;
+    item.max = max;
+    if (!sameCells) link(id);
+}
+
+void SpatialGrid::remove(uint32_t id) {
+    if (id >= items_.size() || !items_[id].spanX) return;
+    unlink(id);
+    --count_;
+}
+
+void SpatialGrid::query(const ImVec2& min, const ImVec2& max, std::vector<size_t>& out) const {
+    out.clear();
+    const int32_t x0 = cellCoord(min.x), x1 = cellCoord(max.x);
+    const int32_t y0 = cellCoord(min.y), y1 = cellCoord(max.y);
+
+    auto visit = [&](int32_t cx, int32_t cy, const std::vector<uint32_t>& cell) {
+        for (uint32_t id : cell) {
+            const Item& item = items_[id];
+            if (item.min.x >= max.x || item.max.x <= min.x || item.min.y >= max.y || item.max.y <= min.y) continue;
+            // An item in several cells is reported from the first one inside the query
+            if (cx == std::max(item.cellX, x0) && cy == std::max(item.cellY, y0)) {
+                out.push_back(id);
+            }
+        }
+    };
+
+    // Zoomed far out the query can cover more cells than are occupied
+    const double queryCells = (double(x1) - x0 + 1) * (double(y1) - y0 + 1);
+    if (queryCells > static_cast<double>(cells_.size())) {
+        for (const auto& [key, cell] : cells_) {
+            const int32_t cx = static_cast<int32_t>(key >> 32);
+            const int32_t cy = static_cast<int32_t>(key & 0xffffffffu);
+            if (cx >= x0 && cx <= x1 && cy >= y0 && cy <= y1) visit(cx, cy, cell);
+        }
+        return;
+    }
+
+    for (int32_t cy = y0; cy <= y1; ++cy) {
+        for (int32_t cx = x0; cx <= x1; ++cx) {
+            auto it = cells_.find(cellKey(cx, cy));
+            if (it != cells_.end()) visit(cx, cy, it->second);
+        }
+    }
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include <imgui.h>
+
+// Uniform-grid spatial index over axis-aligned rectangles.
+// Items may not be larger than one cell, so each one sits in at most 2x2 cells
+// and remembers its slot in each; moving an item is a constant number of
+// swap-removes and push_backs regardless of how many items there are.
+class SpatialGrid {
+public:
+    explicit SpatialGrid(float cellSize = 512.0f);
+
+    void clear(float cellSize);
+    void reserve(size_t items);
+
+    // Ids are small dense integers (e.g. positions in a card array)
+    void insert(uint32_t id, const ImVec2& min, const ImVec2& max);
+    void move(uint32_t id, const ImVec2& min, const ImVec2& max);
+    void remove(uint32_t id);
+
+    // Ids of items intersecting [min, max), each reported once, in no particular order
+    void query(const ImVec2& min, const ImVec2& max, std::vector<size_t>& out) const;
+
+    size_t size() const { return count_; }
+
+private:
+    struct Item {
+        ImVec2 min = ImVec2(0, 0);
+        ImVec2 max = ImVec2(0, 0);
+        int32_t cellX = 0;                  // first cell covered
+        int32_t cellY = 0;
+        uint8_t spanX = 0;                  // cells covered per axis (1 or 2); 0 = not present
+        uint8_t spanY = 0;
+        std::array<uint32_t, 4> slots{};    // index in each covered cell's list
+    };
+
+    int32_t cellCoord(float v) const;
+    static uint64_t cellKey(int32_t x, int32_t y);
+    void link(uint32_t id);
+    void unlink(uint32_t id);
+
+    float cellSize_;
+    float invCellSize_;
+    std::vector<Item> items_;
+    std::unordered_map<uint64_t, std::vector<uint32_t>> cells_;
+    size_t count_ = 0;
+};
@@ -0,0 +1,330 @@
+#include "task_order.h"
+#include "core/date_time.h"
+#include "core/lookup_maps.h"
+#include "core/trace.h"
+
+#include <algorithm>
+#include <future>
+#include <limits>
+#include <thread>
+
+namespace {
+
+constexpr uint64_t kMissing = std::numeric_limits<uint64_t>::max();
+
+// Below this many tasks a single std::sort beats spinning up threads
+constexpr size_t kParallelSortThreshold = 32768;
+
+std::string foldCase(std::string_view text) {
+    std::string folded(text);
+    for (char& c : folded) {
+        if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+    }
+    return folded;
+}
+
+// First 8 bytes of the folded string, big-endian, so integer order == byte order
+uint64_t prefixKey(const std::string& folded) {
+    uint64_t key = 0;
+    for (size_t i = 0; i < 8; ++i) {
+        key <<= 8;
+        if (i < folded.size()) key |= static_cast<uint8_t>(folded[i]);
+    }
+    return key;
+}
+
+uint64_t dateKey(const std::optional<TaskString>& text) {
+    if (!text) return kMissing;
+    auto seconds = parseDateTime(*text);
+    if (!seconds) return kMissing;
+    return static_cast<uint64_t>(*seconds) ^ (1ull << 63);  // signed -> unsigned order
+}
+
+const std::string& labelOf(const std::string& label) { return label; }
+const std::string& labelOf(const LookupProject& project) { return project.name; }
+
+template <typename Id, typename Value>
+std::unordered_map<Id, uint32_t> rankByLabel(const std::map<Id, Value>& lookup) {
+    std::vector<std::pair<std::string, Id>> labels;
+    labels.reserve(lookup.size());
+    for (const auto& [id, value] : lookup) labels.emplace_back(foldCase(labelOf(value)), id);
+    std::sort(labels.begin(), labels.end());
+
+    std::unordered_map<Id, uint32_t> ranks;
+    for (size_t i = 0; i < labels.size(); ++i) ranks[labels[i].second] = static_cast<uint32_t>(i);
+    return ranks;
+}
+
+} // namespace
+
+void TaskOrdering::configure(SortField sort, GroupField group, bool descending) {
+    sort_ = sort;
+    group_ = group;
+    descending_ = descending;
+}
+
+std::string TaskOrdering::groupLabel(const Task& t, const LookupSnapshot& lookups) const {
+    switch (group_) {
+    case GroupField::Project: {
+        if (!t.project_uuid) return {};
+        auto it = lookups.projects.find(t.project_id);
+        if (it != lookups.projects.end()) return it->second.name;
+        return std::string(t.project_title ? *t.project_title : *t.project_uuid);
+    }
+    case GroupField::Context: {
+        if (!t.context_id) return {};
+        auto it = lookups.contexts.find(*t.context_id);
+        if (it != lookups.contexts.end()) return it->second;
+        return t.context_label ? std::string(*t.context_label) : "Context " + std::to_string(*t.context_id);
+    }
+    case GroupField::Category: {
+        if (!t.category_id) return {};
+        auto it = lookups.categories.find(*t.category_id);
+        if (it != lookups.categories.end()) return it->second;
+        return t.category_label ? std::string(*t.category_label) : "Category " + std::to_string(*t.category_id);
+    }
+    case GroupField::Status:
+        return t.is_done ? "Done" : t.in_focus ? "In focus" : "Open";
+    case GroupField::None:
+        break;
+    }
+    return {};
+}
+
+TaskOrdering::Key TaskOrdering::makeKey(const Task& t, const LookupSnapshot& lookups) const {
+    Key key;
+
+    if (group_ != GroupField::None) {
+        auto it = groupRanks_.find(groupLabel(t, lookups));
+        key.group = it != groupRanks_.end() ? it->second : kMissing;
+    }
+
+    switch (sort_) {
+    case SortField::Manual:    key.primary = 0; break;
+    case SortField::DueDate:   key.primary = dateKey(t.due_date); break;
+    case SortField::DeferDate: key.primary = dateKey(t.defer_date); break;
+    case SortField::CreatedAt: key.primary = dateKey(t.created_at); break;
+    case SortField::Title:     key.primary = 0; break;
+    case SortField::Project: {
+        auto it = t.project_uuid ? projectRanks_.find(t.project_id) : projectRanks_.end();
+        key.primary = it != projectRanks_.end() ? it->second : kMissing;
+        break;
+    }
+    case SortField::Context: {
+        auto it = t.context_id ? contextRanks_.find(*t.context_id) : contextRanks_.end();
+        key.primary = it != contextRanks_.end() ? it->second : kMissing;
+        break;
+    }
+    }
+
+    // Tasks without a value stay at the end in either direction
+    if (descending_ && key.primary != kMissing) key.primary = ~key.primary - 1;
+
+    key.titlePrefix = prefixKey(foldCase(t.title));
+    if (descending_ && sort_ == SortField::Title) key.titlePrefix = ~key.titlePrefix;
+    return key;
+}
+
+bool TaskOrdering::less(size_t a, size_t b) const {
+    const Key& ka = keys_[a];
+    const Key& kb = keys_[b];
+    if (ka.group != kb.group) return ka.group < kb.group;
+    if (ka.primary != kb.primary) return ka.primary < kb.primary;
+
+    // Only title sort orders by title; otherwise keep load order within equal keys
+    if (sort_ == SortField::Title) {
+        if (ka.titlePrefix != kb.titlePrefix) return ka.titlePrefix < kb.titlePrefix;
+        int cmp = collation_[a].compare(collation_[b]);
+        if (cmp != 0) return descending_ ? cmp > 0 : cmp < 0;
+    }
+    return a < b;
+}
+
+void TaskOrdering::buildLabelRanks(const std::vector<Task>& tasks, const std::vector<size_t>& subset,
+                                   const LookupSnapshot& lookups) {
+    groupLabels_.clear();
+    groupRanks_.clear();
+    projectRanks_.clear();
+    contextRanks_.clear();
+
+    if (sort_ == SortField::Project) projectRanks_ = rankByLabel(lookups.projects);
+    if (sort_ == SortField::Context) contextRanks_ = rankByLabel(lookups.contexts);
+
+    if (group_ == GroupField::None) return;
+
+    // Status lanes follow the workflow rather than the alphabet
+    if (group_ == GroupField::Status) {
+        for (const char* label : { "Open", "In focus", "Done" }) {
+            groupRanks_[label] = static_cast<uint32_t>(groupLabels_.size());
+            groupLabels_.push_back(label);
+        }
+        return;
+    }
+
+    // Named groups alphabetically, the "no value" group last
+    std::vector<std::pair<std::string, std::string>> labels;   // (folded, label)
+    bool hasUnassigned = false;
+    for (size_t i : subset) {
+        std::string label = groupLabel(tasks[i], lookups);
+        if (label.empty()) {
+            hasUnassigned = true;
+        }
+        else if (groupRanks_.emplace(label, 0).second) {
+            labels.emplace_back(foldCase(label), std::move(label));
+        }
+    }
+    std::sort(labels.begin(), labels.end());
+
+    for (auto& [folded, label] : labels) {
+        groupRanks_[label] = static_cast<uint32_t>(groupLabels_.size());
+        groupLabels_.push_back(std::move(label));
+    }
+    if (hasUnassigned) {
+        groupRanks_[std::string()] = static_cast<uint32_t>(groupLabels_.size());
+        groupLabels_.push_back(group_ == GroupField::Project ? "No project"
+            : group_ == GroupField::Context ? "No context" : "No category");
+    }
+}
+
+void TaskOrdering::sortOrder() {
+    auto cmp = [this](size_t a, size_t b) { return less(a, b); };
+
+    unsigned workers = std::max(1u, std::thread::hardware_concurrency());
+    if (order_.size() < kParallelSortThreshold || workers == 1) {
+        std::sort(order_.begin(), order_.end(), cmp);
+        return;
+    }
+
+    // Sort equal chunks on worker threads, then merge neighbours pairwise
+    size_t chunk = (order_.size() + workers - 1) / workers;
+    std::vector<size_t> bounds;
+    for (size_t b = 0; b < order_.size(); b += chunk) bounds.push_back(b);
+    bounds.push_back(order_.size());
+
+    std::vector<std::future<void>> jobs;
+    for (size_t c = 0; c + 1 < bounds.size(); ++c) {
+        jobs.push_back(std::async(std::launch::async, [this, &cmp, &bounds, c] {
+            std::sort(order_.begin() + bounds[c], order_.begin() + bounds[c + 1], cmp);
+        }));
+    }
+    for (auto& job : jobs) job.get();
+
+    while (bounds.size() > 2) {
+        std::vector<size_t> merged;
+        jobs.clear();
+        for (size_t c = 0; c + 2 < bounds.size(); c += 2) {
+            jobs.push_back(std::async(std::launch::async, [this, &cmp, &bounds, c] {
+                std::inplace_merge(order_.begin() + bounds[c], order_.begin() + bounds[c + 1],
+                    order_.begin() + bounds[c + 2], cmp);
+            }));
+            merged.push_back(bounds[c]);
+        }
+        for (auto& job : jobs) job.get();
+
+        if (bounds.size() % 2 == 0) merged.push_back(bounds[bounds.size() - 2]);   // odd chunk out
+        merged.push_back(bounds.back());
+        bounds = std::move(merged);
+    }
+}
+
+void TaskOrdering::rebuild(const std::vector<Task>& tasks, const std::vector<size_t>& subset) {
+    GTD_TRACE_SCOPE("TaskOrdering::rebuild");
+    LookupReadGuard lookups;
+    lookupVersion_ = lookups->version;
+    buildLabelRanks(tasks, subset, *lookups);
+
+    keys_.assign(tasks.size(), Key{});
+    inSubset_.assign(tasks.size(), 0);
+    collation_.clear();
+    if (sort_ == SortField::Title) collation_.resize(tasks.size());
+
+    for (size_t i : subset) {
+        keys_[i] = makeKey(tasks[i], *lookups);
+        inSubset_[i] = 1;
+        if (sort_ == SortField::Title) collation_[i] = foldCase(tasks[i].title);
+    }
+
+    order_ = subset;
+    sortOrder();
+    rebuildGroupRanges();
+    ++generation_;
+}
+
+bool TaskOrdering::update(const std::vector<Task>& tasks, size_t taskIndex) {
+    if (taskIndex >= inSubset_.size() || !inSubset_[taskIndex]) return false;
+
+    // A label we have not ranked yet (new project, renamed context...) or newer
+    // lookup data needs a full rebuild
+    LookupReadGuard lookups;
+    if (lookups->version != lookupVersion_ ||
+        (group_ != GroupField::None && !groupRanks_.count(groupLabel(tasks[taskIndex], *lookups)))) {
+        rebuild(tasks, std::vector<size_t>(order_));
+        return true;
+    }
+
+    auto cmp = [this](size_t a, size_t b) { return less(a, b); };
+
+    // The old key still locates the task exactly: the comparator is a total order
+    auto pos = std::lower_bound(order_.begin(), order_.end(), taskIndex, cmp);
+    order_.erase(pos);
+
+    keys_[taskIndex] = makeKey(tasks[taskIndex], *lookups);
+    if (sort_ == SortField::Title) collation_[taskIndex] = foldCase(tasks[taskIndex].title);
+
+    order_.insert(std::upper_bound(order_.begin(), order_.end(), taskIndex, cmp), taskIndex);
+    rebuildGroupRanges();
+    ++generation_;
+    return true;
+}
+
+bool TaskOrdering::insert(const std::vector<Task>& tasks, size_t taskIndex) {
+    if (taskIndex < inSubset_.size() && inSubset_[taskIndex]) return false;
+
+    LookupReadGuard lookups;
+    if (taskIndex >= keys_.size() || lookups->version != lookupVersion_ ||
+        (group_ != GroupField::None && !groupRanks_.count(groupLabel(tasks[taskIndex], *lookups)))) {
+        std::vector<size_t> subset(order_);
+        subset.push_back(taskIndex);
+        rebuild(tasks, subset);
+        return true;
+    }
+
+    keys_[taskIndex] = makeKey(tasks[taskIndex], *lookups);
+    if (sort_ == SortField::Title) collation_[taskIndex] = foldCase(tasks[taskIndex].title);
+    inSubset_[taskIndex] = 1;
+
+    auto cmp = [this](size_t a, size_t b) { return less(a, b); };
+    order_.insert(std::upper_bound(order_.begin(), order_.end(), taskIndex, cmp), taskIndex);
+    rebuildGroupRanges();
+    ++generation_;
+    return true;
+}
+
+bool TaskOrdering::remove(size_t taskIndex) {
+    if (taskIndex >= inSubset_.size() || !inSubset_[taskIndex]) return false;
+
+    auto cmp = [this](size_t a, size_t b) { return less(a, b); };
+    order_.erase(std::lower_bound(order_.begin(), order_.end(), taskIndex, cmp));
+    inSubset_[taskIndex] = 0;
+    rebuildGroupRanges();
+    ++generation_;
+    return true;
+}
+
+void TaskOrdering::rebuildGroupRanges() {
+    groups_.clear();
+    if (group_ == GroupField::None) {
+        if (!order_.empty()) groups_.push_back({ std::string(), 0, order_.size() });
+        return;
+    }
+
+    // Group rank is the most significant key, so each group is one contiguous run
+    auto byGroup = [this](size_t a, uint64_t rank) { return keys_[a].group < rank; };
+    for (size_t rank = 0; rank < groupLabels_.size(); ++rank) {
+        auto first = std::lower_bound(order_.begin(), order_.end(), rank, byGroup);
+        auto last = std::lower_bound(first, order_.end(), rank + 1, byGroup);
+        if (first != last) {
+            groups_.push_back({ groupLabels_[rank], size_t(first - order_.begin()), size_t(last - order_.begin()) });
+        }
+    }
+}
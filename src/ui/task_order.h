@@ -0,0 +1,103 @@
+#pragma once
+
+#include "core/task.h"
+#include "core/lookup_maps.h"
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+enum class SortField {
+    Manual,     // database load order
+    DueDate,
+    DeferDate,
+    CreatedAt,
+    Title,
+    Project,
+    Context,
+};
+
+enum class GroupField {
+    None,
+    Project,
+    Context,
+    Category,
+    Status,     // Open / In focus / Done, in that order
+};
+
+// A contiguous run of order() sharing one group label
+struct TaskGroup {
+    std::string label;
+    size_t begin = 0;
+    size_t end = 0;
+};
+
+// Display order for a subset of a task list.
+// Every task gets a compact key (group rank, packed date or label rank, title
+// prefix) when the ordering is rebuilt, so comparisons never touch strings except
+// to break ties between titles with the same 8-byte prefix. The renderer reads
+// order() and groups() as-is; nothing is sorted per frame.
+class TaskOrdering {
+public:
+    void configure(SortField sort, GroupField group, bool descending);
+
+    // Full rebuild over tasks[i] for every i in subset
+    void rebuild(const std::vector<Task>& tasks, const std::vector<size_t>& subset);
+
+    // Re-key one task after an edit and move it to its new position.
+    // Returns false if the task is not part of the current subset.
+    bool update(const std::vector<Task>& tasks, size_t taskIndex);
+
+    // Add or drop one task without re-sorting the rest (a task whose defer
+    // date passed, a task that stopped matching the filter). Both return false
+    // if the task was already in / not in the current subset.
+    bool insert(const std::vector<Task>& tasks, size_t taskIndex);
+    bool remove(size_t taskIndex);
+
+    const std::vector<size_t>& order() const { return order_; }
+    const std::vector<TaskGroup>& groups() const { return groups_; }
+
+    SortField sortField() const { return sort_; }
+    GroupField groupField() const { return group_; }
+    bool descending() const { return descending_; }
+
+    // Bumped whenever order() or groups() change
+    uint64_t generation() const { return generation_; }
+
+    // Lookup snapshot version the label ranks were built from
+    uint64_t lookupVersion() const { return lookupVersion_; }
+
+private:
+    struct Key {
+        uint64_t group = 0;
+        uint64_t primary = 0;
+        uint64_t titlePrefix = 0;
+    };
+
+    Key makeKey(const Task& t, const LookupSnapshot& lookups) const;
+    bool less(size_t a, size_t b) const;
+    std::string groupLabel(const Task& t, const LookupSnapshot& lookups) const;
+    void buildLabelRanks(const std::vector<Task>& tasks, const std::vector<size_t>& subset,
+                         const LookupSnapshot& lookups);
+    void rebuildGroupRanges();
+    void sortOrder();
+
+    SortField  sort_ = SortField::Manual;
+    GroupField group_ = GroupField::None;
+    bool descending_ = false;
+
+    std::vector<Key> keys_;                 // indexed by task index
+    std::vector<std::string> collation_;    // folded titles, only for SortField::Title
+    std::vector<uint8_t> inSubset_;         // indexed by task index
+    std::vector<size_t> order_;
+    std::vector<TaskGroup> groups_;
+
+    std::vector<std::string> groupLabels_;                       // by group rank
+    std::unordered_map<std::string, uint32_t> groupRanks_;
+    std::unordered_map<Uuid, uint32_t> projectRanks_;            // project id -> title rank
+    std::unordered_map<int, uint32_t> contextRanks_;             // context id -> label rank
+
+    uint64_t generation_ = 0;
+    uint64_t lookupVersion_ = 0;
+};
@@ -0,0 +1,87 @@
+#include "text_layout_cache.h"
+
+#include <imgui_internal.h>
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+float TextLayoutCache::quantizeZoom(float zoom) {
+    return std::max(1.0f, std::floor(zoom * 16.0f)) / 16.0f;
+}
+
+const WrappedText& TextLayoutCache::title(const Task& task, ImFont* font, float fontSize, float wrapWidth) {
+    auto [it, inserted] = entries_.try_emplace(&task);
+    Entry& entry = it->second;
+
+    if (!inserted && entry.revision == task.revision && entry.font == font &&
+        entry.fontSize == fontSize && entry.wrapWidth == wrapWidth) {
+        ++hits_;
+        return entry.text;
+    }
+
+    ++misses_;
+    entry.revision = task.revision;
+    entry.font = font;
+    entry.fontSize = fontSize;
+    entry.wrapWidth = wrapWidth;
+    wrap(task.title, font, fontSize, wrapWidth, entry.text);
+    return entry.text;
+}
+
+void TextLayoutCache::wrap(std::string_view text, ImFont* font, float fontSize, float wrapWidth, WrappedText& out) {
+    out.lines.clear();
+    out.size = ImVec2(0, 0);
+
+    const char* begin = text.data();
+    const char* end = begin + text.size();
+    const char* s = begin;
+
+    // Same breaking rules as ImFont::RenderText: each '\n'-terminated line is
+    // wrapped on its own (CalcWordWrapPosition does not stop at newlines), at
+    // word boundaries, skipping blanks after a wrap
+    while (s < end) {
+        const char* newline = static_cast<const char*>(std::memchr(s, '\n', end - s));
+        const char* lineEnd = newline ? newline : end;
+        const char* eol = s;
+        if (s < lineEnd) {
+            eol = font->CalcWordWrapPosition(fontSize, s, lineEnd, wrapWidth);
+            if (eol == s) {
+                // A glyph wider than the card: emit that one character anyway
+                unsigned int c;
+                eol += ImTextCharFromUtf8(&c, s, lineEnd);
+            }
+        }
+
+        float width = eol > s ? font->CalcTextSizeA(fontSize, FLT_MAX, 0.0f, s, eol).x : 0.0f;
+        out.lines.push_back({ static_cast<uint32_t>(s - begin), static_cast<uint32_t>(eol - begin) });
+        out.size.x = std::max(out.size.x, width);
+
+        s = eol;
+        while (s < end && (*s == ' ' || *s == '\t')) ++s;
+        if (s < end && *s == '\n') ++s;
+    }
+
+    out.size.y = std::max<size_t>(out.lines.size(), 1) * fontSize;
+}
+
+void TextLayoutCache::draw(std::string_view text, const WrappedText& wrapped, ImFont* font, float fontSize) {
+    ImDrawList* drawList = ImGui::GetWindowDrawList();
+    const ImVec2 pos = ImGui::GetCursorScreenPos();
+    const ImU32 color = ImGui::GetColorU32(ImGuiCol_Text);
+    const char* base = text.data();
+
+    float y = pos.y;
+    for (const TextLine& line : wrapped.lines) {
+        if (line.end > line.begin) {
+            drawList->AddText(font, fontSize, ImVec2(pos.x, y), color, base + line.begin, base + line.end);
+        }
+        y += fontSize;
+    }
+
+    ImGui::Dummy(wrapped.size);
+}
+
+void TextLayoutCache::clear() {
+    entries_.clear();
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "core/task.h"
+
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <imgui.h>
+
+// Byte range of one wrapped line in the source string
+struct TextLine {
+    uint32_t begin = 0;
+    uint32_t end = 0;
+};
+
+struct WrappedText {
+    std::vector<TextLine> lines;
+    ImVec2 size = ImVec2(0, 0);
+};
+
+// Wrapped line breaks and measured sizes of card titles.
+// An entry is reused while the task's revision, the font, the font size and the
+// wrap width all match, so a steady frame does no glyph measuring at all.
+// Callers quantize font size and wrap width (see quantizeZoom) to keep zooming
+// from invalidating every entry on every frame.
+class TextLayoutCache {
+public:
+    const WrappedText& title(const Task& task, ImFont* font, float fontSize, float wrapWidth);
+
+    // Draws a cached layout at the cursor and advances it like ImGui::TextWrapped
+    static void draw(std::string_view text, const WrappedText& wrapped, ImFont* font, float fontSize);
+
+    void clear();
+    size_t size() const { return entries_.size(); }
+    uint64_t hits() const { return hits_; }
+    uint64_t misses() const { return misses_; }
+
+    // Rounds zoom down to a 1/16 step so nearby zoom levels share a layout
+    static float quantizeZoom(float zoom);
+
+private:
+    struct Entry {
+        uint32_t revision = 0;
+        ImFont*  font = nullptr;
+        float    fontSize = 0.0f;
+        float    wrapWidth = 0.0f;
+        WrappedText text;
+    };
+
+    static void wrap(std::string_view text, ImFont* font, float fontSize, float wrapWidth, WrappedText& out);
+
+    std::unordered_map<const Task*, Entry> entries_;
+    uint64_t hits_ = 0;
+    uint64_t misses_ = 0;
+};